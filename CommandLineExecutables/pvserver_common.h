@@ -17,8 +17,11 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkNetworkAccessManager.h"
 #include "vtkPVServerOptions.h"
 #include "vtkProcessModule.h"
+#include "vtkPVSessionCore.h"
 #include "vtkPVSessionServer.h"
 
+#include <vtkstd/algorithm>
+
 static bool RealMain(int argc, char* argv[],
   vtkProcessModule::ProcessTypes type)
 {
@@ -53,8 +56,26 @@ static bool RealMain(int argc, char* argv[],
     pm->RegisterSession(session);
     if (controller->GetLocalProcessId() == 0)
       {
-      while (pm->GetNetworkAccessManager()->ProcessEvents(0) != -1)
+      vtkPVSessionCore* core = session->GetSessionCore();
+      while (true)
         {
+        // Wake up in time to forward the messages batched for the satellites
+        // if the client goes quiet.
+        unsigned long timeout = 0;
+        if (core->HasPendingMessages())
+          {
+          timeout = static_cast<unsigned long>(
+            vtkstd::max(core->GetMaxBatchLatency(), 1));
+          }
+        int result = pm->GetNetworkAccessManager()->ProcessEvents(timeout);
+        if (result == -1)
+          {
+          break;
+          }
+        if (result == 0)
+          {
+          core->FlushPendingMessages();
+          }
         }
       }
     else
@@ -48,8 +48,10 @@
 #include "vtkPVFileInformation.h"
 #include "vtkPVFileInformationHelper.h"
 #include "vtkPVGenericAttributeInformation.h"
+#include "vtkPVImageBrickCache.h"
 #include "vtkPVImplicitPlaneRepresentation.h"
 #include "vtkPVInformation.h"
+#include "vtkPVLODHierarchy.h"
 #include "vtkPVLastSelectionInformation.h"
 #include "vtkPVLineChartView.h"
 #include "vtkPVOpenGLExtensionsInformation.h"
@@ -161,8 +163,10 @@ int main(int, char**)
   PRINT_SELF(vtkPVFileInformation);
   PRINT_SELF(vtkPVFileInformationHelper);
   PRINT_SELF(vtkPVGenericAttributeInformation);
+  PRINT_SELF(vtkPVImageBrickCache);
   PRINT_SELF(vtkPVImplicitPlaneRepresentation);
   PRINT_SELF(vtkPVInformation);
+  PRINT_SELF(vtkPVLODHierarchy);
   PRINT_SELF(vtkPVLastSelectionInformation);
   //PRINT_SELF(vtkPVLineChartView);
   PRINT_SELF(vtkPVOpenGLExtensionsInformation);
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestImageSliceStreamedExtent.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the extent of the slab vtkImageSliceRepresentation requests around
+// the slice: clamped to the piece, kept while the slice stays within it and
+// empty when the slice does not cross the piece.
+
+#include "vtkImageSliceRepresentation.h"
+#include "vtkObjectFactory.h"
+
+// Gives access to ComputeStreamedExtent() without a pipeline.
+class vtkTestImageSliceRepresentation : public vtkImageSliceRepresentation
+{
+public:
+  static vtkTestImageSliceRepresentation* New();
+  vtkTypeMacro(vtkTestImageSliceRepresentation, vtkImageSliceRepresentation);
+
+  void Compute(const int pieceExtent[6], int extent[6])
+    {
+    int wholeExtent[6] = { 0, 99, 0, 99, 0, 99 };
+    this->ComputeStreamedExtent(wholeExtent, pieceExtent, extent);
+    }
+};
+vtkStandardNewMacro(vtkTestImageSliceRepresentation);
+
+//----------------------------------------------------------------------------
+static bool CheckExtent(const int extent[6], int x0, int x1, int y0, int y1,
+  int z0, int z1)
+{
+  return extent[0] == x0 && extent[1] == x1 && extent[2] == y0 &&
+    extent[3] == y1 && extent[4] == z0 && extent[5] == z1;
+}
+
+//----------------------------------------------------------------------------
+static int TestStreamedExtent(vtkTestImageSliceRepresentation* repr)
+{
+  // The lower half of the image along Z.
+  int lower[6] = { 0, 99, 0, 99, 0, 49 };
+  int upper[6] = { 0, 99, 0, 99, 50, 99 };
+  int extent[6];
+
+  repr->SetSliceMode(vtkImageSliceRepresentation::XY_PLANE);
+  repr->SetNumberOfPrefetchedSlices(2);
+  repr->SetSlice(10);
+  repr->Compute(lower, extent);
+  if (!CheckExtent(extent, 0, 99, 0, 99, 8, 12))
+    {
+    cerr << "ERROR: wrong slab around the slice" << endl;
+    return 1;
+    }
+  repr->SetSlice(11);
+  repr->Compute(lower, extent);
+  if (!CheckExtent(extent, 0, 99, 0, 99, 8, 12))
+    {
+    cerr << "ERROR: the slab must be kept while the slice is within it"
+      << endl;
+    return 1;
+    }
+  repr->SetSlice(13);
+  repr->Compute(lower, extent);
+  if (!CheckExtent(extent, 0, 99, 0, 99, 11, 15))
+    {
+    cerr << "ERROR: a new slab must be centered on the slice" << endl;
+    return 1;
+    }
+  repr->SetSlice(1);
+  repr->Compute(lower, extent);
+  if (!CheckExtent(extent, 0, 99, 0, 99, 0, 3))
+    {
+    cerr << "ERROR: the slab must be clamped to the piece" << endl;
+    return 1;
+    }
+
+  // A slice outside of the piece, then beyond the whole extent (clamped to
+  // the last slice).
+  repr->SetSlice(70);
+  repr->Compute(lower, extent);
+  if (!CheckExtent(extent, 0, -1, 0, -1, 0, -1))
+    {
+    cerr << "ERROR: a piece not crossed by the slice must request an empty "
+      "extent" << endl;
+    return 1;
+    }
+  repr->SetSlice(500);
+  repr->Compute(upper, extent);
+  if (!CheckExtent(extent, 0, 99, 0, 99, 97, 99))
+    {
+    cerr << "ERROR: the slice must be clamped to the whole extent" << endl;
+    return 1;
+    }
+
+  // Another axis: the slab of the previous one must not be reused.
+  repr->SetSliceMode(vtkImageSliceRepresentation::YZ_PLANE);
+  repr->SetSlice(98);
+  repr->Compute(upper, extent);
+  if (!CheckExtent(extent, 96, 99, 0, 99, 50, 99))
+    {
+    cerr << "ERROR: wrong slab after changing the slice mode" << endl;
+    return 1;
+    }
+  repr->SetNumberOfPrefetchedSlices(0);
+  repr->Compute(upper, extent);
+  if (!CheckExtent(extent, 98, 98, 0, 99, 50, 99))
+    {
+    cerr << "ERROR: the slab must be computed again for a new number of slices"
+      << endl;
+    return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  vtkTestImageSliceRepresentation* repr =
+    vtkTestImageSliceRepresentation::New();
+  int result = TestStreamedExtent(repr);
+  repr->Delete();
+  return result;
+}
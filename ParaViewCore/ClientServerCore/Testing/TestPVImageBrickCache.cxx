@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVImageBrickCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the splitting into bricks, the streaming and the least recently used
+// eviction of vtkPVImageBrickCache.
+
+#include "vtkImageData.h"
+#include "vtkPVImageBrickCache.h"
+#include "vtkRTAnalyticSource.h"
+
+//----------------------------------------------------------------------------
+static bool CheckExtent(const int extent[6], int i0, int j0, int k0)
+{
+  return extent[0] == i0 && extent[1] == i0 + 10 &&
+    extent[2] == j0 && extent[3] == j0 + 10 &&
+    extent[4] == k0 && extent[5] == k0 + 10;
+}
+
+//----------------------------------------------------------------------------
+static int TestBrickCache(vtkPVImageBrickCache* cache)
+{
+  // 21 points per axis, in bricks of 11 points sharing their last layer.
+  cache->SetExtent(0, 20, 0, 20, 0, 20);
+  cache->SetBrickSize(11);
+  cache->Initialize();
+  if (cache->GetNumberOfBricks() != 8)
+    {
+    cerr << "ERROR: wrong number of bricks" << endl;
+    return 1;
+    }
+  int extent[6];
+  cache->GetBrickExtent(0, extent);
+  if (!CheckExtent(extent, 0, 0, 0))
+    {
+    cerr << "ERROR: wrong extent for the first brick" << endl;
+    return 1;
+    }
+  cache->GetBrickExtent(1, extent);
+  if (!CheckExtent(extent, 10, 0, 0))
+    {
+    cerr << "ERROR: bricks must vary along X first and share a layer of points"
+      << endl;
+    return 1;
+    }
+  cache->GetBrickExtent(7, extent);
+  if (!CheckExtent(extent, 10, 10, 10))
+    {
+    cerr << "ERROR: wrong extent for the last brick" << endl;
+    return 1;
+    }
+
+  // Only the extent of the brick is streamed.
+  double range[2];
+  if (cache->IsBrickLoaded(0) || cache->GetBrickRange(0, range))
+    {
+    cerr << "ERROR: nothing must be loaded before the first request" << endl;
+    return 1;
+    }
+  vtkImageData* brick = cache->GetBrick(0);
+  if (!brick || !CheckExtent(brick->GetExtent(), 0, 0, 0))
+    {
+    cerr << "ERROR: the brick does not have the extent requested" << endl;
+    return 1;
+    }
+  if (cache->GetNumberOfLoads() != 1 || !cache->GetBrickRange(0, range))
+    {
+    cerr << "ERROR: the brick and its range must be known once loaded" << endl;
+    return 1;
+    }
+  cache->GetBrick(0);
+  if (cache->GetNumberOfLoads() != 1)
+    {
+    cerr << "ERROR: a loaded brick must not be loaded again" << endl;
+    return 1;
+    }
+
+  // Room for two bricks: loading a third releases the least recently used.
+  cache->SetMaximumCacheSize(2 * cache->GetCacheSize());
+  cache->GetBrick(1);
+  cache->GetBrick(2);
+  if (cache->IsBrickLoaded(0) || !cache->IsBrickLoaded(1) ||
+    !cache->IsBrickLoaded(2))
+    {
+    cerr << "ERROR: the least recently used brick must be released first"
+      << endl;
+    return 1;
+    }
+  if (!cache->GetBrickRange(0, range))
+    {
+    cerr << "ERROR: the range must be kept once the brick is released" << endl;
+    return 1;
+    }
+  cache->GetBrick(1);
+  cache->GetBrick(3);
+  if (!cache->IsBrickLoaded(1) || cache->IsBrickLoaded(2) ||
+    !cache->IsBrickLoaded(3))
+    {
+    cerr << "ERROR: a brick used again must be kept" << endl;
+    return 1;
+    }
+  if (cache->GetCacheSize() > cache->GetMaximumCacheSize() ||
+    cache->GetNumberOfLoads() != 4)
+    {
+    cerr << "ERROR: wrong cache accounting" << endl;
+    return 1;
+    }
+
+  // Even without room, the brick requested is returned.
+  cache->SetMaximumCacheSize(0);
+  if (!cache->GetBrick(4) || !cache->IsBrickLoaded(4) ||
+    cache->IsBrickLoaded(1) || cache->IsBrickLoaded(3))
+    {
+    cerr << "ERROR: all bricks but the one requested must be released" << endl;
+    return 1;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  vtkRTAnalyticSource* source = vtkRTAnalyticSource::New();
+  source->SetWholeExtent(0, 20, 0, 20, 0, 20);
+
+  vtkPVImageBrickCache* cache = vtkPVImageBrickCache::New();
+  cache->SetInputConnection(source->GetOutputPort());
+  int result = TestBrickCache(cache);
+  cache->Delete();
+  source->Delete();
+  return result;
+}
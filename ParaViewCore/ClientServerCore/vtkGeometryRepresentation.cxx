@@ -30,10 +30,10 @@
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVGeometryFilter.h"
 #include "vtkPVLODActor.h"
+#include "vtkPVLODHierarchy.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
-#include "vtkQuadricClustering.h"
 #include "vtkRenderer.h"
 #include "vtkSelectionConverter.h"
 #include "vtkSelection.h"
@@ -92,7 +92,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->GeometryFilter = vtkPVGeometryFilter::New();
   this->CacheKeeper = vtkPVCacheKeeper::New();
   this->MultiBlockMaker = vtkGeometryRepresentationMultiBlockMaker::New();
-  this->Decimator = vtkQuadricClustering::New();
+  this->Decimator = vtkPVLODHierarchy::New();
   this->Mapper = vtkCompositePolyDataMapper2::New();
   this->LODMapper = vtkCompositePolyDataMapper2::New();
   this->Actor = vtkPVLODActor::New();
@@ -140,10 +140,7 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetupDefaults()
 {
-  this->Decimator->SetUseInputPoints(1);
-  this->Decimator->SetCopyCellData(1);
-  this->Decimator->SetUseInternalTriangles(0);
-  this->Decimator->SetNumberOfDivisions(10, 10, 10);
+  this->Decimator->SetNumberOfDivisions(10);
   this->LODDeliveryFilter->SetLODMode(true); // tell the filter that it is
                                              // connected to the LOD pipeline.
 
@@ -220,8 +217,17 @@ int vtkGeometryRepresentation::ProcessViewRequest(
         {
         int division = static_cast<int>(150 *
           inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-        this->Decimator->SetNumberOfDivisions(division, division, division);
+        this->Decimator->SetNumberOfDivisions(division);
         }
+      if (inInfo->Has(vtkPVRenderView::LOD_NUMBER_OF_LEVELS()))
+        {
+        this->Decimator->SetNumberOfLevels(
+          inInfo->Get(vtkPVRenderView::LOD_NUMBER_OF_LEVELS()));
+        }
+      // The levels are cached by the decimator, switching between them does
+      // not decimate the geometry again.
+      this->Decimator->SetLevel(inInfo->Has(vtkPVRenderView::LOD_LEVEL())?
+        inInfo->Get(vtkPVRenderView::LOD_LEVEL()) : 0);
       this->LODDeliveryFilter->Update();
       }
     else
@@ -32,7 +32,7 @@ class vtkPVCacheKeeper;
 class vtkPVGeometryFilter;
 class vtkPVLODActor;
 class vtkPVUpdateSuppressor;
-class vtkQuadricClustering;
+class vtkPVLODHierarchy;
 class vtkScalarsToColors;
 class vtkTexture;
 class vtkUnstructuredDataDeliveryFilter;
@@ -231,7 +231,7 @@ protected:
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
-  vtkQuadricClustering* Decimator;
+  vtkPVLODHierarchy* Decimator;
   vtkMapper* Mapper;
   vtkMapper* LODMapper;
   vtkPVLODActor* Actor;
@@ -14,20 +14,159 @@
 =========================================================================*/
 #include "vtkGlyph3DRepresentation.h"
 
+#include "vtkCellArray.h"
+#include "vtkCompositeDataIterator.h"
 #include "vtkCompositePolyDataMapper2.h"
 #include "vtkDataObject.h"
 #include "vtkGlyph3DMapper.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMPIMoveData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
 #include "vtkPVArrowSource.h"
+#include "vtkPVCacheKeeper.h"
 #include "vtkPVLODActor.h"
+#include "vtkPVLODHierarchy.h"
 #include "vtkPVRenderView.h"
 #include "vtkQuadricClustering.h"
 #include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnstructuredDataDeliveryFilter.h"
 
+#include <vtkstd/string>
+
+//*****************************************************************************
+// Reduces the geometry to what the vtkGlyph3DMapper needs: the points (shared,
+// not copied) and the point arrays used to scale, orient, mask and color the
+// glyphs, including the active scalars and vectors the mapper uses by
+// default. Cells are replaced by one vertex per point, so that the points are
+// still carried when the geometry is redistributed by cell for ordered
+// compositing. Point ids are unchanged so selections on the glyphs still map
+// to the geometry.
+class vtkGlyph3DRepresentationPointsExtractor :
+  public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static vtkGlyph3DRepresentationPointsExtractor* New();
+  vtkTypeMacro(vtkGlyph3DRepresentationPointsExtractor,
+    vtkMultiBlockDataSetAlgorithm);
+
+  enum { SCALE=0, ORIENTATION, MASK, COLOR, NUMBER_OF_ARRAYS };
+
+  void SetArrayName(int index, const char* name)
+    {
+    vtkstd::string value = name? name : "";
+    if (this->ArrayNames[index] != value)
+      {
+      this->ArrayNames[index] = value;
+      this->Modified();
+      }
+    }
+
+  // When set, the geometry is passed as is.
+  vtkSetMacro(PassThrough, bool);
+
+protected:
+  vtkGlyph3DRepresentationPointsExtractor()
+    {
+    this->PassThrough = false;
+    }
+
+  virtual int RequestData(vtkInformation *,
+    vtkInformationVector ** inputVector, vtkInformationVector *outputVector)
+    {
+    vtkMultiBlockDataSet* inputMB =
+      vtkMultiBlockDataSet::GetData(inputVector[0], 0);
+    vtkMultiBlockDataSet* outputMB =
+      vtkMultiBlockDataSet::GetData(outputVector, 0);
+    if (this->PassThrough)
+      {
+      outputMB->ShallowCopy(inputMB);
+      return 1;
+      }
+
+    outputMB->CopyStructure(inputMB);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(inputMB->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkPolyData* input =
+        vtkPolyData::SafeDownCast(iter->GetCurrentDataObject());
+      if (!input)
+        {
+        continue;
+        }
+      vtkPolyData* points = vtkPolyData::New();
+      points->SetPoints(input->GetPoints());
+      points->SetVerts(this->GetVertices(input->GetNumberOfPoints()));
+      this->PassArrays(input->GetPointData(), points->GetPointData());
+      outputMB->SetDataSet(iter, points);
+      points->Delete();
+      }
+    return 1;
+    }
+
+  // Returns one vertex cell per point, shared by the blocks with the same
+  // number of points.
+  vtkCellArray* GetVertices(vtkIdType numPoints)
+    {
+    if (!this->Vertices || this->Vertices->GetNumberOfCells() != numPoints)
+      {
+      vtkIdTypeArray* ids = vtkIdTypeArray::New();
+      ids->SetNumberOfTuples(2 * numPoints);
+      vtkIdType* ptr = ids->GetPointer(0);
+      for (vtkIdType cc=0; cc < numPoints; cc++)
+        {
+        *ptr++ = 1;
+        *ptr++ = cc;
+        }
+      this->Vertices = vtkSmartPointer<vtkCellArray>::New();
+      this->Vertices->SetCells(numPoints, ids);
+      ids->Delete();
+      }
+    return this->Vertices;
+    }
+
+  void PassArrays(vtkPointData* inPD, vtkPointData* outPD)
+    {
+    if (inPD->GetScalars())
+      {
+      outPD->SetScalars(inPD->GetScalars());
+      }
+    if (inPD->GetVectors())
+      {
+      outPD->SetVectors(inPD->GetVectors());
+      }
+    for (int cc=0; cc < NUMBER_OF_ARRAYS; cc++)
+      {
+      vtkAbstractArray* array = this->ArrayNames[cc].empty()? NULL :
+        inPD->GetAbstractArray(this->ArrayNames[cc].c_str());
+      if (array)
+        {
+        outPD->AddArray(array);
+        }
+      }
+    }
+
+  virtual int FillInputPortInformation(int, vtkInformation *info)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkMultiBlockDataSet");
+    return 1;
+    }
+
+  bool PassThrough;
+  vtkstd::string ArrayNames[NUMBER_OF_ARRAYS];
+  vtkSmartPointer<vtkCellArray> Vertices;
+};
+vtkStandardNewMacro(vtkGlyph3DRepresentationPointsExtractor);
+
+//*****************************************************************************
 vtkStandardNewMacro(vtkGlyph3DRepresentation);
 //----------------------------------------------------------------------------
 vtkGlyph3DRepresentation::vtkGlyph3DRepresentation()
@@ -46,6 +185,9 @@ vtkGlyph3DRepresentation::vtkGlyph3DRepresentation()
 
   this->DummySource = vtkPVArrowSource::New();
 
+  this->PointsExtractor = vtkGlyph3DRepresentationPointsExtractor::New();
+  this->LODPointsExtractor = vtkGlyph3DRepresentationPointsExtractor::New();
+
   this->GlyphMapper->SetInputConnection(0,
     this->Mapper->GetInputConnection(0, 0));
   this->LODGlyphMapper->SetInputConnection(0,
@@ -67,6 +209,7 @@ vtkGlyph3DRepresentation::vtkGlyph3DRepresentation()
   info->Delete();
 
   this->MeshVisibility = true;
+  this->DeliverPointsOnly = true;
   this->SetMeshVisibility(false);
 }
 
@@ -80,6 +223,8 @@ vtkGlyph3DRepresentation::~vtkGlyph3DRepresentation()
   this->DataCollector->Delete();
   this->LODDataCollector->Delete();
   this->DummySource->Delete();
+  this->PointsExtractor->Delete();
+  this->LODPointsExtractor->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -117,6 +262,46 @@ void vtkGlyph3DRepresentation::SetMeshVisibility(bool val)
 {
   this->MeshVisibility = val;
   this->Actor->SetVisibility((val && this->MeshVisibility)? 1 : 0);
+  this->UpdatePointsExtractors();
+}
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DRepresentation::SetDeliverPointsOnly(bool val)
+{
+  if (this->DeliverPointsOnly != val)
+    {
+    this->DeliverPointsOnly = val;
+    this->Modified();
+    this->UpdatePointsExtractors();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DRepresentation::SetColorArrayName(const char* val)
+{
+  this->Superclass::SetColorArrayName(val);
+  this->UpdatePointsExtractors();
+}
+
+//----------------------------------------------------------------------------
+void vtkGlyph3DRepresentation::UpdatePointsExtractors()
+{
+  unsigned long mtime = this->PointsExtractor->GetMTime();
+
+  bool passThrough = this->MeshVisibility || !this->DeliverPointsOnly;
+  this->PointsExtractor->SetPassThrough(passThrough);
+  this->LODPointsExtractor->SetPassThrough(passThrough);
+
+  this->PointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::COLOR, this->ColorArrayName);
+  this->LODPointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::COLOR, this->ColorArrayName);
+
+  // The delivered data changes, deliver it again.
+  if (this->PointsExtractor->GetMTime() != mtime)
+    {
+    this->MarkModified();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -159,13 +344,52 @@ int vtkGlyph3DRepresentation::RequestData(vtkInformation* request,
   this->DataCollector->Update();
   this->LODDataCollector->Update();
 
-  return this->Superclass::RequestData(request, inputVector, outputVector);
+  if (!this->Superclass::RequestData(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  // Deliver the geometry through the points extractors.
+  if (inputVector[0]->GetNumberOfInformationObjects()==1)
+    {
+    this->PointsExtractor->SetInputConnection(
+      this->CacheKeeper->GetOutputPort());
+    this->LODPointsExtractor->SetInputConnection(
+      this->Decimator->GetOutputPort());
+    this->DeliveryFilter->SetInputConnection(
+      this->PointsExtractor->GetOutputPort());
+    this->LODDeliveryFilter->SetInputConnection(
+      this->LODPointsExtractor->GetOutputPort());
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkGlyph3DRepresentation::GenerateMetaData(vtkInformation* inInfo,
+  vtkInformation* outInfo)
+{
+  if (!this->Superclass::GenerateMetaData(inInfo, outInfo))
+    {
+    return false;
+    }
+  if (!this->MeshVisibility && this->DeliverPointsOnly &&
+    this->PointsExtractor->GetNumberOfInputConnections(0) > 0)
+    {
+    // Extracting the points is cheap, nothing is copied.
+    this->PointsExtractor->Update();
+    vtkDataObject* points = this->PointsExtractor->GetOutputDataObject(0);
+    outInfo->Set(vtkPVRenderView::GEOMETRY_SIZE(),
+      points->GetActualMemorySize());
+    }
+  return true;
 }
 
 //----------------------------------------------------------------------------
 void vtkGlyph3DRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MeshVisibility: " << this->MeshVisibility << endl;
+  os << indent << "DeliverPointsOnly: " << this->DeliverPointsOnly << endl;
 }
 
 //**************************************************************************
@@ -175,6 +399,11 @@ void vtkGlyph3DRepresentation::SetMaskArray(const char* val)
 {
   this->GlyphMapper->SetMaskArray(val);
   this->LODGlyphMapper->SetMaskArray(val);
+  this->PointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::MASK, val);
+  this->LODPointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::MASK, val);
+  this->UpdatePointsExtractors();
 }
 
 //----------------------------------------------------------------------------
@@ -182,6 +411,11 @@ void vtkGlyph3DRepresentation::SetScaleArray(const char* val)
 {
   this->GlyphMapper->SetScaleArray(val);
   this->LODGlyphMapper->SetScaleArray(val);
+  this->PointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::SCALE, val);
+  this->LODPointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::SCALE, val);
+  this->UpdatePointsExtractors();
 }
 
 //----------------------------------------------------------------------------
@@ -189,6 +423,11 @@ void vtkGlyph3DRepresentation::SetOrientationArray(const char* val)
 {
   this->GlyphMapper->SetOrientationArray(val);
   this->LODGlyphMapper->SetOrientationArray(val);
+  this->PointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::ORIENTATION, val);
+  this->LODPointsExtractor->SetArrayName(
+    vtkGlyph3DRepresentationPointsExtractor::ORIENTATION, val);
+  this->UpdatePointsExtractors();
 }
 
 //----------------------------------------------------------------------------
@@ -16,6 +16,13 @@
 // .SECTION Description
 // vtkGlyph3DRepresentation is a representation that uses the vtkGlyph3DMapper
 // for rendering glyphs.
+//
+// The glyphs are rendered as instances of the glyph source: only the source
+// (cloned on all rendering processes) and the points it is placed at are
+// delivered, never the glyphs themselves. When the mesh is hidden and
+// DeliverPointsOnly is on, the delivered points also drop the cells and the
+// point arrays the glyphs do not use, so the delivery cost scales with the
+// number of glyphs.
 
 #ifndef __vtkGlyph3DRepresentation_h
 #define __vtkGlyph3DRepresentation_h
@@ -23,6 +30,7 @@
 #include "vtkGeometryRepresentation.h"
 
 class vtkGlyph3DMapper;
+class vtkGlyph3DRepresentationPointsExtractor;
 class vtkPVArrowSource;
 
 class VTK_EXPORT vtkGlyph3DRepresentation : public vtkGeometryRepresentation
@@ -42,6 +50,18 @@ public:
   // representation of false, all view passes are ignored.
   virtual void SetVisibility(bool);
 
+  // Description:
+  // When the mesh is not visible, only deliver the points of the geometry and
+  // the point arrays used to scale, orient, mask and color the glyphs rather
+  // than the whole geometry. Default is true.
+  void SetDeliverPointsOnly(bool);
+  vtkGetMacro(DeliverPointsOnly, bool);
+
+  // Description:
+  // Overridden to deliver the coloring array along with the points when
+  // DeliverPointsOnly applies.
+  virtual void SetColorArrayName(const char*);
+
   //**************************************************************************
   // Forwarded to vtkGlyph3DMapper
   void SetMaskArray(const char* val);
@@ -67,6 +87,17 @@ protected:
   virtual int RequestData(vtkInformation*,
     vtkInformationVector**, vtkInformationVector*);
 
+  // Description:
+  // Overridden to report the size of the delivered points rather than of the
+  // whole geometry when DeliverPointsOnly applies.
+  virtual bool GenerateMetaData(vtkInformation*, vtkInformation*);
+
+  // Description:
+  // Pass the arrays used by the glyphs and whether only the points are to be
+  // delivered to the points extractors. Marks the representation modified if
+  // that changes the data to deliver.
+  void UpdatePointsExtractors();
+
   // Description:
   // Adds the representation to the view.  This is called from
   // vtkView::AddRepresentation().  Subclasses should override this method.
@@ -91,8 +122,11 @@ protected:
   vtkUnstructuredDataDeliveryFilter* DataCollector;
   vtkUnstructuredDataDeliveryFilter* LODDataCollector;
   vtkPVArrowSource* DummySource;
+  vtkGlyph3DRepresentationPointsExtractor* PointsExtractor;
+  vtkGlyph3DRepresentationPointsExtractor* LODPointsExtractor;
 
   bool MeshVisibility;
+  bool DeliverPointsOnly;
 
 private:
   vtkGlyph3DRepresentation(const vtkGlyph3DRepresentation&); // Not implemented
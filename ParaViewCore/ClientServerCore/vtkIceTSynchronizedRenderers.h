@@ -114,6 +114,11 @@ public:
   void SetRenderPass(vtkRenderPass*);
   vtkGetObjectMacro(RenderPass, vtkRenderPass);
 
+  // Description:
+  // Returns the vtkIceTCompositePass used internally, e.g. to choose the
+  // compositing strategy or to query the compositing statistics.
+  vtkGetObjectMacro(IceTCompositePass, vtkIceTCompositePass);
+
 //BTX
 protected:
   vtkIceTSynchronizedRenderers();
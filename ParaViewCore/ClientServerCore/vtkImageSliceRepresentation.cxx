@@ -15,6 +15,7 @@
 #include "vtkImageSliceRepresentation.h"
 
 #include "vtkCommand.h"
+#include "vtkExtentTranslator.h"
 #include "vtkExtractVOI.h"
 #include "vtkImageData.h"
 #include "vtkImageSliceDataDeliveryFilter.h"
@@ -36,6 +37,13 @@ vtkImageSliceRepresentation::vtkImageSliceRepresentation()
 {
   this->Slice = 0;
   this->SliceMode = XY_PLANE;
+  this->StreamSlices = true;
+  this->NumberOfPrefetchedSlices = 2;
+  this->StreamedExtentValid = false;
+  for (int cc=0; cc < 6; cc++)
+    {
+    this->StreamedExtent[cc] = 0;
+    }
 
   this->SliceData = vtkImageData::New();
   this->CacheKeeper = vtkPVCacheKeeper::New();
@@ -96,6 +104,29 @@ void vtkImageSliceRepresentation::SetSlice(unsigned int val)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkImageSliceRepresentation::SetStreamSlices(bool val)
+{
+  if (this->StreamSlices != val)
+    {
+    this->StreamSlices = val;
+    this->StreamedExtentValid = false;
+    this->MarkModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageSliceRepresentation::SetNumberOfPrefetchedSlices(int val)
+{
+  val = val < 0? 0 : val;
+  if (this->NumberOfPrefetchedSlices != val)
+    {
+    this->NumberOfPrefetchedSlices = val;
+    this->StreamedExtentValid = false;
+    this->MarkModified();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkImageSliceRepresentation::SetColorArrayName(const char* name)
 {
@@ -196,6 +227,91 @@ int vtkImageSliceRepresentation::RequestData(vtkInformation* request,
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+//----------------------------------------------------------------------------
+int vtkImageSliceRepresentation::RequestUpdateExtent(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
+  if (!this->StreamSlices ||
+    inputVector[0]->GetNumberOfInformationObjects()==0 ||
+    this->GetUsingCacheForUpdate())
+    {
+    return 1;
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(this->GetExecutive());
+  int inWholeExtent[6], outExt[6];
+  memset(outExt, 0, sizeof(int)*6);
+  sddp->GetWholeExtent(inInfo, inWholeExtent);
+  int dataDescription = vtkStructuredData::SetExtent(inWholeExtent, outExt);
+  if (vtkStructuredData::GetDataDimension(dataDescription) != 3)
+    {
+    return 1;
+    }
+
+  // The piece of this process.
+  int pieceExtent[6];
+  vtkExtentTranslator* translator = sddp->GetExtentTranslator(inInfo);
+  translator->SetWholeExtent(inWholeExtent);
+  translator->SetPiece(sddp->GetUpdatePiece(inInfo));
+  translator->SetNumberOfPieces(sddp->GetUpdateNumberOfPieces(inInfo));
+  translator->SetGhostLevel(0);
+  translator->PieceToExtent();
+  translator->GetExtent(pieceExtent);
+
+  int extent[6];
+  this->ComputeStreamedExtent(inWholeExtent, pieceExtent, extent);
+  sddp->SetUpdateExtent(inInfo, extent);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageSliceRepresentation::ComputeStreamedExtent(
+  const int wholeExtent[6], const int pieceExtent[6], int extent[6])
+{
+  // The slice, clamped as in UpdateSliceData().
+  int axis = this->SliceMode == YZ_PLANE? 0 :
+    (this->SliceMode == XZ_PLANE? 1 : 2);
+  int dim = wholeExtent[2*axis+1] - wholeExtent[2*axis] + 1;
+  int slice = wholeExtent[2*axis] + (static_cast<int>(this->Slice) >= dim?
+    dim - 1 : static_cast<int>(this->Slice));
+
+  if (slice < pieceExtent[2*axis] || slice > pieceExtent[2*axis+1])
+    {
+    // The slice does not cross this piece.
+    int emptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    memcpy(extent, emptyExtent, sizeof(int)*6);
+    }
+  else
+    {
+    memcpy(extent, pieceExtent, sizeof(int)*6);
+    bool reuse = this->StreamedExtentValid;
+    for (int cc=0; cc < 6 && reuse; cc++)
+      {
+      reuse = (cc/2 == axis) || this->StreamedExtent[cc] == pieceExtent[cc];
+      }
+    if (reuse && slice >= this->StreamedExtent[2*axis] &&
+      slice <= this->StreamedExtent[2*axis+1])
+      {
+      // Still within the slab already read.
+      extent[2*axis] = this->StreamedExtent[2*axis];
+      extent[2*axis+1] = this->StreamedExtent[2*axis+1];
+      }
+    else
+      {
+      int low = slice - this->NumberOfPrefetchedSlices;
+      int high = slice + this->NumberOfPrefetchedSlices;
+      extent[2*axis] = low > pieceExtent[2*axis]? low : pieceExtent[2*axis];
+      extent[2*axis+1] = high < pieceExtent[2*axis+1]?
+        high : pieceExtent[2*axis+1];
+      }
+    memcpy(this->StreamedExtent, extent, sizeof(int)*6);
+    this->StreamedExtentValid = true;
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkImageSliceRepresentation::IsCached(double cache_key)
 {
@@ -306,6 +422,11 @@ void vtkImageSliceRepresentation::MarkModified()
 void vtkImageSliceRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "SliceMode: " << this->SliceMode << endl;
+  os << indent << "Slice: " << this->Slice << endl;
+  os << indent << "StreamSlices: " << this->StreamSlices << endl;
+  os << indent << "NumberOfPrefetchedSlices: "
+     << this->NumberOfPrefetchedSlices << endl;
 }
 
 //****************************************************************************
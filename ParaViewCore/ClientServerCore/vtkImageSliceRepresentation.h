@@ -18,6 +18,13 @@
 // vtkImageSliceRepresentation is a representation for showing slices from an
 // image dataset. Currently, it does not support composite datasets, however, we
 // should be able to add such a support in future.
+//
+// The slice is extracted on the data-server and only that slice is delivered.
+// When StreamSlices is on, the slice is also pushed upstream as the update
+// extent so that readers supporting extents only read a slab made of the
+// slice and of NumberOfPrefetchedSlices slices on each side of it. The slab
+// is kept as long as the slice stays within it, so that moving the slice to a
+// neighbouring one does not read anything.
 
 #ifndef __vtkImageSliceRepresentation_h
 #define __vtkImageSliceRepresentation_h
@@ -96,6 +103,18 @@ public:
   virtual void SetSliceMode(int);
   vtkGetMacro(SliceMode, int);
 
+  // Description:
+  // Get/Set whether only a slab around the slice is requested from the input
+  // rather than the whole image. Default is true.
+  void SetStreamSlices(bool);
+  vtkGetMacro(StreamSlices, bool);
+
+  // Description:
+  // Get/Set the number of slices requested on each side of the slice when
+  // StreamSlices is on. Default is 2.
+  void SetNumberOfPrefetchedSlices(int);
+  vtkGetMacro(NumberOfPrefetchedSlices, int);
+
   //---------------------------------------------------------------------------
   // Forwarded to Actor.
   void SetOrientation(double, double, double);
@@ -139,6 +158,20 @@ protected:
   virtual int RequestData(vtkInformation*,
     vtkInformationVector**, vtkInformationVector*);
 
+  // Description:
+  // Overridden to request the slab around the slice only when StreamSlices
+  // is on.
+  virtual int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
+  // Description:
+  // Computes the extent RequestUpdateExtent() requests for the given whole
+  // extent and extent of the piece of this process: the slab around the
+  // slice, the slab already read if the slice is still within it, or an
+  // empty extent if the slice does not cross the piece.
+  void ComputeStreamedExtent(const int wholeExtent[6],
+    const int pieceExtent[6], int extent[6]);
+
   // Description:
   // Adds the representation to the view.  This is called from
   // vtkView::AddRepresentation().  Subclasses should override this method.
@@ -157,6 +190,12 @@ protected:
 
   int SliceMode;
   unsigned int Slice;
+  bool StreamSlices;
+  int NumberOfPrefetchedSlices;
+
+  // Extent last requested from the input when streaming slices.
+  int StreamedExtent[6];
+  bool StreamedExtentValid;
 
   vtkTimeStamp DeliveryTimeStamp;
 
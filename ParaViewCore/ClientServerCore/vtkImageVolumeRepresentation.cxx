@@ -15,26 +15,107 @@
 #include "vtkImageVolumeRepresentation.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkCamera.h"
 #include "vtkCommand.h"
+#include "vtkExtentTranslator.h"
 #include "vtkFixedPointVolumeRayCastMapper.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
 #include "vtkOutlineSource.h"
+#include "vtkPiecewiseFunction.h"
 #include "vtkPolyDataMapper.h"
 #include "vtkPVCacheKeeper.h"
+#include "vtkPVImageBrickCache.h"
 #include "vtkPVLODVolume.h"
 #include "vtkPVRenderView.h"
+#include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
 #include "vtkRenderer.h"
 #include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredDataDeliveryFilter.h"
+#include "vtkVolume.h"
 #include "vtkVolumeProperty.h"
 
+#include <vtkstd/algorithm>
 #include <vtkstd/map>
 #include <vtkstd/string>
+#include <vtkstd/utility>
+#include <vtkstd/vector>
 
+//----------------------------------------------------------------------------
+// The volume rendering the bricks of a vtkImageVolumeRepresentation. It stays
+// in the renderer whatever bricks are rendered, so that the props of the
+// renderer do not depend on the data, the camera or the opacity of each
+// process.
+class vtkImageVolumeRepresentationBrickedVolume : public vtkVolume
+{
+public:
+  static vtkImageVolumeRepresentationBrickedVolume* New();
+  vtkTypeMacro(vtkImageVolumeRepresentationBrickedVolume, vtkVolume);
+
+  vtkImageVolumeRepresentation* Representation;
+
+  // Returns the bounds of the piece, transformed as the actor of the
+  // representation.
+  virtual double* GetBounds()
+    {
+    if (!this->Representation ||
+      this->Representation->BrickCache->GetNumberOfBricks() == 0)
+      {
+      return NULL;
+      }
+    double bounds[6];
+    this->Representation->BrickCache->GetBounds(bounds);
+    vtkMatrix4x4* matrix = this->Representation->Actor->GetMatrix();
+    for (int cc=0; cc < 8; cc++)
+      {
+      double corner[4] = { bounds[cc & 1], bounds[2 + ((cc >> 1) & 1)],
+        bounds[4 + ((cc >> 2) & 1)], 1.0 };
+      matrix->MultiplyPoint(corner, corner);
+      for (int i=0; i < 3; i++)
+        {
+        double value = corner[i] / corner[3];
+        if (cc == 0 || value < this->Bounds[2*i])
+          {
+          this->Bounds[2*i] = value;
+          }
+        if (cc == 0 || value > this->Bounds[2*i+1])
+          {
+          this->Bounds[2*i+1] = value;
+          }
+        }
+      }
+    return this->Bounds;
+    }
+  void GetBounds(double bounds[6]) { this->vtkProp3D::GetBounds(bounds); }
+
+  virtual int RenderVolumetricGeometry(vtkViewport* viewport)
+    {
+    vtkRenderer* renderer = vtkRenderer::SafeDownCast(viewport);
+    if (!this->Representation || !renderer)
+      {
+      return 0;
+      }
+    this->Representation->RenderBricks(renderer, this);
+    return this->Representation->GetNumberOfBricksRendered() > 0? 1 : 0;
+    }
+
+protected:
+  vtkImageVolumeRepresentationBrickedVolume() { this->Representation = NULL; }
+
+private:
+  vtkImageVolumeRepresentationBrickedVolume(
+    const vtkImageVolumeRepresentationBrickedVolume&); // Not implemented
+  void operator=(
+    const vtkImageVolumeRepresentationBrickedVolume&); // Not implemented
+};
+vtkStandardNewMacro(vtkImageVolumeRepresentationBrickedVolume);
+
+//----------------------------------------------------------------------------
 class vtkImageVolumeRepresentation::vtkInternals
 {
 public:
@@ -42,6 +123,28 @@ public:
     MapOfMappers;
   MapOfMappers Mappers;
   vtkstd::string ActiveVolumeMapper;
+
+  // Volume and mapper each brick is rendered with, in turn. It is not in the
+  // renderer, the bricked volume renders it.
+  vtkSmartPointer<vtkVolume> BrickVolume;
+  vtkSmartPointer<vtkVolumeMapper> BrickMapper;
+
+  // Extent of the piece of this process and whether it is being bricked.
+  int PieceExtent[6];
+  bool Bricked;
+
+  // When bricking, produces an image with the geometry of the piece but no
+  // arrays, for the kd-tree used for ordered compositing.
+  vtkSmartPointer<vtkPVTrivialProducer> LayoutProducer;
+
+  vtkInternals()
+    {
+    this->BrickVolume = vtkSmartPointer<vtkVolume>::New();
+    this->LayoutProducer = vtkSmartPointer<vtkPVTrivialProducer>::New();
+    this->PieceExtent[0] = this->PieceExtent[2] = this->PieceExtent[4] = 0;
+    this->PieceExtent[1] = this->PieceExtent[3] = this->PieceExtent[5] = -1;
+    this->Bricked = false;
+    }
 };
 
 vtkStandardNewMacro(vtkImageVolumeRepresentation);
@@ -66,6 +169,20 @@ vtkImageVolumeRepresentation::vtkImageVolumeRepresentation()
   this->ColorAttributeType = POINT_DATA;
   this->Cache = vtkImageData::New();
 
+  this->BrickCache = vtkPVImageBrickCache::New();
+  vtkImageVolumeRepresentationBrickedVolume* brickedVolume =
+    vtkImageVolumeRepresentationBrickedVolume::New();
+  brickedVolume->Representation = this;
+  brickedVolume->SetProperty(this->Property);
+  brickedVolume->SetVisibility(0);
+  this->BrickedVolume = brickedVolume;
+  this->UseBricking = false;
+  this->BrickSize = 128;
+  this->BrickCacheSize = 1024;
+  this->NumberOfBricksRendered = 0;
+  this->NumberOfBricksSkipped = 0;
+  this->NumberOfBricksLoaded = 0;
+
   this->CacheKeeper->SetInput(this->Cache);
   this->OutlineDeliveryFilter->SetInputConnection(
     this->OutlineSource->GetOutputPort());
@@ -79,7 +196,12 @@ vtkImageVolumeRepresentation::vtkImageVolumeRepresentation()
 //----------------------------------------------------------------------------
 vtkImageVolumeRepresentation::~vtkImageVolumeRepresentation()
 {
+  this->RemoveBricks();
+  static_cast<vtkImageVolumeRepresentationBrickedVolume*>(
+    this->BrickedVolume)->Representation = NULL;
+  this->BrickedVolume->Delete();
   delete this->Internals;
+  this->BrickCache->Delete();
   this->DefaultMapper->Delete();
   this->Property->Delete();
   this->Actor->Delete();
@@ -140,10 +262,21 @@ int vtkImageVolumeRepresentation::ProcessViewRequest(
 {
   if (request_type == vtkPVView::REQUEST_INFORMATION())
     {
-    outInfo->Set(vtkPVRenderView::GEOMETRY_SIZE(),
-      this->Cache->GetActualMemorySize());
+    // When bricking, the cache is what will be loaded on the rendering nodes.
+    unsigned long size = this->Internals->Bricked?
+      static_cast<unsigned long>(this->BrickCacheSize) * 1024 :
+      this->Cache->GetActualMemorySize();
+    outInfo->Set(vtkPVRenderView::GEOMETRY_SIZE(), size);
     outInfo->Set(vtkPVRenderView::NEED_ORDERED_COMPOSITING(), 1);
-    if (this->GetNumberOfInputConnections(0) == 1)
+    if (this->Internals->Bricked)
+      {
+      // The producer is re-executed for each brick, on each process
+      // independently, and the kd-tree would ask it for the whole piece:
+      // only tell it how the image is split.
+      outInfo->Set(vtkPVRenderView::REDISTRIBUTABLE_DATA_PRODUCER(),
+        this->Internals->LayoutProducer);
+      }
+    else if (this->GetNumberOfInputConnections(0) == 1)
       {
       outInfo->Set(vtkPVRenderView::REDISTRIBUTABLE_DATA_PRODUCER(),
         this->GetInputConnection(0, 0)->GetProducer());
@@ -178,8 +311,71 @@ int vtkImageVolumeRepresentation::RequestData(vtkInformation* request,
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
 
-  if (inputVector[0]->GetNumberOfInformationObjects()==1)
+  this->Internals->Bricked = (this->UseBricking &&
+    inputVector[0]->GetNumberOfInformationObjects()==1);
+  if (this->Internals->Bricked)
     {
+    // Nothing was loaded, the bricks are streamed when rendering. The
+    // producer changed, so were the bricks.
+    this->Cache->Initialize();
+    this->BrickCache->SetInputConnection(this->GetInputConnection(0, 0));
+    this->BrickCache->SetExtent(this->Internals->PieceExtent);
+    this->BrickCache->SetBrickSize(this->BrickSize);
+    this->BrickCache->SetMaximumCacheSize(
+      static_cast<unsigned long>(this->BrickCacheSize) * 1024);
+    this->BrickCache->SetArrayName(this->ColorArrayName);
+    this->BrickCache->SetFieldAssociation(
+      this->ColorAttributeType == CELL_DATA?
+      vtkDataObject::FIELD_ASSOCIATION_CELLS :
+      vtkDataObject::FIELD_ASSOCIATION_POINTS);
+    if (this->UpdateTimeValid)
+      {
+      this->BrickCache->SetUpdateTime(this->UpdateTime);
+      }
+    else
+      {
+      this->BrickCache->RemoveUpdateTime();
+      }
+    this->BrickCache->Initialize();
+
+    this->Actor->SetEnableLOD(0);
+    this->GetActiveVolumeMapper()->RemoveAllInputs();
+
+    double bounds[6];
+    this->BrickCache->GetBounds(bounds);
+    this->OutlineSource->SetBounds(bounds);
+
+    // An image with the geometry of the piece and no arrays, the extents of
+    // all the processes being gathered for the kd-tree.
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    int wholeExtent[6];
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+      wholeExtent);
+    if (inInfo->Has(vtkDataObject::ORIGIN()))
+      {
+      inInfo->Get(vtkDataObject::ORIGIN(), origin);
+      }
+    if (inInfo->Has(vtkDataObject::SPACING()))
+      {
+      inInfo->Get(vtkDataObject::SPACING(), spacing);
+      }
+    vtkImageData* layout = vtkImageData::New();
+    layout->SetExtent(this->Internals->PieceExtent);
+    layout->SetOrigin(origin);
+    layout->SetSpacing(spacing);
+    this->Internals->LayoutProducer->SetOutput(layout);
+    this->Internals->LayoutProducer->SetWholeExtent(wholeExtent);
+    this->Internals->LayoutProducer->GatherExtents();
+    layout->Delete();
+    }
+  else if (inputVector[0]->GetNumberOfInformationObjects()==1)
+    {
+    this->RemoveBricks();
+    this->BrickCache->SetInputConnection(NULL);
+    this->BrickCache->Initialize();
+
     vtkImageData* input = vtkImageData::GetData(inputVector[0], 0);
     if (!this->GetUsingCacheForUpdate())
       {
@@ -199,13 +395,50 @@ int vtkImageVolumeRepresentation::RequestData(vtkInformation* request,
     // when no input is present, it implies that this processes is on a node
     // without the data input i.e. either client or render-server, in which case
     // we show only the outline.
+    this->RemoveBricks();
     this->GetActiveVolumeMapper()->RemoveAllInputs();
     this->Actor->SetEnableLOD(1);
     }
 
+  // The bricks are rendered by their own volume.
+  this->Actor->SetVisibility(
+    (this->GetVisibility() && !this->Internals->Bricked)? 1 : 0);
+  this->BrickedVolume->SetVisibility(
+    (this->GetVisibility() && this->Internals->Bricked)? 1 : 0);
+
   return this->Superclass::RequestData(request, inputVector, outputVector);
 }
 
+//----------------------------------------------------------------------------
+int vtkImageVolumeRepresentation::RequestUpdateExtent(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
+  if (!this->UseBricking || inputVector[0]->GetNumberOfInformationObjects()==0)
+    {
+    return 1;
+    }
+
+  // Find out the extent of the piece requested from this process, then
+  // request nothing: the bricks of that piece are streamed later on.
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(this->GetExecutive());
+  vtkExtentTranslator* translator = sddp->GetExtentTranslator(inInfo);
+  int wholeExtent[6];
+  sddp->GetWholeExtent(inInfo, wholeExtent);
+  translator->SetWholeExtent(wholeExtent);
+  translator->SetPiece(sddp->GetUpdatePiece(inInfo));
+  translator->SetNumberOfPieces(sddp->GetUpdateNumberOfPieces(inInfo));
+  translator->SetGhostLevel(0);
+  translator->PieceToExtent();
+  translator->GetExtent(this->Internals->PieceExtent);
+
+  int emptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  sddp->SetUpdateExtent(inInfo, emptyExtent);
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 bool vtkImageVolumeRepresentation::IsCached(double cache_key)
 {
@@ -231,6 +464,7 @@ bool vtkImageVolumeRepresentation::AddToView(vtkView* view)
   if (rview)
     {
     rview->GetRenderer()->AddActor(this->Actor);
+    rview->GetRenderer()->AddActor(this->BrickedVolume);
     return true;
     }
   return false;
@@ -242,7 +476,9 @@ bool vtkImageVolumeRepresentation::RemoveFromView(vtkView* view)
   vtkPVRenderView* rview = vtkPVRenderView::SafeDownCast(view);
   if (rview)
     {
+    this->RemoveBricks();
     rview->GetRenderer()->RemoveActor(this->Actor);
+    rview->GetRenderer()->RemoveActor(this->BrickedVolume);
     return true;
     }
   return false;
@@ -267,10 +503,186 @@ void vtkImageVolumeRepresentation::UpdateMapperParameters()
   this->Actor->SetMapper(activeMapper);
 }
 
+//----------------------------------------------------------------------------
+bool vtkImageVolumeRepresentation::IsRangeVisible(const double range[2])
+{
+  vtkPiecewiseFunction* pwf = this->Property->GetScalarOpacity();
+  if (!pwf || pwf->GetSize() == 0)
+    {
+    return true;
+    }
+  if (pwf->GetValue(range[0]) > 0.0 || pwf->GetValue(range[1]) > 0.0)
+    {
+    return true;
+    }
+  // The function is linear between the nodes, it is zero over the range if
+  // it is zero at the nodes within the range too.
+  double node[4];
+  for (int cc=0; cc < pwf->GetSize(); cc++)
+    {
+    pwf->GetNodeValue(cc, node);
+    if (node[0] > range[0] && node[0] < range[1] && node[1] > 0.0)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageVolumeRepresentation::RemoveBricks()
+{
+  this->BrickedVolume->SetVisibility(0);
+  this->Internals->BrickVolume->SetMapper(NULL);
+  this->Internals->BrickMapper = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageVolumeRepresentation::RenderBricks(vtkRenderer* renderer,
+  vtkVolume* brickedVolume)
+{
+  this->NumberOfBricksRendered = 0;
+  this->NumberOfBricksSkipped = 0;
+  this->NumberOfBricksLoaded = 0;
+  if (!renderer->GetActiveCamera())
+    {
+    return;
+    }
+
+  // The camera, in the coordinates of the image.
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double position[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double focalPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  vtkMatrix4x4* matrix = vtkMatrix4x4::New();
+  matrix->DeepCopy(this->Actor->GetMatrix());
+  matrix->Invert();
+  matrix->MultiplyPoint(position, position);
+  matrix->MultiplyPoint(focalPoint, focalPoint);
+  matrix->Delete();
+  double direction[3];
+  for (int i=0; i < 3; i++)
+    {
+    position[i] /= position[3];
+    focalPoint[i] /= focalPoint[3];
+    direction[i] = focalPoint[i] - position[i];
+    }
+  bool parallel = camera->GetParallelProjection() != 0;
+
+  // Skip the bricks known to be transparent and order the others back to
+  // front (farthest brick center first).
+  vtkPVImageBrickCache* cache = this->BrickCache;
+  vtkstd::vector<vtkstd::pair<double, int> > order;
+  for (int brick=0; brick < cache->GetNumberOfBricks(); brick++)
+    {
+    double range[2];
+    if (cache->GetBrickRange(brick, range) && !this->IsRangeVisible(range))
+      {
+      this->NumberOfBricksSkipped++;
+      continue;
+      }
+    double bounds[6];
+    cache->GetBrickBounds(brick, bounds);
+    double depth = 0.0;
+    for (int i=0; i < 3; i++)
+      {
+      double delta = (bounds[2*i] + bounds[2*i+1]) / 2.0 - position[i];
+      depth += parallel? delta * direction[i] : delta * delta;
+      }
+    order.push_back(vtkstd::pair<double, int>(-depth, brick));
+    }
+  vtkstd::sort(order.begin(), order.end());
+
+  vtkVolumeMapper* activeMapper = this->GetActiveVolumeMapper();
+  vtkSmartPointer<vtkVolumeMapper>& mapper = this->Internals->BrickMapper;
+  if (!mapper ||
+    strcmp(mapper->GetClassName(), activeMapper->GetClassName()) != 0)
+    {
+    mapper.TakeReference(activeMapper->NewInstance());
+    }
+  mapper->SetBlendMode(activeMapper->GetBlendMode());
+  mapper->SelectScalarArray(this->ColorArrayName);
+  mapper->SetScalarMode(this->ColorAttributeType == CELL_DATA?
+    VTK_SCALAR_MODE_USE_CELL_FIELD_DATA :
+    VTK_SCALAR_MODE_USE_POINT_FIELD_DATA);
+  vtkVolume* volume = this->Internals->BrickVolume;
+  volume->SetMapper(mapper);
+  volume->SetProperty(this->Property);
+  volume->SetUserMatrix(this->Actor->GetMatrix());
+  volume->SetAllocatedRenderTime(
+    brickedVolume->GetAllocatedRenderTime(), renderer);
+
+  // Load, render and release the bricks one at a time: the mapper does not
+  // keep a brick once rendered, so the cache alone decides which bricks stay
+  // loaded.
+  int numberOfLoads = cache->GetNumberOfLoads();
+  for (size_t cc=0; cc < order.size(); cc++)
+    {
+    int brick = order[cc].second;
+    vtkImageData* data = cache->GetBrick(brick);
+    double range[2];
+    if (!data ||
+      (cache->GetBrickRange(brick, range) && !this->IsRangeVisible(range)))
+      {
+      this->NumberOfBricksSkipped++;
+      continue;
+      }
+    mapper->SetInput(data);
+    volume->RenderVolumetricGeometry(renderer);
+    mapper->RemoveAllInputs();
+    this->NumberOfBricksRendered++;
+    }
+  this->NumberOfBricksLoaded = cache->GetNumberOfLoads() - numberOfLoads;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageVolumeRepresentation::SetUseBricking(bool val)
+{
+  if (this->UseBricking != val)
+    {
+    this->UseBricking = val;
+    this->MarkModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageVolumeRepresentation::SetBrickSize(int val)
+{
+  val = val < 2? 2 : val;
+  if (this->BrickSize != val)
+    {
+    this->BrickSize = val;
+    this->MarkModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageVolumeRepresentation::SetBrickCacheSize(int val)
+{
+  val = val < 0? 0 : val;
+  if (this->BrickCacheSize != val)
+    {
+    this->BrickCacheSize = val;
+    this->BrickCache->SetMaximumCacheSize(
+      static_cast<unsigned long>(val) * 1024);
+    this->Modified();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkImageVolumeRepresentation::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "UseBricking: " << this->UseBricking << endl;
+  os << indent << "BrickSize: " << this->BrickSize << endl;
+  os << indent << "BrickCacheSize: " << this->BrickCacheSize << endl;
+  os << indent << "NumberOfBricksRendered: " << this->NumberOfBricksRendered
+     << endl;
+  os << indent << "NumberOfBricksSkipped: " << this->NumberOfBricksSkipped
+     << endl;
+  os << indent << "NumberOfBricksLoaded: " << this->NumberOfBricksLoaded
+     << endl;
 }
 
 
@@ -309,7 +721,9 @@ void vtkImageVolumeRepresentation::SetScale(double x, double y, double z)
 void vtkImageVolumeRepresentation::SetVisibility(bool val)
 {
   this->Superclass::SetVisibility(val);
-  this->Actor->SetVisibility(val? 1 : 0);
+  this->Actor->SetVisibility((val && !this->Internals->Bricked)? 1 : 0);
+  this->BrickedVolume->SetVisibility(
+    (val && this->Internals->Bricked)? 1 : 0);
 }
 
 //***************************************************************************
@@ -20,6 +20,19 @@
 // representation does not support delivery to client (or render server) nodes.
 // In those configurations, it merely delivers a outline for the image to the
 // client and render-server and those nodes simply render the outline.
+//
+// When UseBricking is on, the image is never loaded as a whole. The piece of
+// each process is split into bricks (see vtkPVImageBrickCache) streamed from
+// the input's producer when they are first rendered and kept in a cache of at
+// most BrickCacheSize megabytes. The scalar range of each brick is recorded
+// when it is loaded, and bricks whose range is fully transparent for the
+// current scalar opacity function are neither loaded again nor rendered.
+// The other bricks are rendered back to front by a single volume, always in
+// the renderer, that renders them one at a time with a mapper of the same type
+// as the active one and releases each brick once rendered, so that at most one
+// brick besides the cache is loaded. The kd-tree used for ordered
+// compositing is built from the extents of the pieces rather than from the
+// producer, which only holds the last brick loaded on each process.
 
 #ifndef __vtkImageVolumeRepresentation_h
 #define __vtkImageVolumeRepresentation_h
@@ -33,9 +46,12 @@ class vtkOutlineSource;
 class vtkPiecewiseFunction;
 class vtkPolyDataMapper;
 class vtkPVCacheKeeper;
+class vtkPVImageBrickCache;
 class vtkPVLODVolume;
 class vtkPVUpdateSuppressor;
+class vtkRenderer;
 class vtkUnstructuredDataDeliveryFilter;
+class vtkVolume;
 class vtkVolumeMapper;
 class vtkVolumeProperty;
 
@@ -94,6 +110,31 @@ public:
   // representation of false, all view passes are ignored.
   virtual void SetVisibility(bool val);
 
+  // Description:
+  // Get/Set whether the image is streamed and rendered brick by brick rather
+  // than as a whole. Default is false.
+  void SetUseBricking(bool);
+  vtkGetMacro(UseBricking, bool);
+
+  // Description:
+  // Get/Set the maximum number of points of a brick along each axis. Default
+  // is 128.
+  void SetBrickSize(int);
+  vtkGetMacro(BrickSize, int);
+
+  // Description:
+  // Get/Set the maximum size, in megabytes, of the bricks kept loaded between
+  // renders. Default is 1024.
+  void SetBrickCacheSize(int);
+  vtkGetMacro(BrickCacheSize, int);
+
+  // Description:
+  // Returns the number of bricks rendered, skipped because transparent and
+  // loaded for the last render when UseBricking is on.
+  vtkGetMacro(NumberOfBricksRendered, int);
+  vtkGetMacro(NumberOfBricksSkipped, int);
+  vtkGetMacro(NumberOfBricksLoaded, int);
+
   //***************************************************************************
   // Forwarded to Actor.
   void SetOrientation(double, double, double);
@@ -127,6 +168,12 @@ protected:
   virtual int RequestData(vtkInformation*,
     vtkInformationVector**, vtkInformationVector*);
 
+  // Description:
+  // Overridden to request an empty extent, and to compute the extent of the
+  // piece to brick, when UseBricking is on.
+  virtual int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector);
+
   // Description:
   // Produce meta-data about this representation that the view may find useful.
   bool GenerateMetaData(vtkInformation*, vtkInformation*);
@@ -151,6 +198,21 @@ protected:
   // Passes on parameters to the active volume mapper
   virtual void UpdateMapperParameters();
 
+  // Description:
+  // Selects and orders the bricks to render from the current camera and
+  // scalar opacity function, then loads, renders and releases them one at a
+  // time. Called by BrickedVolume when it renders.
+  void RenderBricks(vtkRenderer* renderer, vtkVolume* brickedVolume);
+  friend class vtkImageVolumeRepresentationBrickedVolume;
+
+  // Description:
+  // Returns false if the scalar opacity function is zero over the range.
+  bool IsRangeVisible(const double range[2]);
+
+  // Description:
+  // Hides BrickedVolume and releases the brick it last rendered.
+  void RemoveBricks();
+
   vtkImageData* Cache;
   vtkPVCacheKeeper* CacheKeeper;
   vtkFixedPointVolumeRayCastMapper* DefaultMapper;
@@ -162,6 +224,15 @@ protected:
   vtkPVUpdateSuppressor* OutlineUpdateSuppressor;
   vtkPolyDataMapper* OutlineMapper;;
 
+  vtkPVImageBrickCache* BrickCache;
+  vtkVolume* BrickedVolume;
+  bool UseBricking;
+  int BrickSize;
+  int BrickCacheSize;
+  int NumberOfBricksRendered;
+  int NumberOfBricksSkipped;
+  int NumberOfBricksLoaded;
+
   int ColorAttributeType;
   char* ColorArrayName;
 
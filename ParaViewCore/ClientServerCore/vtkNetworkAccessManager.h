@@ -72,6 +72,15 @@ public:
   // Returns true is the manager is currently waiting for any connections.
   virtual bool GetPendingConnectionsPresent()=0;
 
+  // Description:
+  // Returns the size (in bytes) above which the messages exchanged over the
+  // given connection are compressed, as agreed by both ends when the
+  // connection was established. 0 means no compression. The default
+  // implementation never compresses.
+  virtual int GetNegotiatedCompressionThreshold(
+    vtkMultiProcessController* vtkNotUsed(controller))
+    { return 0; }
+
 //BTX
 protected:
   vtkNetworkAccessManager();
@@ -0,0 +1,395 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVImageBrickCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVImageBrickCache.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkAlgorithmOutput.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vtkstd/vector>
+
+//----------------------------------------------------------------------------
+// Splits [min, max] into ranges of at most size points, adjacent ranges
+// sharing their end point.
+static void vtkPVImageBrickCacheSplit(int min, int max, int size,
+  vtkstd::vector<int>& ranges)
+{
+  int start = min;
+  do
+    {
+    int end = (start + size - 1 < max)? start + size - 1 : max;
+    ranges.push_back(start);
+    ranges.push_back(end);
+    start = end;
+    }
+  while (start < max);
+}
+
+//----------------------------------------------------------------------------
+class vtkPVImageBrickCache::vtkInternals
+{
+public:
+  struct Brick
+    {
+    int Extent[6];
+    double Range[2];
+    bool RangeValid;
+    vtkSmartPointer<vtkImageData> Data;
+    unsigned long Size;
+    unsigned long LastUsed;
+    };
+
+  vtkstd::vector<Brick> Bricks;
+  unsigned long CacheSize;
+  unsigned long Clock;
+
+  vtkInternals()
+    {
+    this->CacheSize = 0;
+    this->Clock = 0;
+    }
+};
+
+vtkStandardNewMacro(vtkPVImageBrickCache);
+//----------------------------------------------------------------------------
+vtkPVImageBrickCache::vtkPVImageBrickCache()
+{
+  this->Producer = NULL;
+  this->ProducerPort = 0;
+  this->Extent[0] = this->Extent[2] = this->Extent[4] = 0;
+  this->Extent[1] = this->Extent[3] = this->Extent[5] = -1;
+  this->BrickSize = 128;
+  this->MaximumCacheSize = 1024*1024;
+  this->ArrayName = NULL;
+  this->FieldAssociation = vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  this->UpdateTime = 0.0;
+  this->UpdateTimeValid = false;
+  this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+  this->Spacing[0] = this->Spacing[1] = this->Spacing[2] = 1.0;
+  this->NumberOfLoads = 0;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVImageBrickCache::~vtkPVImageBrickCache()
+{
+  this->SetInputConnection(NULL);
+  this->SetArrayName(NULL);
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::SetInputConnection(vtkAlgorithmOutput* input)
+{
+  vtkAlgorithm* producer = input? input->GetProducer() : NULL;
+  int port = input? input->GetIndex() : 0;
+  if (producer == this->Producer && port == this->ProducerPort)
+    {
+    return;
+    }
+  if (this->Producer)
+    {
+    this->Producer->UnRegister(this);
+    }
+  this->Producer = producer;
+  this->ProducerPort = port;
+  if (this->Producer)
+    {
+    this->Producer->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::SetUpdateTime(double time)
+{
+  if (!this->UpdateTimeValid || this->UpdateTime != time)
+    {
+    this->UpdateTime = time;
+    this->UpdateTimeValid = true;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::RemoveUpdateTime()
+{
+  if (this->UpdateTimeValid)
+    {
+    this->UpdateTimeValid = false;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::Initialize()
+{
+  this->Internals->Bricks.clear();
+  this->Internals->CacheSize = 0;
+  this->NumberOfLoads = 0;
+
+  if (this->Producer)
+    {
+    this->Producer->UpdateInformation();
+    vtkInformation* outInfo =
+      this->Producer->GetOutputInformation(this->ProducerPort);
+    if (outInfo && outInfo->Has(vtkDataObject::ORIGIN()))
+      {
+      outInfo->Get(vtkDataObject::ORIGIN(), this->Origin);
+      }
+    if (outInfo && outInfo->Has(vtkDataObject::SPACING()))
+      {
+      outInfo->Get(vtkDataObject::SPACING(), this->Spacing);
+      }
+    }
+
+  if (this->Extent[1] < this->Extent[0] || this->Extent[3] < this->Extent[2] ||
+    this->Extent[5] < this->Extent[4])
+    {
+    return;
+    }
+
+  vtkstd::vector<int> ranges[3];
+  for (int axis=0; axis < 3; axis++)
+    {
+    vtkPVImageBrickCacheSplit(this->Extent[2*axis], this->Extent[2*axis+1],
+      this->BrickSize, ranges[axis]);
+    }
+  for (size_t k=0; k < ranges[2].size(); k += 2)
+    {
+    for (size_t j=0; j < ranges[1].size(); j += 2)
+      {
+      for (size_t i=0; i < ranges[0].size(); i += 2)
+        {
+        vtkInternals::Brick brick;
+        brick.Extent[0] = ranges[0][i];
+        brick.Extent[1] = ranges[0][i+1];
+        brick.Extent[2] = ranges[1][j];
+        brick.Extent[3] = ranges[1][j+1];
+        brick.Extent[4] = ranges[2][k];
+        brick.Extent[5] = ranges[2][k+1];
+        brick.Range[0] = brick.Range[1] = 0.0;
+        brick.RangeValid = false;
+        brick.Size = 0;
+        brick.LastUsed = 0;
+        this->Internals->Bricks.push_back(brick);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVImageBrickCache::GetNumberOfBricks()
+{
+  return static_cast<int>(this->Internals->Bricks.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::GetBrickExtent(int brick, int extent[6])
+{
+  for (int cc=0; cc < 6; cc++)
+    {
+    extent[cc] = this->Internals->Bricks[brick].Extent[cc];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::GetBrickBounds(int brick, double bounds[6])
+{
+  const int* extent = this->Internals->Bricks[brick].Extent;
+  for (int cc=0; cc < 6; cc++)
+    {
+    bounds[cc] = this->Origin[cc/2] + extent[cc] * this->Spacing[cc/2];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::GetBounds(double bounds[6])
+{
+  for (int cc=0; cc < 6; cc++)
+    {
+    bounds[cc] = this->Origin[cc/2] + this->Extent[cc] * this->Spacing[cc/2];
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVImageBrickCache::GetBrickRange(int brick, double range[2])
+{
+  const vtkInternals::Brick& info = this->Internals->Bricks[brick];
+  range[0] = info.Range[0];
+  range[1] = info.Range[1];
+  return info.RangeValid;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVImageBrickCache::IsBrickLoaded(int brick)
+{
+  return this->Internals->Bricks[brick].Data.GetPointer() != NULL;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPVImageBrickCache::GetCacheSize()
+{
+  return this->Internals->CacheSize;
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkPVImageBrickCache::GetBrick(int brick)
+{
+  vtkInternals::Brick& info = this->Internals->Bricks[brick];
+  info.LastUsed = ++this->Internals->Clock;
+  if (info.Data)
+    {
+    return info.Data;
+    }
+
+  vtkStreamingDemandDrivenPipeline* sddp = this->Producer?
+    vtkStreamingDemandDrivenPipeline::SafeDownCast(
+      this->Producer->GetExecutive()) : NULL;
+  if (!sddp)
+    {
+    return NULL;
+    }
+
+  // Request the extent of the brick only, cropped exactly to it. The
+  // producer is shared with the rest of the pipeline, hence the request is
+  // restored once the brick is loaded.
+  sddp->UpdateInformation();
+  vtkInformation* outInfo = sddp->GetOutputInformation(this->ProducerPort);
+  int previousExtent[6];
+  sddp->GetUpdateExtent(outInfo, previousExtent);
+  bool hadExactExtent =
+    outInfo->Has(vtkStreamingDemandDrivenPipeline::EXACT_EXTENT()) != 0;
+  int previousExactExtent = hadExactExtent?
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::EXACT_EXTENT()) : 0;
+  vtkstd::vector<double> previousTimes;
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()))
+    {
+    double* times =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+    previousTimes.assign(times, times + outInfo->Length(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS()));
+    }
+
+  sddp->SetUpdateExtent(outInfo, info.Extent);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::EXACT_EXTENT(), 1);
+  if (this->UpdateTimeValid)
+    {
+    sddp->SetUpdateTimeSteps(outInfo, &this->UpdateTime, 1);
+    }
+  sddp->Update(this->ProducerPort);
+
+  // The producer reuses its output for the next execution, keep a copy.
+  vtkImageData* output = vtkImageData::SafeDownCast(
+    this->Producer->GetOutputDataObject(this->ProducerPort));
+  if (output)
+    {
+    info.Data = vtkSmartPointer<vtkImageData>::New();
+    info.Data->DeepCopy(output);
+    }
+
+  sddp->SetUpdateExtent(outInfo, previousExtent);
+  if (hadExactExtent)
+    {
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::EXACT_EXTENT(),
+      previousExactExtent);
+    }
+  else
+    {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::EXACT_EXTENT());
+    }
+  if (!previousTimes.empty())
+    {
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
+      &previousTimes[0], static_cast<int>(previousTimes.size()));
+    }
+  else
+    {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+    }
+
+  if (!info.Data)
+    {
+    return NULL;
+    }
+  info.Size = info.Data->GetActualMemorySize();
+  this->Internals->CacheSize += info.Size;
+  this->NumberOfLoads++;
+
+  vtkDataSetAttributes* attributes =
+    (this->FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)?
+    static_cast<vtkDataSetAttributes*>(info.Data->GetCellData()) :
+    static_cast<vtkDataSetAttributes*>(info.Data->GetPointData());
+  vtkDataArray* array = this->ArrayName?
+    attributes->GetArray(this->ArrayName) : attributes->GetScalars();
+  info.RangeValid = (array && array->GetNumberOfComponents() == 1);
+  if (info.RangeValid)
+    {
+    array->GetRange(info.Range, 0);
+    }
+
+  this->Shrink(brick);
+  return info.Data;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::Shrink(int keep)
+{
+  vtkstd::vector<vtkInternals::Brick>& bricks = this->Internals->Bricks;
+  while (this->Internals->CacheSize > this->MaximumCacheSize)
+    {
+    int oldest = -1;
+    for (int cc=0; cc < static_cast<int>(bricks.size()); cc++)
+      {
+      if (cc != keep && bricks[cc].Data &&
+        (oldest == -1 || bricks[cc].LastUsed < bricks[oldest].LastUsed))
+        {
+        oldest = cc;
+        }
+      }
+    if (oldest == -1)
+      {
+      break;
+      }
+    bricks[oldest].Data = NULL;
+    this->Internals->CacheSize -= bricks[oldest].Size;
+    bricks[oldest].Size = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVImageBrickCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Extent: " << this->Extent[0] << ", " << this->Extent[1]
+     << ", " << this->Extent[2] << ", " << this->Extent[3] << ", "
+     << this->Extent[4] << ", " << this->Extent[5] << endl;
+  os << indent << "BrickSize: " << this->BrickSize << endl;
+  os << indent << "MaximumCacheSize: " << this->MaximumCacheSize << endl;
+  os << indent << "ArrayName: "
+     << (this->ArrayName? this->ArrayName : "(none)") << endl;
+  os << indent << "FieldAssociation: " << this->FieldAssociation << endl;
+  os << indent << "NumberOfBricks: " << this->GetNumberOfBricks() << endl;
+  os << indent << "CacheSize: " << this->GetCacheSize() << endl;
+  os << indent << "NumberOfLoads: " << this->NumberOfLoads << endl;
+}
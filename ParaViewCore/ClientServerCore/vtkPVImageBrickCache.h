@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVImageBrickCache.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVImageBrickCache - streams bricks of an image from its producer.
+// .SECTION Description
+// vtkPVImageBrickCache splits the Extent of an image into bricks of at most
+// BrickSize points along each axis and streams a brick from the producer set
+// with SetInputConnection() (by requesting the extent of that brick only) the
+// first time it is asked for with GetBrick(). Adjacent bricks share a layer of
+// points so that they can be interpolated independently without seams.
+//
+// Loaded bricks are kept, least recently used ones being released once they
+// take more than MaximumCacheSize. The scalar range of a brick is computed
+// when it is loaded and kept even after the brick is released, so that
+// bricks that do not contribute to a rendering can be skipped without being
+// loaded again.
+//
+// The producer must be able to produce any sub-extent of its whole extent
+// independently on each process. Its update request (extent, EXACT_EXTENT
+// and time) is restored after each brick is loaded, since it is usually
+// shared with the rest of the pipeline; its output holds the last brick
+// loaded.
+// .SECTION See Also
+// vtkImageVolumeRepresentation
+
+#ifndef __vtkPVImageBrickCache_h
+#define __vtkPVImageBrickCache_h
+
+#include "vtkObject.h"
+
+class vtkAlgorithm;
+class vtkAlgorithmOutput;
+class vtkImageData;
+
+class VTK_EXPORT vtkPVImageBrickCache : public vtkObject
+{
+public:
+  static vtkPVImageBrickCache* New();
+  vtkTypeMacro(vtkPVImageBrickCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the output port of the algorithm producing the image.
+  void SetInputConnection(vtkAlgorithmOutput* input);
+
+  // Description:
+  // Get/Set the extent to split into bricks, typically the piece of the
+  // image assigned to this process.
+  vtkSetVector6Macro(Extent, int);
+  vtkGetVector6Macro(Extent, int);
+
+  // Description:
+  // Get/Set the maximum number of points of a brick along each axis.
+  // Default is 128.
+  vtkSetClampMacro(BrickSize, int, 2, VTK_INT_MAX);
+  vtkGetMacro(BrickSize, int);
+
+  // Description:
+  // Get/Set the maximum size, in kilobytes, of the loaded bricks. Default is
+  // 1 GB.
+  vtkSetMacro(MaximumCacheSize, unsigned long);
+  vtkGetMacro(MaximumCacheSize, unsigned long);
+
+  // Description:
+  // Get/Set the array the range of the bricks is computed for. When not set,
+  // the point (or cell, see FieldAssociation) scalars are used.
+  vtkSetStringMacro(ArrayName);
+  vtkGetStringMacro(ArrayName);
+
+  // Description:
+  // Get/Set whether ArrayName is a point (vtkDataObject::FIELD_ASSOCIATION_POINTS,
+  // the default) or a cell array.
+  vtkSetMacro(FieldAssociation, int);
+  vtkGetMacro(FieldAssociation, int);
+
+  // Description:
+  // Time requested from the producer when loading bricks.
+  void SetUpdateTime(double time);
+  void RemoveUpdateTime();
+
+  // Description:
+  // Split Extent into bricks, releasing all the loaded bricks and their
+  // ranges. To be called whenever the producer or the settings change.
+  void Initialize();
+
+  // Description:
+  // Returns the number of bricks.
+  int GetNumberOfBricks();
+
+  // Description:
+  // Returns the extent and the bounds of a brick.
+  void GetBrickExtent(int brick, int extent[6]);
+  void GetBrickBounds(int brick, double bounds[6]);
+
+  // Description:
+  // Returns the bounds of Extent.
+  void GetBounds(double bounds[6]);
+
+  // Description:
+  // Fills range with the range of the first component of the brick's array
+  // and returns true if it is known i.e. if the brick was loaded once and the
+  // array has a single component.
+  bool GetBrickRange(int brick, double range[2]);
+
+  // Description:
+  // Returns the brick, streaming it from the producer if it is not loaded.
+  vtkImageData* GetBrick(int brick);
+
+  // Description:
+  // Returns whether a brick is loaded.
+  bool IsBrickLoaded(int brick);
+
+  // Description:
+  // Returns the size, in kilobytes, of the loaded bricks.
+  unsigned long GetCacheSize();
+
+  // Description:
+  // Returns the number of bricks streamed from the producer since the last
+  // Initialize().
+  vtkGetMacro(NumberOfLoads, int);
+
+//BTX
+protected:
+  vtkPVImageBrickCache();
+  ~vtkPVImageBrickCache();
+
+  // Description:
+  // Release the least recently used bricks, except \c keep, until the cache
+  // fits in MaximumCacheSize.
+  void Shrink(int keep);
+
+  vtkAlgorithm* Producer;
+  int ProducerPort;
+  int Extent[6];
+  int BrickSize;
+  unsigned long MaximumCacheSize;
+  char* ArrayName;
+  int FieldAssociation;
+  double UpdateTime;
+  bool UpdateTimeValid;
+  double Origin[3];
+  double Spacing[3];
+  int NumberOfLoads;
+
+private:
+  vtkPVImageBrickCache(const vtkPVImageBrickCache&); // Not implemented
+  void operator=(const vtkPVImageBrickCache&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
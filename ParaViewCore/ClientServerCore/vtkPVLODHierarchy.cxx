@@ -0,0 +1,268 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODHierarchy.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLODHierarchy.h"
+
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/vector>
+
+//----------------------------------------------------------------------------
+// Decimation of one leaf of the input into all the levels. The decimators are
+// chained (level i+1 takes the output of level i as input), updating the last
+// one builds all the levels.
+struct vtkPVLODHierarchyJob
+{
+  vtkSmartPointer<vtkPolyData> Input;
+  vtkstd::vector<vtkSmartPointer<vtkQuadricClustering> > Decimators;
+};
+
+//----------------------------------------------------------------------------
+class vtkPVLODHierarchy::vtkInternals
+{
+public:
+  vtkstd::vector<vtkSmartPointer<vtkDataObject> > Levels;
+
+  // What the levels were built from.
+  vtkDataObject* Input;
+  unsigned long InputMTime;
+  int NumberOfDivisions;
+
+  vtkInternals()
+    {
+    this->Input = NULL;
+    this->InputMTime = 0;
+    this->NumberOfDivisions = 0;
+    }
+
+  bool NeedsRebuild(vtkDataObject* input, int numLevels, int divisions)
+    {
+    return (this->Levels.size() != static_cast<size_t>(numLevels) ||
+      this->Input != input || this->InputMTime != input->GetMTime() ||
+      this->NumberOfDivisions != divisions);
+    }
+};
+
+vtkStandardNewMacro(vtkPVLODHierarchy);
+//----------------------------------------------------------------------------
+vtkPVLODHierarchy::vtkPVLODHierarchy()
+{
+  this->NumberOfLevels = 3;
+  this->Level = 0;
+  this->NumberOfDivisions = 85;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODHierarchy::~vtkPVLODHierarchy()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchy::ClearLevels()
+{
+  if (this->Internals->Levels.size() > 0)
+    {
+    this->Internals->Levels.clear();
+    this->Internals->Input = NULL;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODHierarchy::RequestDataObject(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  if (!input)
+    {
+    return 0;
+    }
+
+  // Composite datasets keep their type, anything else is decimated into
+  // polydata.
+  vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+  const char* outputType = vtkCompositeDataSet::SafeDownCast(input)?
+    input->GetClassName() : "vtkPolyData";
+  if (!output || !output->IsA(outputType))
+    {
+    vtkDataObject* newOutput = vtkCompositeDataSet::SafeDownCast(input)?
+      input->NewInstance() : vtkPolyData::New();
+    newOutput->SetPipelineInformation(outputVector->GetInformationObject(0));
+    newOutput->Delete();
+    this->GetOutputPortInformation(0)->Set(
+      vtkDataObject::DATA_EXTENT_TYPE(), newOutput->GetExtentType());
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODHierarchy::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+  vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
+
+  if (this->Internals->NeedsRebuild(input, this->NumberOfLevels,
+      this->NumberOfDivisions))
+    {
+    this->BuildLevels(input);
+    }
+
+  int level = this->Level < this->NumberOfLevels?
+    this->Level : this->NumberOfLevels - 1;
+  output->ShallowCopy(this->Internals->Levels[level]);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchy::BuildLevels(vtkDataObject* input)
+{
+  vtkTimerLog::MarkStartEvent("vtkPVLODHierarchy::BuildLevels");
+
+  // Collect the leaves to decimate.
+  vtkstd::vector<vtkPVLODHierarchyJob> jobs;
+  vtkstd::vector<vtkDataObject*> leaves;
+  vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input);
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  if (cd)
+    {
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      leaves.push_back(iter->GetCurrentDataObject());
+      }
+    }
+  else
+    {
+    leaves.push_back(input);
+    }
+
+  vtkstd::vector<int> jobIndex(leaves.size(), -1);
+  for (size_t cc=0; cc < leaves.size(); cc++)
+    {
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(leaves[cc]);
+    if (!pd || pd->GetNumberOfCells() == 0)
+      {
+      continue;
+      }
+
+    // Work on a shallow copy so that the decimators do not connect to the
+    // pipeline producing the input.
+    vtkPVLODHierarchyJob job;
+    job.Input = vtkSmartPointer<vtkPolyData>::New();
+    job.Input->ShallowCopy(pd);
+    int divisions = this->NumberOfDivisions;
+    for (int level=0; level < this->NumberOfLevels; level++)
+      {
+      vtkSmartPointer<vtkQuadricClustering> decimator =
+        vtkSmartPointer<vtkQuadricClustering>::New();
+      decimator->SetUseInputPoints(1);
+      decimator->SetCopyCellData(1);
+      decimator->SetUseInternalTriangles(0);
+      decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+      if (level == 0)
+        {
+        decimator->SetInput(job.Input);
+        }
+      else
+        {
+        decimator->SetInputConnection(
+          job.Decimators.back()->GetOutputPort());
+        }
+      job.Decimators.push_back(decimator);
+      divisions = divisions / 2 > 2? divisions / 2 : 2;
+      }
+    jobIndex[cc] = static_cast<int>(jobs.size());
+    jobs.push_back(job);
+    }
+
+  // The pipelines are updated one after the other: executives, reference
+  // counting and the garbage collector are not thread safe.
+  for (size_t cc=0; cc < jobs.size(); cc++)
+    {
+    jobs[cc].Decimators.back()->Update();
+    }
+
+  // Assemble the levels. Leaves that are not decimated are passed as is.
+  this->Internals->Levels.clear();
+  for (int level=0; level < this->NumberOfLevels; level++)
+    {
+    vtkSmartPointer<vtkDataObject> result;
+    if (cd)
+      {
+      vtkCompositeDataSet* levelCD = cd->NewInstance();
+      levelCD->CopyStructure(cd);
+      size_t cc = 0;
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+        iter->GoToNextItem(), cc++)
+        {
+        if (jobIndex[cc] == -1)
+          {
+          levelCD->SetDataSet(iter, leaves[cc]);
+          continue;
+          }
+        vtkPolyData* decimated = vtkPolyData::New();
+        decimated->ShallowCopy(
+          jobs[jobIndex[cc]].Decimators[level]->GetOutput());
+        levelCD->SetDataSet(iter, decimated);
+        decimated->Delete();
+        }
+      result.TakeReference(levelCD);
+      }
+    else
+      {
+      vtkPolyData* decimated = vtkPolyData::New();
+      if (jobIndex[0] == -1)
+        {
+        decimated->ShallowCopy(input);
+        }
+      else
+        {
+        decimated->ShallowCopy(jobs[jobIndex[0]].Decimators[level]->GetOutput());
+        }
+      result.TakeReference(decimated);
+      }
+    this->Internals->Levels.push_back(result);
+    }
+
+  this->Internals->Input = input;
+  this->Internals->InputMTime = input->GetMTime();
+  this->Internals->NumberOfDivisions = this->NumberOfDivisions;
+
+  vtkTimerLog::MarkEndEvent("vtkPVLODHierarchy::BuildLevels");
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchy::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << endl;
+  os << indent << "Level: " << this->Level << endl;
+  os << indent << "NumberOfDivisions: " << this->NumberOfDivisions << endl;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODHierarchy.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVLODHierarchy - caches several levels of detail of polygonal data.
+// .SECTION Description
+// vtkPVLODHierarchy decimates its input (vtkPolyData or a composite dataset of
+// vtkPolyData) with vtkQuadricClustering into NumberOfLevels levels of detail
+// and produces the one selected with Level. Level 0 is the finest level and
+// uses a grid of NumberOfDivisions divisions along each axis; every following
+// level halves that number and is built from the previous level rather than
+// from the input, which makes the coarse levels cheap to compute.
+//
+// All levels are built together, the first time one is requested after the
+// input or the divisions changed, and are cached afterwards so that changing
+// the Level does not decimate anything.
+
+#ifndef __vtkPVLODHierarchy_h
+#define __vtkPVLODHierarchy_h
+
+#include "vtkDataObjectAlgorithm.h"
+
+class VTK_EXPORT vtkPVLODHierarchy : public vtkDataObjectAlgorithm
+{
+public:
+  static vtkPVLODHierarchy* New();
+  vtkTypeMacro(vtkPVLODHierarchy, vtkDataObjectAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the number of levels of detail. Default is 3.
+  vtkSetClampMacro(NumberOfLevels, int, 1, 8);
+  vtkGetMacro(NumberOfLevels, int);
+
+  // Description:
+  // Get/Set the level produced by the filter, 0 being the finest one. Values
+  // beyond the last level select the last (coarsest) level. Default is 0.
+  vtkSetClampMacro(Level, int, 0, VTK_INT_MAX);
+  vtkGetMacro(Level, int);
+
+  // Description:
+  // Get/Set the number of divisions along each axis used for the finest level.
+  // Default is 85.
+  vtkSetClampMacro(NumberOfDivisions, int, 2, VTK_INT_MAX);
+  vtkGetMacro(NumberOfDivisions, int);
+
+  // Description:
+  // Release the cached levels.
+  void ClearLevels();
+
+//BTX
+protected:
+  vtkPVLODHierarchy();
+  ~vtkPVLODHierarchy();
+
+  virtual int RequestDataObject(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector*);
+
+  // Description:
+  // Rebuild all the levels from the given input.
+  void BuildLevels(vtkDataObject* input);
+
+  int NumberOfLevels;
+  int Level;
+  int NumberOfDivisions;
+
+private:
+  vtkPVLODHierarchy(const vtkPVLODHierarchy&); // Not implemented
+  void operator=(const vtkPVLODHierarchy&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
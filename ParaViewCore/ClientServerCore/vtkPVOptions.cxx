@@ -90,6 +90,7 @@ vtkPVOptions::vtkPVOptions()
   this->SetVRUIAddress("localhost");
 
   this->Timeout = 0;
+  this->SocketBufferSize = 0;
 
   if (this->XMLParser)
     {
@@ -271,6 +272,12 @@ void vtkPVOptions::Initialize()
                     "messages before the server times out.",
                     vtkPVOptions::PVDATA_SERVER|vtkPVOptions::PVSERVER);
 
+  this->AddArgument("--socket-buffer-size", 0, &this->SocketBufferSize,
+                    "Size (in bytes) of the send and receive buffers of the "
+                    "client-server sockets. Larger buffers help keeping high "
+                    "latency links busy. The system defaults are used if not set.",
+                    vtkPVOptions::ALLPROCESS);
+
   // Disabling for now since we don't support Cave anymore.
   // this->AddArgument("--cave-configuration", "-cc", &this->CaveConfigurationFileName,
   // "Specify the file that defines the displays for a cave. It is used only with CaveRenderModule.");
@@ -470,6 +477,7 @@ void vtkPVOptions::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "Timeout: " << this->Timeout << endl;
+  os << indent << "SocketBufferSize: " << this->SocketBufferSize << endl;
   os << indent << "Software Rendering: " << (this->UseSoftwareRendering?"Enabled":"Disabled") << endl;
 
   os << indent << "Satellite Software Rendering: " << (this->UseSatelliteSoftwareRendering?"Enabled":"Disabled") << endl;
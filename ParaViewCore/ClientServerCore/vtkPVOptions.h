@@ -92,6 +92,12 @@ public:
   // server may timeout. timeout <= 0 means no timeout.
   vtkGetMacro(Timeout, int);
 
+  // Description:
+  // Size (in bytes) of the send and receive buffers of the client-server
+  // sockets. 0 means the system defaults. See
+  // vtkTCPNetworkAccessManager::SetSocketBufferSize().
+  vtkGetMacro(SocketBufferSize, int);
+
   // Description:
   // Clients need to set the ConnectID so they can handle server connections
   // after the client has started.
@@ -215,6 +221,7 @@ private:
   int TileMullions[2];
   int UseRenderingGroup;
   int Timeout;
+  int SocketBufferSize;
 
 
   char* RenderModuleName;
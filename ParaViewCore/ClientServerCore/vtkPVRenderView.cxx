@@ -30,6 +30,7 @@
 #include "vtkLight.h"
 #include "vtkLightKit.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkMemberFunctionCommand.h"
 #include "vtkMPIMoveData.h"
 #include "vtkMultiProcessController.h"
@@ -37,10 +38,13 @@
 #include "vtkPVHardwareSelector.h"
 #include "vtkPKdTree.h"
 #include "vtkProcessModule.h"
+#include "vtkProp3D.h"
+#include "vtkPropCollection.h"
 #include "vtkPVAxesWidget.h"
 #include "vtkPVCenterAxesActor.h"
 #include "vtkPVGenericRenderWindowInteractor.h"
 #include "vtkPVInteractorStyle.h"
+#include "vtkPVDataRepresentation.h"
 #include "vtkPVOptions.h"
 #include "vtkPVSynchronizedRenderer.h"
 #include "vtkPVSynchronizedRenderWindows.h"
@@ -59,8 +63,88 @@
 #include "vtkPVDisplayInformation.h"
 
 #include <assert.h>
+#include <vtkstd/algorithm>
 #include <vtkstd/vector>
 #include <vtkstd/set>
+#include <vtkstd/utility>
+
+//----------------------------------------------------------------------------
+class vtkPVRenderView::vtkInternals
+{
+public:
+  // What a gather was computed from: the representations (their visibility
+  // and their MTime, which MarkModified() updates), which are changed on all
+  // processes together, and the props of the renderer with their
+  // transformation, which are not (widgets only exist on some processes).
+  // The MTime of the props cannot be used since rendering may modify them on
+  // some processes only.
+  struct Snapshot
+    {
+    vtkstd::vector<vtkstd::pair<void*, bool> > Representations;
+    vtkstd::vector<void*> Props;
+    vtkstd::vector<double> Matrices;
+    vtkTimeStamp Time;
+    int Mode;
+    bool Valid;
+    Snapshot() : Mode(0), Valid(false) { }
+    };
+
+  Snapshot GeometrySize;
+  Snapshot Bounds;
+
+  // Returns true if the representations (and, when \c renderer is non-null,
+  // the props of the renderer) changed since the snapshot and updates the
+  // snapshot.
+  bool Update(Snapshot& snapshot, vtkPVRenderView* self,
+    vtkRenderer* renderer, int mode)
+    {
+    bool changed = !snapshot.Valid || snapshot.Mode != mode;
+
+    vtkstd::vector<vtkstd::pair<void*, bool> > reprs;
+    for (int cc=0; cc < self->GetNumberOfRepresentations(); cc++)
+      {
+      vtkDataRepresentation* repr = self->GetRepresentation(cc);
+      vtkPVDataRepresentation* pvrepr =
+        vtkPVDataRepresentation::SafeDownCast(repr);
+      reprs.push_back(vtkstd::pair<void*, bool>(repr,
+          pvrepr? pvrepr->GetVisibility() : true));
+      changed = changed || repr->GetMTime() > snapshot.Time;
+      }
+    changed = changed || reprs != snapshot.Representations;
+
+    vtkstd::vector<void*> props;
+    vtkstd::vector<double> matrices;
+    if (renderer)
+      {
+      vtkPropCollection* collection = renderer->GetViewProps();
+      vtkCollectionSimpleIterator pit;
+      collection->InitTraversal(pit);
+      while (vtkProp* prop = collection->GetNextProp(pit))
+        {
+        props.push_back(prop);
+        vtkProp3D* prop3D = vtkProp3D::SafeDownCast(prop);
+        if (prop3D)
+          {
+          double* elements = &prop3D->GetMatrix()->Element[0][0];
+          matrices.insert(matrices.end(), elements, elements + 16);
+          }
+        }
+      changed = changed || props != snapshot.Props ||
+        matrices != snapshot.Matrices;
+      }
+
+    if (changed)
+      {
+      snapshot.Representations = reprs;
+      snapshot.Props = props;
+      snapshot.Matrices = matrices;
+      snapshot.Mode = mode;
+      snapshot.Valid = true;
+      snapshot.Time.Modified();
+      }
+    return changed;
+    }
+};
 
 //----------------------------------------------------------------------------
 // Statics
@@ -75,6 +159,8 @@ vtkInformationKeyMacro(vtkPVRenderView, DELIVER_OUTLINE_TO_CLIENT, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DELIVER_OUTLINE_TO_CLIENT_FOR_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DELIVER_LOD_TO_CLIENT, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, LOD_RESOLUTION, Double);
+vtkInformationKeyMacro(vtkPVRenderView, LOD_LEVEL, Integer);
+vtkInformationKeyMacro(vtkPVRenderView, LOD_NUMBER_OF_LEVELS, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, NEED_ORDERED_COMPOSITING, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, REDISTRIBUTABLE_DATA_PRODUCER, ObjectBase);
 vtkInformationKeyMacro(vtkPVRenderView, KD_TREE, ObjectBase);
@@ -85,6 +171,7 @@ vtkPVRenderView::vtkPVRenderView()
   vtkPVOptions* options = vtkProcessModule::GetProcessModule()->GetOptions();
 
   this->RemoteRenderingAvailable = false;
+  this->Internals = new vtkInternals();
 
   this->UsedLODForLastRender = false;
   this->MakingSelection = false;
@@ -95,6 +182,16 @@ vtkPVRenderView::vtkPVRenderView()
   this->LODRenderingThreshold = 0;
   this->ClientOutlineThreshold = 5;
   this->LODResolution = 0.5;
+  this->NumberOfLODLevels = 3;
+  this->TargetFrameRate = 0;
+  this->MaximumInteractiveRenderImageReductionFactor = 8;
+  this->LODLevel = 0;
+  this->AdaptiveImageReductionFactor = 2;
+  this->LastFrameTime = 0;
+  this->LastDeliveryTime = 0;
+  this->LastRenderTime = 0;
+  this->AverageFrameTime = 0;
+  this->SmoothedFrameTime = 0;
   this->UseLightKit = false;
   this->Interactor = 0;
   this->InteractorStyle = 0;
@@ -224,6 +321,8 @@ vtkPVRenderView::~vtkPVRenderView()
 
   this->SetLastSelection(NULL);
   this->Selector->Delete();
+  delete this->Internals;
+  this->Internals = NULL;
   this->SynchronizedRenderers->Delete();
   this->NonCompositedRenderer->Delete();
   this->RenderView->Delete();
@@ -547,6 +646,29 @@ void vtkPVRenderView::GatherBoundsInformation(
   this->ResetCameraClippingRange();
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateBoundsInformation(bool using_distributed_rendering)
+{
+  // The props differ between processes, hence all processes must agree on
+  // whether something changed before taking part in the gather.
+  unsigned int changed = this->Internals->Update(this->Internals->Bounds,
+    this, this->GetRenderer(), using_distributed_rendering? 1 : 0)? 1 : 0;
+  this->SynchronizedWindows->SynchronizeSize(changed);
+  if (changed > 0)
+    {
+    this->GatherBoundsInformation(using_distributed_rendering);
+    this->UpdateCenterAxes(this->LastComputedBounds);
+
+    // updating the center axes moves a prop, don't count that as a change.
+    this->Internals->Update(this->Internals->Bounds, this,
+      this->GetRenderer(), using_distributed_rendering? 1 : 0);
+    }
+  else
+    {
+    this->ResetCameraClippingRange();
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVRenderView::GetLocalProcessDoesRendering(bool using_distributed_rendering)
 {
@@ -611,6 +733,7 @@ void vtkPVRenderView::InteractiveRender()
 //----------------------------------------------------------------------------
 void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
 {
+  double frame_start = vtkTimerLog::GetUniversalTime();
   if (!interactive)
     {
     // Update all representations.
@@ -622,12 +745,23 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     this->GatherRepresentationInformation();
 
     // Gather information about geometry sizes from all representations.
-    this->GatherGeometrySizeInformation();
+    this->UpdateGeometrySizeInformation();
     }
 
   // Use loss-less image compression for client-server for full-res renders.
   this->SynchronizedRenderers->SetLossLessCompression(!interactive);
 
+  if (interactive)
+    {
+    this->UpdateAdaptiveRenderParameters();
+    }
+  else
+    {
+    // the next interaction starts with the parameters used by the previous
+    // one, no measurement is carried over.
+    this->LastFrameTime = 0;
+    }
+
   bool use_lod_rendering = interactive? this->GetUseLODRendering() : false;
   this->SetRequestLODRendering(use_lod_rendering);
 
@@ -719,20 +853,19 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
   this->CallProcessViewRequest(
     vtkPVView::REQUEST_RENDER(),
     this->RequestInformation, this->ReplyInformationVector);
+  double delivery_time = vtkTimerLog::GetUniversalTime() - frame_start;
 
   // set the image reduction factor.
   this->SynchronizedRenderers->SetImageReductionFactor(
     (interactive?
-     this->InteractiveRenderImageReductionFactor :
+     this->AdaptiveImageReductionFactor :
      this->StillRenderImageReductionFactor));
 
   if (!interactive)
     {
-    // Keep bounds information up-to-date.
-    // FIXME: How can be make this so that we don't have to do parallel
-    // communication each time.
-    this->GatherBoundsInformation(use_distributed_rendering);
-    this->UpdateCenterAxes(this->LastComputedBounds);
+    // Keep bounds information up-to-date. The parallel communication is only
+    // done when something changed since the last time.
+    this->UpdateBoundsInformation(use_distributed_rendering);
     }
 
   this->UsedLODForLastRender = use_lod_rendering;
@@ -755,7 +888,91 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     (!this->SynchronizedWindows->GetRenderEventPropagation() &&
      use_distributed_rendering))
     {
+    double render_start = vtkTimerLog::GetUniversalTime();
     this->GetRenderWindow()->Render();
+    if (interactive && this->SynchronizedWindows->GetLocalProcessIsDriver())
+      {
+      double now = vtkTimerLog::GetUniversalTime();
+      this->LastDeliveryTime = delivery_time;
+      this->LastRenderTime = now - render_start;
+      this->LastFrameTime = now - frame_start;
+      this->AverageFrameTime = this->AverageFrameTime > 0?
+        0.8 * this->AverageFrameTime + 0.2 * this->LastFrameTime :
+        this->LastFrameTime;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkPVRenderView::GetAverageFrameRate()
+{
+  return this->AverageFrameTime > 0? 1.0 / this->AverageFrameTime : 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateAdaptiveRenderParameters()
+{
+  if (this->TargetFrameRate <= 0)
+    {
+    this->LODLevel = 0;
+    this->AdaptiveImageReductionFactor =
+      this->InteractiveRenderImageReductionFactor;
+    this->SmoothedFrameTime = 0;
+    return;
+    }
+
+  // Only the driver measures the frame time, the other processes contribute
+  // 0 so that the sum is the driver's time everywhere and all processes make
+  // the same decision.
+  double frame_time = this->LastFrameTime;
+  this->SynchronizedWindows->SynchronizeSize(frame_time);
+
+  int min_factor = this->InteractiveRenderImageReductionFactor;
+  int max_factor = vtkstd::max(min_factor,
+    this->MaximumInteractiveRenderImageReductionFactor);
+  int max_level = this->NumberOfLODLevels - 1;
+  this->AdaptiveImageReductionFactor = vtkstd::max(min_factor,
+    vtkstd::min(this->AdaptiveImageReductionFactor, max_factor));
+  this->LODLevel = vtkstd::max(0, vtkstd::min(this->LODLevel, max_level));
+  if (frame_time <= 0)
+    {
+    // first frame of an interaction: nothing measured yet.
+    this->SmoothedFrameTime = 0;
+    return;
+    }
+
+  // Smooth the measurements to avoid oscillating between two settings.
+  this->SmoothedFrameTime = this->SmoothedFrameTime > 0?
+    0.5 * (this->SmoothedFrameTime + frame_time) : frame_time;
+
+  double target_time = 1.0 / this->TargetFrameRate;
+  bool use_lod = this->GetUseLODRendering();
+  // Image reduction has no effect when rendering locally.
+  bool use_image_reduction = this->GetUseDistributedRendering();
+  if (this->SmoothedFrameTime > target_time)
+    {
+    // Too slow: reduce the image first, since changing the level of detail
+    // requires delivering new geometry.
+    if (use_image_reduction && this->AdaptiveImageReductionFactor < max_factor)
+      {
+      this->AdaptiveImageReductionFactor++;
+      }
+    else if (use_lod && this->LODLevel < max_level)
+      {
+      this->LODLevel++;
+      }
+    }
+  else if (this->SmoothedFrameTime < 0.5 * target_time)
+    {
+    // Fast enough: restore the level of detail first, then the image.
+    if (use_lod && this->LODLevel > 0)
+      {
+      this->LODLevel--;
+      }
+    else if (this->AdaptiveImageReductionFactor > min_factor)
+      {
+      this->AdaptiveImageReductionFactor--;
+      }
     }
 }
 
@@ -792,11 +1009,16 @@ void vtkPVRenderView::SetRequestLODRendering(bool enable)
     {
     this->RequestInformation->Set(USE_LOD(), 1);
     this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+    this->RequestInformation->Set(LOD_LEVEL(), this->LODLevel);
+    this->RequestInformation->Set(LOD_NUMBER_OF_LEVELS(),
+      this->NumberOfLODLevels);
     }
   else
     {
     this->RequestInformation->Remove(USE_LOD());
     this->RequestInformation->Remove(LOD_RESOLUTION());
+    this->RequestInformation->Remove(LOD_LEVEL());
+    this->RequestInformation->Remove(LOD_NUMBER_OF_LEVELS());
     }
 }
 
@@ -863,6 +1085,15 @@ void vtkPVRenderView::GatherGeometrySizeInformation()
   this->SynchronizedWindows->SynchronizeSize(this->GeometrySize);
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::UpdateGeometrySizeInformation()
+{
+  if (this->Internals->Update(this->Internals->GeometrySize, this, NULL, 0))
+    {
+    this->GatherGeometrySizeInformation();
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVRenderView::GetUseDistributedRendering()
 {
@@ -1021,6 +1252,17 @@ void vtkPVRenderView::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "UseLightKit: " << this->UseLightKit << endl;
+  os << indent << "NumberOfLODLevels: " << this->NumberOfLODLevels << endl;
+  os << indent << "TargetFrameRate: " << this->TargetFrameRate << endl;
+  os << indent << "MaximumInteractiveRenderImageReductionFactor: "
+     << this->MaximumInteractiveRenderImageReductionFactor << endl;
+  os << indent << "LODLevel: " << this->LODLevel << endl;
+  os << indent << "AdaptiveImageReductionFactor: "
+     << this->AdaptiveImageReductionFactor << endl;
+  os << indent << "LastFrameTime: " << this->LastFrameTime << endl;
+  os << indent << "LastDeliveryTime: " << this->LastDeliveryTime << endl;
+  os << indent << "LastRenderTime: " << this->LastRenderTime << endl;
+  os << indent << "AverageFrameRate: " << this->GetAverageFrameRate() << endl;
 }
 
 //----------------------------------------------------------------------------
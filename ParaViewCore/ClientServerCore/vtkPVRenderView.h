@@ -205,6 +205,56 @@ public:
   vtkSetClampMacro(LODResolution, double, 0.0, 1.0);
   vtkGetMacro(LODResolution, double);
 
+  // Description:
+  // Get/Set the number of levels of detail representations should prepare.
+  // The finest level uses LODResolution, every following level is coarser.
+  // Default is 3.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(NumberOfLODLevels, int, 1, 8);
+  vtkGetMacro(NumberOfLODLevels, int);
+
+  // Description:
+  // Get/Set the frame rate, in frames per second, interactive renders should
+  // achieve. When greater than 0, the view measures every interactive frame
+  // (data delivery, rendering, compositing and image delivery) and adjusts
+  // the image reduction factor and the level of detail of the next ones:
+  // when frames are too slow, the image reduction factor is increased first
+  // when rendering remotely and the level of detail is coarsened otherwise or
+  // once the factor reached MaximumInteractiveRenderImageReductionFactor; when
+  // frames are fast enough, they are restored in the reverse order. The image
+  // reduction factor never goes below InteractiveRenderImageReductionFactor.
+  // When 0, InteractiveRenderImageReductionFactor and the finest level of
+  // detail are always used. Default is 0.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(TargetFrameRate, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(TargetFrameRate, double);
+
+  // Description:
+  // Get/Set the largest image reduction factor TargetFrameRate may use.
+  // Default is 8.
+  // @CallOnAllProcessess
+  vtkSetClampMacro(MaximumInteractiveRenderImageReductionFactor, int, 1, 20);
+  vtkGetMacro(MaximumInteractiveRenderImageReductionFactor, int);
+
+  // Description:
+  // Returns the level of detail and the image reduction factor used by the
+  // most recent interactive render.
+  vtkGetMacro(LODLevel, int);
+  vtkGetMacro(AdaptiveImageReductionFactor, int);
+
+  // Description:
+  // Statistics about the most recent interactive render, in seconds. These
+  // are only measured on the driver process (the client in client-server
+  // mode). LastFrameTime is the duration of the whole frame,
+  // LastDeliveryTime the part spent preparing the representations (which
+  // includes moving the geometry) and LastRenderTime the part spent rendering,
+  // compositing and delivering the image. AverageFrameRate is a running
+  // average of the interactive frame rate.
+  vtkGetMacro(LastFrameTime, double);
+  vtkGetMacro(LastDeliveryTime, double);
+  vtkGetMacro(LastRenderTime, double);
+  double GetAverageFrameRate();
+
   // Description:
   // This threshold is only applicable when in client-server mode. It is the size
   // of geometry in megabytes beyond which the view should not deliver geometry
@@ -264,6 +314,11 @@ public:
   static vtkInformationIntegerKey* DELIVER_OUTLINE_TO_CLIENT_FOR_LOD();
   static vtkInformationDoubleKey* LOD_RESOLUTION();
 
+  // LOD_LEVEL is the level of detail to use when USE_LOD is set, 0 being the
+  // finest, and LOD_NUMBER_OF_LEVELS the number of levels to prepare.
+  static vtkInformationIntegerKey* LOD_LEVEL();
+  static vtkInformationIntegerKey* LOD_NUMBER_OF_LEVELS();
+
   // Description:
   // This view supports ordered compositing, if needed. When ordered compositing
   // needs to be employed, this view requires that all representations
@@ -449,6 +504,19 @@ protected:
   // @CallOnAllProcessess
   void GatherBoundsInformation(bool using_remote_rendering);
 
+  // Description:
+  // Same as GatherGeometrySizeInformation() and GatherBoundsInformation() but
+  // the parallel reduction is skipped, and the previous result kept, when no
+  // representation or prop was added, removed, shown, hidden or modified
+  // since the last reduction. Representations are modified on all processes
+  // together (through their proxies), so the geometry size is decided
+  // locally. Props are not (e.g. widgets only exist on the client and the
+  // render-server), so the processes agree on whether the bounds changed
+  // before gathering them.
+  // @CallOnAllProcessess
+  void UpdateGeometrySizeInformation();
+  void UpdateBoundsInformation(bool using_remote_rendering);
+
   // Description:
   // Returns true if distributed rendering should be used.
   bool GetUseDistributedRendering();
@@ -478,6 +546,13 @@ protected:
   // Update the request to enable/disable low-res rendering.
   void SetRequestLODRendering(bool);
 
+  // Description:
+  // Picks the level of detail and image reduction factor for the next
+  // interactive render from the time taken by the previous ones on the driver
+  // process.
+  // @CallOnAllProcessess
+  void UpdateAdaptiveRenderParameters();
+
   // Description:
   // Set the last selection object.
   void SetLastSelection(vtkSelection*);
@@ -522,6 +597,21 @@ protected:
   bool UseInteractiveRenderingForSceenshots;
 
   double LODResolution;
+  int NumberOfLODLevels;
+  double TargetFrameRate;
+  int MaximumInteractiveRenderImageReductionFactor;
+  int LODLevel;
+  int AdaptiveImageReductionFactor;
+
+  // Interactive render statistics, on the driver process only.
+  double LastFrameTime;
+  double LastDeliveryTime;
+  double LastRenderTime;
+  double AverageFrameTime;
+
+  // Frame time the adaptive parameters are based on, identical on all
+  // processes.
+  double SmoothedFrameTime;
   bool UseLightKit;
 
   bool UsedLODForLastRender;
@@ -540,6 +630,9 @@ private:
   // This flag is set to false when not all processes cannot render e.g. cannot
   // open the DISPLAY etc.
   bool RemoteRenderingAvailable;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 //ETX
 };
 
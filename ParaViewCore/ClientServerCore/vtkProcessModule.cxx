@@ -403,6 +403,12 @@ void vtkProcessModule::SetOptions(vtkPVOptions* options)
     {
     this->SetSymmetricMPIMode(
       options->GetSymmetricMPIMode() != 0);
+    vtkTCPNetworkAccessManager* nam =
+      vtkTCPNetworkAccessManager::SafeDownCast(this->NetworkAccessManager);
+    if (nam && options->GetSocketBufferSize() > 0)
+      {
+      nam->SetSocketBufferSize(options->GetSocketBufferSize());
+      }
     }
 }
 
@@ -37,6 +37,7 @@
 #include "vtkVariant.h"
 
 #include <vtkstd/map>
+#include <vtkstd/string>
 
 class vtkSpreadSheetView::vtkInternals
 {
@@ -136,6 +137,24 @@ namespace
     {
     }
 
+  void ExportRMI(void *localArg,
+    void *remoteArg, int remoteArgLength, int)
+    {
+    vtkMultiProcessStream stream;
+    stream.SetRawData(
+      reinterpret_cast<unsigned char*>(remoteArg), remoteArgLength);
+    unsigned int id = 0;
+    int numBlocks = 0;
+    vtkstd::string filename, delimiter;
+    stream >> id >> numBlocks >> filename >> delimiter;
+    vtkSpreadSheetView* self =
+      reinterpret_cast<vtkSpreadSheetView*>(localArg);
+    if (self->GetIdentifier() == id)
+      {
+      self->ExportCallback(numBlocks, filename.c_str(), delimiter.c_str());
+      }
+    }
+
   unsigned long vtkCountNumberOfRows(vtkDataObject* dobj)
     {
     vtkTable* table = vtkTable::SafeDownCast(dobj);
@@ -231,6 +250,10 @@ vtkSpreadSheetView::vtkSpreadSheetView()
     this->RMICallbackTag = this->SynchronizedWindows->AddRMICallback(
       ::FetchRMIBogus, this, FETCH_BLOCK_TAG);
     }
+  // The render-server does not write anything, but the client waits for its
+  // part of the SynchronizeSize() ending the export (see ExportCallback()).
+  this->ExportRMICallbackTag = this->SynchronizedWindows->AddRMICallback(
+    ::ExportRMI, this, EXPORT_TAG);
 }
 
 //----------------------------------------------------------------------------
@@ -238,6 +261,8 @@ vtkSpreadSheetView::~vtkSpreadSheetView()
 {
   this->SynchronizedWindows->RemoveRMICallback(this->RMICallbackTag);
   this->RMICallbackTag = 0;
+  this->SynchronizedWindows->RemoveRMICallback(this->ExportRMICallbackTag);
+  this->ExportRMICallbackTag = 0;
 
   this->TableStreamer->Delete();
   this->TableSelectionMarker->Delete();
@@ -480,16 +505,42 @@ bool vtkSpreadSheetView::IsAvailable(vtkIdType row)
 //----------------------------------------------------------------------------
 bool vtkSpreadSheetView::Export(vtkCSVExporter* exporter)
 {
+  vtkIdType blockSize = this->TableStreamer->GetBlockSize();
+  vtkIdType numBlocks = (this->GetNumberOfRows() / blockSize) + 1;
+
+  if (exporter->GetWriteOnServer() &&
+    this->SynchronizedWindows->GetMode() == vtkPVSynchronizedRenderWindows::CLIENT)
+    {
+    // Let the server stream the blocks straight to disk, then learn whether
+    // it could write the file.
+    vtkMultiProcessStream stream;
+    stream << this->Identifier << static_cast<int>(numBlocks)
+           << vtkstd::string(exporter->GetFileName()? exporter->GetFileName() : "")
+           << vtkstd::string(exporter->GetFieldDelimiter()?
+                exporter->GetFieldDelimiter() : "");
+    this->SynchronizedWindows->TriggerRMI(stream, EXPORT_TAG);
+    unsigned int written = 0;
+    this->SynchronizedWindows->SynchronizeSize(written);
+    return written > 0;
+    }
+
   if (!exporter->Open())
     {
     return false;
     }
 
-  vtkIdType blockSize = this->TableStreamer->GetBlockSize();
-  vtkIdType numBlocks = (this->GetNumberOfRows() / blockSize) + 1;
+  // Blocks are fetched directly rather than through FetchBlock() so that
+  // exporting does not evict the blocks cached for display nor fire an
+  // UpdateEvent per block.
   for (vtkIdType cc=0; cc < numBlocks; cc++)
     {
-    vtkTable* block = this->FetchBlock(cc);
+    this->FetchBlockCallback(cc);
+    vtkTable* block = vtkTable::SafeDownCast(
+      this->DeliveryFilter->GetOutputDataObject(0));
+    if (!block)
+      {
+      continue;
+      }
     if (cc==0)
       {
       exporter->WriteHeader(block->GetRowData());
@@ -500,6 +551,68 @@ bool vtkSpreadSheetView::Export(vtkCSVExporter* exporter)
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::ExportCallback(vtkIdType numBlocks,
+  const char* filename, const char* delimiter)
+{
+  // Forward the request to the satellites, the reduction is collective.
+  vtkMultiProcessStream stream;
+  stream << this->Identifier << static_cast<int>(numBlocks)
+         << vtkstd::string(filename) << vtkstd::string(delimiter);
+  this->SynchronizedWindows->TriggerRMI(stream, EXPORT_TAG);
+
+  // Number of processes that wrote the file (the root one, at most), summed
+  // over all processes and sent to the client by SynchronizeSize(). The
+  // render-server only takes part in that sum.
+  unsigned int written = 0;
+  if (!this->Internals->ActiveRepresentation ||
+    vtkProcessModule::GetProcessType() ==
+    vtkProcessModule::PROCESS_RENDER_SERVER)
+    {
+    this->SynchronizedWindows->SynchronizeSize(written);
+    return;
+    }
+
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  bool isRoot = (!controller || controller->GetLocalProcessId() == 0);
+
+  vtkSmartPointer<vtkCSVExporter> exporter =
+    vtkSmartPointer<vtkCSVExporter>::New();
+  exporter->SetFileName(filename);
+  exporter->SetFieldDelimiter(delimiter);
+  if (isRoot && !exporter->Open())
+    {
+    isRoot = false;
+    }
+
+  this->TableSelectionMarker->SetFieldAssociation(
+    this->Internals->ActiveRepresentation->GetFieldAssociation());
+  for (vtkIdType cc=0; cc < numBlocks; cc++)
+    {
+    this->TableStreamer->SetBlock(cc);
+    this->TableStreamer->Modified();
+    this->ReductionFilter->Modified();
+    this->ReductionFilter->Update();
+    vtkTable* block = vtkTable::SafeDownCast(
+      this->ReductionFilter->GetOutputDataObject(0));
+    if (isRoot && block)
+      {
+      if (cc==0)
+        {
+        exporter->WriteHeader(block->GetRowData());
+        }
+      exporter->WriteData(block->GetRowData());
+      }
+    }
+  if (isRoot)
+    {
+    exporter->Close();
+    written = 1;
+    }
+  this->SynchronizedWindows->SynchronizeSize(written);
+}
+
 //***************************************************************************
 // Forwarded to vtkSortedTableStreamer.
 //----------------------------------------------------------------------------
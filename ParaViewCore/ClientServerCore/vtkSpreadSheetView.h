@@ -117,13 +117,20 @@ public:
   void SetBlockSize(vtkIdType val);
 
   // Description:
-  // Export the contents of this view using the exporter.
+  // Export the contents of this view using the exporter. The data is streamed
+  // one block at a time. If the exporter's WriteOnServer flag is set and the
+  // data lives on a remote server, the server writes the file instead and no
+  // data is sent to the client.
   bool Export(vtkCSVExporter* exporter);
 
 //BTX
   // INTERNAL METHOD. Don't call directly.
   void FetchBlockCallback(vtkIdType blockindex);
 
+  // INTERNAL METHOD. Don't call directly.
+  void ExportCallback(vtkIdType numBlocks, const char* filename,
+    const char* delimiter);
+
 protected:
   vtkSpreadSheetView();
   ~vtkSpreadSheetView();
@@ -152,7 +159,8 @@ protected:
 
   enum
     {
-    FETCH_BLOCK_TAG = 394732
+    FETCH_BLOCK_TAG = 394732,
+    EXPORT_TAG = 394733
     };
 private:
   vtkSpreadSheetView(const vtkSpreadSheetView&); // Not implemented
@@ -165,6 +173,7 @@ private:
   bool SomethingUpdated;
 
   unsigned long RMICallbackTag;
+  unsigned long ExportRMICallbackTag;
 //ETX
 };
 
@@ -30,12 +30,24 @@
 #include <vtkstd/vector>
 #include <vtkstd/map>
 
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <winsock2.h>
+#else
+# include <sys/types.h>
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+#endif
 
 class vtkTCPNetworkAccessManager::vtkInternals
 {
 public:
-  typedef vtkstd::vector<vtkWeakPointer<vtkSocketController> >
-    VectorOfControllers;
+  struct ControllerInfo
+    {
+    vtkWeakPointer<vtkSocketController> Controller;
+    int CompressionThreshold;
+    };
+  typedef vtkstd::vector<ControllerInfo> VectorOfControllers;
   VectorOfControllers Controllers;
   typedef vtkstd::map<int, vtkSmartPointer<vtkServerSocket> >
     MapToServerSockets;
@@ -48,6 +60,13 @@ vtkTCPNetworkAccessManager::vtkTCPNetworkAccessManager()
 {
   this->Internals = new vtkInternals();
   this->AbortPendingConnectionFlag = false;
+  this->SocketBufferSize = 0;
+  this->CompressionThreshold = 0;
+  if (const char* threshold =
+    vtksys::SystemTools::GetEnv("PV_COMPRESSION_THRESHOLD"))
+    {
+    this->CompressionThreshold = atoi(threshold);
+    }
 
   // It's essential to initialize the socket controller to initialize sockets on
   // Windows.
@@ -146,7 +165,7 @@ int vtkTCPNetworkAccessManager::ProcessEvents(unsigned long timeout_msecs)
   for (iter1 = this->Internals->Controllers.begin();
     iter1 != this->Internals->Controllers.end(); ++iter1)
     {
-    vtkSocketController* controller = iter1->GetPointer();
+    vtkSocketController* controller = iter1->Controller.GetPointer();
     if (!controller)
       {
       // skip null controllers.
@@ -262,7 +281,9 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::ConnectToRemote(
     vtkErrorMacro("Failed to connect to " << hostname << ":" << port);
     return NULL;
     }
-  this->Internals->Controllers.push_back(controller);
+  this->TuneSocket(controller);
+  this->AddController(controller,
+    this->NegotiateCompression(controller, false));
   return controller;
 }
 
@@ -330,7 +351,9 @@ vtkMultiProcessController* vtkTCPNetworkAccessManager::WaitForConnection(
 
   if (controller)
     {
-    this->Internals->Controllers.push_back(controller);
+    this->TuneSocket(controller);
+    this->AddController(controller,
+      this->NegotiateCompression(controller, true));
     }
 
   if (once)
@@ -382,8 +405,96 @@ bool vtkTCPNetworkAccessManager::ParaViewHandshake(
     }
 }
 
+//----------------------------------------------------------------------------
+int vtkTCPNetworkAccessManager::NegotiateCompression(
+  vtkMultiProcessController* controller, bool server_side)
+{
+  if (server_side)
+    {
+    int proposed = 0;
+    controller->Receive(&proposed, 1, 1, 99993);
+    int threshold = 0;
+    if (proposed > 0 && this->CompressionThreshold >= 0)
+      {
+      threshold = proposed > this->CompressionThreshold?
+        proposed : this->CompressionThreshold;
+      }
+    controller->Send(&threshold, 1, 1, 99992);
+    return threshold;
+    }
+  else
+    {
+    int proposed = this->CompressionThreshold > 0?
+      this->CompressionThreshold : 0;
+    controller->Send(&proposed, 1, 1, 99993);
+    int threshold = 0;
+    controller->Receive(&threshold, 1, 1, 99992);
+    return threshold;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTCPNetworkAccessManager::TuneSocket(vtkSocketController* controller)
+{
+  vtkSocketCommunicator* comm = vtkSocketCommunicator::SafeDownCast(
+    controller->GetCommunicator());
+  vtkSocket* socket = comm? comm->GetSocket() : NULL;
+  if (!socket || !socket->GetConnected())
+    {
+    return;
+    }
+
+  int sock = socket->GetSocketDescriptor();
+  int on = 1;
+  if (setsockopt(sock, IPPROTO_TCP, TCP_NODELAY,
+      reinterpret_cast<char*>(&on), sizeof(on)))
+    {
+    vtkWarningMacro("Failed to set TCP_NODELAY.");
+    }
+  if (this->SocketBufferSize > 0)
+    {
+    int size = this->SocketBufferSize;
+    if (setsockopt(sock, SOL_SOCKET, SO_SNDBUF,
+        reinterpret_cast<char*>(&size), sizeof(size)) ||
+      setsockopt(sock, SOL_SOCKET, SO_RCVBUF,
+        reinterpret_cast<char*>(&size), sizeof(size)))
+      {
+      vtkWarningMacro("Failed to set socket buffer size to " << size << ".");
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTCPNetworkAccessManager::AddController(
+  vtkSocketController* controller, int threshold)
+{
+  vtkInternals::ControllerInfo info;
+  info.Controller = controller;
+  info.CompressionThreshold = threshold;
+  this->Internals->Controllers.push_back(info);
+}
+
+//----------------------------------------------------------------------------
+int vtkTCPNetworkAccessManager::GetNegotiatedCompressionThreshold(
+  vtkMultiProcessController* controller)
+{
+  vtkInternals::VectorOfControllers::iterator iter;
+  for (iter = this->Internals->Controllers.begin();
+    iter != this->Internals->Controllers.end(); ++iter)
+    {
+    if (controller != NULL && iter->Controller.GetPointer() == controller)
+      {
+      return iter->CompressionThreshold;
+      }
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkTCPNetworkAccessManager::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CompressionThreshold: " << this->CompressionThreshold
+    << endl;
+  os << indent << "SocketBufferSize: " << this->SocketBufferSize << endl;
 }
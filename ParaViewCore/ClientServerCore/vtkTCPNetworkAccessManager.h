@@ -24,6 +24,7 @@
 #include "vtkNetworkAccessManager.h"
 
 class vtkMultiProcessController;
+class vtkSocketController;
 
 class VTK_EXPORT vtkTCPNetworkAccessManager : public vtkNetworkAccessManager
 {
@@ -78,6 +79,29 @@ public:
   // Returns true is the manager is currently waiting for any connections.
   virtual bool GetPendingConnectionsPresent();
 
+  // Description:
+  // Size (in bytes) above which messages are compressed on the connections
+  // created after this is set. It is negotiated during the handshake: the
+  // connecting side proposes its threshold and the listening side accepts it
+  // (using the larger of both if it has one itself) unless its own value is
+  // negative. 0 disables compression on the connecting side. Initialized from
+  // the PV_COMPRESSION_THRESHOLD environment variable, if set, else 0.
+  vtkSetMacro(CompressionThreshold, int);
+  vtkGetMacro(CompressionThreshold, int);
+
+  // Description:
+  // Returns the compression threshold agreed upon for the connection.
+  virtual int GetNegotiatedCompressionThreshold(
+    vtkMultiProcessController* controller);
+
+  // Description:
+  // Size (in bytes) of the send and receive buffers of the sockets created
+  // after this is set. 0 (default) keeps the system defaults. Larger buffers
+  // help keeping high latency links busy. vtkProcessModule sets it from the
+  // --socket-buffer-size command line option.
+  vtkSetMacro(SocketBufferSize, int);
+  vtkGetMacro(SocketBufferSize, int);
+
 //BTX
 protected:
   vtkTCPNetworkAccessManager();
@@ -96,7 +120,24 @@ protected:
   bool ParaViewHandshake(vtkMultiProcessController* controller,
     bool server_side, const char* handshake);
 
+  // Description:
+  // Agree on the compression threshold with the other end. Called once the
+  // handshake succeeded. Returns the threshold to use for the connection.
+  int NegotiateCompression(vtkMultiProcessController* controller,
+    bool server_side);
+
+  // Description:
+  // Disables Nagle's algorithm on the connected socket, so that small
+  // requests are not delayed, and applies SocketBufferSize.
+  void TuneSocket(vtkSocketController* controller);
+
+  // Description:
+  // Keeps track of a new connection.
+  void AddController(vtkSocketController* controller, int threshold);
+
   bool AbortPendingConnectionFlag;
+  int CompressionThreshold;
+  int SocketBufferSize;
 private:
   vtkTCPNetworkAccessManager(const vtkTCPNetworkAccessManager&); // Not implemented
   void operator=(const vtkTCPNetworkAccessManager&); // Not implemented
@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    BenchmarkPVXMLParser.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Times the parsing of the XML files given on the command line (typically the
+// proxy definitions) by vtkPVXMLParser, building the whole element tree and
+// in streaming mode.
+
+#include "vtkCommand.h"
+#include "vtkPVXMLElement.h"
+#include "vtkPVXMLParser.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <stdlib.h>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+#include <vtksys/ios/sstream>
+
+namespace
+{
+  // Counts the streamed elements.
+  class ElementCounter : public vtkCommand
+  {
+  public:
+    static ElementCounter* New() { return new ElementCounter(); }
+    virtual void Execute(vtkObject*, unsigned long, void*)
+      {
+      this->Count++;
+      }
+    unsigned long Count;
+  protected:
+    ElementCounter() { this->Count = 0; }
+  };
+
+  // Returns the number of elements of the tree.
+  unsigned long CountElements(vtkPVXMLElement* element)
+    {
+    unsigned long count = 1;
+    for (unsigned int cc=0; cc < element->GetNumberOfNestedElements(); cc++)
+      {
+      count += CountElements(element->GetNestedElement(cc));
+      }
+    return count;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    cerr << "Usage: " << argv[0] << " [-n iterations] file.xml ..." << endl;
+    return EXIT_FAILURE;
+    }
+
+  int iterations = 10;
+  vtkstd::vector<vtkstd::string> contents;
+  for (int cc=1; cc < argc; cc++)
+    {
+    if (vtkstd::string(argv[cc]) == "-n" && cc+1 < argc)
+      {
+      iterations = atoi(argv[++cc]);
+      continue;
+      }
+    ifstream file(argv[cc]);
+    if (!file)
+      {
+      cerr << "Cannot read " << argv[cc] << endl;
+      return EXIT_FAILURE;
+      }
+    vtksys_ios::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents.push_back(buffer.str());
+    }
+
+  // Whole element tree.
+  unsigned long numberOfElements = 0;
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  timer->StartTimer();
+  for (int iter=0; iter < iterations; iter++)
+    {
+    numberOfElements = 0;
+    for (size_t cc=0; cc < contents.size(); cc++)
+      {
+      vtkSmartPointer<vtkPVXMLParser> parser =
+        vtkSmartPointer<vtkPVXMLParser>::New();
+      if (!parser->Parse(contents[cc].c_str()))
+        {
+        cerr << "Failed to parse file #" << cc << endl;
+        return EXIT_FAILURE;
+        }
+      numberOfElements += CountElements(parser->GetRootElement());
+      }
+    }
+  timer->StopTimer();
+  double treeTime = timer->GetElapsedTime() / iterations;
+
+  // Streaming, the children of the root element being discarded as soon as
+  // they are parsed.
+  unsigned long numberOfStreamedElements = 0;
+  timer->StartTimer();
+  for (int iter=0; iter < iterations; iter++)
+    {
+    numberOfStreamedElements = 0;
+    for (size_t cc=0; cc < contents.size(); cc++)
+      {
+      vtkSmartPointer<vtkPVXMLParser> parser =
+        vtkSmartPointer<vtkPVXMLParser>::New();
+      vtkSmartPointer<ElementCounter> counter =
+        vtkSmartPointer<ElementCounter>::New();
+      parser->AddObserver(vtkPVXMLParser::ElementParsedEvent, counter);
+      parser->SetStreamingDepth(1);
+      parser->DiscardStreamedElementsOn();
+      if (!parser->Parse(contents[cc].c_str()))
+        {
+        cerr << "Failed to parse file #" << cc << endl;
+        return EXIT_FAILURE;
+        }
+      numberOfStreamedElements += counter->Count;
+      }
+    }
+  timer->StopTimer();
+  double streamingTime = timer->GetElapsedTime() / iterations;
+
+  cout << "Parsed " << contents.size() << " files, " << numberOfElements
+       << " elements" << endl;
+  cout << "  element tree: " << treeTime * 1000.0 << " ms" << endl;
+  cout << "  streaming:    " << streamingTime * 1000.0 << " ms ("
+       << numberOfStreamedElements << " top-level elements)" << endl;
+  return (numberOfElements > 0)? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -20,6 +20,7 @@
 
 vtkStandardNewMacro(vtkPVXMLElement);
 
+#include <vtkstd/set>
 #include <vtkstd/string>
 #include <vtkstd/vector>
 #include <vtksys/ios/sstream>
@@ -30,9 +31,80 @@ vtkStandardNewMacro(vtkPVXMLElement);
 # define SNPRINTF snprintf
 #endif
 
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Attribute names are interned: configuration and state files use the same
+  // few dozens of names over and over, so each element only keeps a pointer
+  // to the shared copy instead of allocating its own. Two interned names are
+  // equal iff their pointers are.
+  const char* vtkPVXMLElementInternName(const char* name)
+    {
+    static vtkstd::set<vtkstd::string> names;
+    return names.insert(name).first->c_str();
+    }
+
+  //----------------------------------------------------------------------------
+  // Helpers for WriteBinary()/ReadBinary(). Strings are stored as their
+  // length followed by their characters, a length of ~0 standing for NULL.
+  const vtkTypeUInt32 vtkPVXMLElementNullString = ~static_cast<vtkTypeUInt32>(0);
+
+  void vtkPVXMLElementWriteUInt32(vtkStdString& buffer, vtkTypeUInt32 value)
+    {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+  void vtkPVXMLElementWriteString(vtkStdString& buffer, const char* value,
+    size_t length)
+    {
+    if (!value)
+      {
+      vtkPVXMLElementWriteUInt32(buffer, vtkPVXMLElementNullString);
+      return;
+      }
+    vtkPVXMLElementWriteUInt32(buffer, static_cast<vtkTypeUInt32>(length));
+    buffer.append(value, length);
+    }
+
+  bool vtkPVXMLElementReadUInt32(const char*& data, const char* end,
+    vtkTypeUInt32& value)
+    {
+    if (end - data < static_cast<ptrdiff_t>(sizeof(value)))
+      {
+      return false;
+      }
+    memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+    return true;
+    }
+
+  // On success, \c value points inside the buffer (or is NULL).
+  bool vtkPVXMLElementReadString(const char*& data, const char* end,
+    const char*& value, vtkTypeUInt32& length)
+    {
+    if (!vtkPVXMLElementReadUInt32(data, end, length))
+      {
+      return false;
+      }
+    if (length == vtkPVXMLElementNullString)
+      {
+      value = NULL;
+      length = 0;
+      return true;
+      }
+    if (static_cast<vtkTypeUInt32>(end - data) < length)
+      {
+      return false;
+      }
+    value = data;
+    data += length;
+    return true;
+    }
+};
+
 struct vtkPVXMLElementInternals
 {
-  vtkstd::vector<vtkstd::string> AttributeNames;
+  vtkstd::vector<const char*> AttributeNames;
   vtkstd::vector<vtkstd::string> AttributeValues;
   typedef vtkstd::vector<vtkSmartPointer<vtkPVXMLElement> > VectorOfElements;
   VectorOfElements NestedElements;
@@ -134,7 +206,8 @@ void vtkPVXMLElement::AddAttribute(const char* attrName,
     return;
     }
   
-  this->Internal->AttributeNames.push_back(attrName);
+  this->Internal->AttributeNames.push_back(
+    vtkPVXMLElementInternName(attrName));
   this->Internal->AttributeValues.push_back(attrValue);
 }
 
@@ -152,7 +225,7 @@ void vtkPVXMLElement::SetAttribute(const char* attrName,
   size_t i;
   for(i=0; i < numAttributes; ++i)
     {
-    if(strcmp(this->Internal->AttributeNames[i].c_str(), attrName) == 0)
+    if(strcmp(this->Internal->AttributeNames[i], attrName) == 0)
       {
       this->Internal->AttributeValues[i] = attrValue;
       return;
@@ -174,6 +247,8 @@ void vtkPVXMLElement::ReadXMLAttributes(const char** atts)
     unsigned int count=0;
     while(*attsIter++) { ++count; }
     unsigned int numberOfAttributes = count/2;
+    this->Internal->AttributeNames.reserve(numberOfAttributes);
+    this->Internal->AttributeValues.reserve(numberOfAttributes);
 
     unsigned int i;
     for(i=0;i < numberOfAttributes; ++i)
@@ -234,7 +309,7 @@ const char* vtkPVXMLElement::GetAttributeOrDefault( const char* name,
   size_t i;
   for(i=0; i < numAttributes; ++i)
     {
-    if(strcmp(this->Internal->AttributeNames[i].c_str(), name) == 0)
+    if(strcmp(this->Internal->AttributeNames[i], name) == 0)
       {
       return this->Internal->AttributeValues[i].c_str();
       }
@@ -261,7 +336,7 @@ void vtkPVXMLElement::PrintXML(ostream& os, vtkIndent indent)
   size_t i;
   for(i=0;i < numAttributes; ++i)
     {
-    const char* aName = this->Internal->AttributeNames[i].c_str();
+    const char* aName = this->Internal->AttributeNames[i];
     const char* aValue = this->Internal->AttributeValues[i].c_str();
 
     // we always print the encoded value. The expat parser processes encoded
@@ -638,7 +713,7 @@ void vtkPVXMLElement::Merge(vtkPVXMLElement* element, const char* attributeName)
     // if not found, add it
     if(!found)
       {
-      this->AddAttribute(element->Internal->AttributeNames[i].c_str(),
+      this->AddAttribute(element->Internal->AttributeNames[i],
                          element->Internal->AttributeValues[i].c_str());
       }
     }
@@ -733,11 +808,11 @@ bool vtkPVXMLElement::Equals(vtkPVXMLElement* other)
 //----------------------------------------------------------------------------
 void vtkPVXMLElement::RemoveAttribute(const char* name)
 {
-  vtkstd::vector<vtkstd::string>::iterator nameIterator = this->Internal->AttributeNames.begin();
+  vtkstd::vector<const char*>::iterator nameIterator = this->Internal->AttributeNames.begin();
   vtkstd::vector<vtkstd::string>::iterator valueIterator = this->Internal->AttributeValues.begin();
   while(nameIterator != this->Internal->AttributeNames.end())
     {
-    if(strcmp(nameIterator->c_str(), name) == 0)
+    if(strcmp(*nameIterator, name) == 0)
       {
       this->Internal->AttributeNames.erase(nameIterator);
       this->Internal->AttributeValues.erase(valueIterator);
@@ -749,3 +824,112 @@ void vtkPVXMLElement::RemoveAttribute(const char* name)
 }
 
 //----------------------------------------------------------------------------
+void vtkPVXMLElement::WriteBinary(vtkStdString& buffer)
+{
+  vtkPVXMLElementWriteString(buffer, this->Name,
+    this->Name? strlen(this->Name) : 0);
+  vtkPVXMLElementWriteString(buffer, this->Id, this->Id? strlen(this->Id) : 0);
+  vtkPVXMLElementWriteString(buffer, this->Internal->CharacterData.c_str(),
+    this->Internal->CharacterData.size());
+
+  size_t numAttributes = this->Internal->AttributeNames.size();
+  vtkPVXMLElementWriteUInt32(buffer, static_cast<vtkTypeUInt32>(numAttributes));
+  for (size_t i=0; i < numAttributes; ++i)
+    {
+    const char* aName = this->Internal->AttributeNames[i];
+    const vtkstd::string& aValue = this->Internal->AttributeValues[i];
+    vtkPVXMLElementWriteString(buffer, aName, strlen(aName));
+    vtkPVXMLElementWriteString(buffer, aValue.c_str(), aValue.size());
+    }
+
+  size_t numberOfNestedElements = this->Internal->NestedElements.size();
+  vtkPVXMLElementWriteUInt32(buffer,
+    static_cast<vtkTypeUInt32>(numberOfNestedElements));
+  for (size_t i=0; i < numberOfNestedElements; ++i)
+    {
+    this->Internal->NestedElements[i]->WriteBinary(buffer);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkPVXMLElement* vtkPVXMLElement::ReadBinary(const char*& data,
+  const char* end)
+{
+  const char* cursor = data;
+  const char* name;
+  const char* id;
+  const char* characterData;
+  vtkTypeUInt32 nameLength, idLength, characterDataLength;
+  vtkTypeUInt32 numAttributes;
+  if (!vtkPVXMLElementReadString(cursor, end, name, nameLength) ||
+    !vtkPVXMLElementReadString(cursor, end, id, idLength) ||
+    !vtkPVXMLElementReadString(cursor, end, characterData,
+      characterDataLength) ||
+    !vtkPVXMLElementReadUInt32(cursor, end, numAttributes) ||
+    // each attribute takes at least 8 bytes.
+    static_cast<vtkTypeUInt32>(end - cursor) / 8 < numAttributes)
+    {
+    return NULL;
+    }
+
+  vtkSmartPointer<vtkPVXMLElement> element =
+    vtkSmartPointer<vtkPVXMLElement>::New();
+  if (name)
+    {
+    element->Name = new char[nameLength+1];
+    memcpy(element->Name, name, nameLength);
+    element->Name[nameLength] = 0;
+    }
+  if (id)
+    {
+    element->Id = new char[idLength+1];
+    memcpy(element->Id, id, idLength);
+    element->Id[idLength] = 0;
+    }
+  if (characterData)
+    {
+    element->Internal->CharacterData.assign(characterData,
+      characterDataLength);
+    }
+
+  element->Internal->AttributeNames.reserve(numAttributes);
+  element->Internal->AttributeValues.reserve(numAttributes);
+  vtkstd::string attrName;
+  for (vtkTypeUInt32 i=0; i < numAttributes; ++i)
+    {
+    const char* aName;
+    const char* aValue;
+    vtkTypeUInt32 aNameLength, aValueLength;
+    if (!vtkPVXMLElementReadString(cursor, end, aName, aNameLength) ||
+      !vtkPVXMLElementReadString(cursor, end, aValue, aValueLength) ||
+      !aName || !aValue)
+      {
+      return NULL;
+      }
+    attrName.assign(aName, aNameLength);
+    element->Internal->AttributeNames.push_back(
+      vtkPVXMLElementInternName(attrName.c_str()));
+    element->Internal->AttributeValues.push_back(
+      vtkstd::string(aValue, aValueLength));
+    }
+
+  vtkTypeUInt32 numberOfNestedElements;
+  if (!vtkPVXMLElementReadUInt32(cursor, end, numberOfNestedElements))
+    {
+    return NULL;
+    }
+  for (vtkTypeUInt32 i=0; i < numberOfNestedElements; ++i)
+    {
+    vtkPVXMLElement* nested = vtkPVXMLElement::ReadBinary(cursor, end);
+    if (!nested)
+      {
+      return NULL;
+      }
+    element->AddNestedElement(nested);
+    nested->Delete();
+    }
+
+  data = cursor;
+  element->Register(NULL);
+  return element;
+}
@@ -208,6 +208,20 @@ public:
   // Copy the attributes from current XML element content into the provided one.
   void CopyAttributesTo(vtkPVXMLElement* other);
 
+  // Description:
+  // Append a compact binary encoding of this element and of its nested
+  // elements to \c buffer. Reading it back with ReadBinary() is much faster
+  // than parsing the equivalent XML; it is used to cache parsed configuration
+  // files. The encoding uses the native byte order.
+  void WriteBinary(vtkStdString& buffer);
+
+  // Description:
+  // Create an element from the encoding written by WriteBinary() starting at
+  // \c data. On success, \c data is moved past the element. Returns NULL if
+  // the encoding is truncated or corrupted. The caller must Delete() the
+  // returned element.
+  static vtkPVXMLElement* ReadBinary(const char*& data, const char* end);
+
 protected:
   vtkPVXMLElement();
   ~vtkPVXMLElement();
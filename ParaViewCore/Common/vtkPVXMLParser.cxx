@@ -15,7 +15,14 @@
 #include "vtkPVXMLParser.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVXMLElement.h"
-#include "vtksys/ios/sstream"
+
+#include <stdio.h>
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# define SNPRINTF _snprintf
+#else
+# define SNPRINTF snprintf
+#endif
 
 vtkStandardNewMacro(vtkPVXMLParser);
 
@@ -30,6 +37,8 @@ vtkPVXMLParser::vtkPVXMLParser()
   this->ElementIdIndex = 0;
   this->RootElement = 0;
   this->SuppressErrorMessages = 0;
+  this->StreamingDepth = -1;
+  this->DiscardStreamedElements = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -56,6 +65,9 @@ void vtkPVXMLParser::PrintSelf(ostream& os, vtkIndent indent)
      << "\n";
   os << indent << "SuppressErrorMessages: " << this->SuppressErrorMessages
      << "\n";
+  os << indent << "StreamingDepth: " << this->StreamingDepth << "\n";
+  os << indent << "DiscardStreamedElements: "
+     << this->DiscardStreamedElements << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -71,9 +83,11 @@ void vtkPVXMLParser::StartElement(const char* name, const char** atts)
     }
   else
     {
-    vtksys_ios::ostringstream idstr;
-    idstr << this->ElementIdIndex++ << ends;
-    element->SetId(idstr.str().c_str());
+    // Called for every element of every configuration file, hence no string
+    // stream here.
+    char idstr[32];
+    SNPRINTF(idstr, sizeof(idstr), "%u", this->ElementIdIndex++);
+    element->SetId(idstr);
     }
   this->PushOpenElement(element);
 }
@@ -83,6 +97,16 @@ void vtkPVXMLParser::EndElement(const char* vtkNotUsed(name))
 {
   vtkPVXMLElement* finished = this->PopOpenElement();
   unsigned int numOpen = this->NumberOfOpenElements;
+  if(this->StreamingDepth >= 0 &&
+    numOpen == static_cast<unsigned int>(this->StreamingDepth))
+    {
+    this->InvokeEvent(ElementParsedEvent, finished);
+    if(this->DiscardStreamedElements)
+      {
+      finished->Delete();
+      return;
+      }
+    }
   if(numOpen > 0)
     {
     this->OpenElements[numOpen-1]->AddNestedElement(finished);
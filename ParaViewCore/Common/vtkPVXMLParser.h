@@ -16,10 +16,16 @@
 // .SECTION Description
 // This is a subclass of vtkXMLParser that constructs a representation
 // of parsed XML using vtkPVXMLElement.
+//
+// The parser can also be used in a streaming fashion (see StreamingDepth):
+// vtkPVXMLParser::ElementParsedEvent is then fired for every element at a
+// given depth as soon as it is complete, and the element may be discarded
+// once handled, so that large documents need not be held in memory.
 #ifndef __vtkPVXMLParser_h
 #define __vtkPVXMLParser_h
 
 #include "vtkXMLParser.h"
+#include "vtkCommand.h" // needed for vtkCommand::UserEvent.
 
 class vtkPVXMLElement;
 
@@ -52,11 +58,35 @@ public:
   vtkSetMacro(SuppressErrorMessages, int);
   vtkBooleanMacro(SuppressErrorMessages, int);
 
+  // Description:
+  // When StreamingDepth is 0 or more, ElementParsedEvent is invoked, with the
+  // element as call data, every time an element at that depth (the root
+  // element being at depth 0) has been parsed. Default is -1 i.e. no event.
+  vtkSetMacro(StreamingDepth, int);
+  vtkGetMacro(StreamingDepth, int);
+
+  // Description:
+  // If on, the elements reported through ElementParsedEvent are released
+  // right after the event instead of being added to their parent. Observers
+  // must then keep a reference to the elements they need. Off by default.
+  vtkSetMacro(DiscardStreamedElements, int);
+  vtkGetMacro(DiscardStreamedElements, int);
+  vtkBooleanMacro(DiscardStreamedElements, int);
+
+//BTX
+  enum
+    {
+    ElementParsedEvent = vtkCommand::UserEvent + 1
+    };
+//ETX
+
 protected:
   vtkPVXMLParser();
   ~vtkPVXMLParser();
 
   int SuppressErrorMessages;
+  int StreamingDepth;
+  int DiscardStreamedElements;
 
   void StartElement(const char* name, const char** atts);
   void EndElement(const char* name);
@@ -35,10 +35,13 @@
 #include "vtkSIProxyDefinitionManager.h"
 #include "vtkPVSessionCoreInterpreterHelper.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
 #include "assert.h"
 #include <fstream>
+#include <string.h>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 
 #define LOG(x)\
@@ -71,8 +74,23 @@ namespace
     case vtkPVSessionCore::DELETE_SI:
       sessioncore->DeleteSIObjectSatelliteCallback();
       break;
+
+    case vtkPVSessionCore::BATCH:
+      sessioncore->BatchSatelliteCallback();
+      break;
       }
     }
+
+  // Flags stored along each message of a batch.
+  enum
+    {
+    BATCH_FORWARD       = 0x1,
+    BATCH_IGNORE_ERRORS = 0x2
+    };
+
+  // Size of the header preceding each message in a batch: the message type,
+  // the flags and the message length.
+  const int BATCH_HEADER_SIZE = 2 + sizeof(int);
 };
 //****************************************************************************/
 //                        Internal Class
@@ -82,6 +100,8 @@ class vtkPVSessionCore::vtkInternals
 public:
   vtkInternals()
     {
+    this->BatchNeedsForward = false;
+    this->BatchStartTime = 0.0;
     }
   ~vtkInternals()
     {
@@ -187,6 +207,11 @@ public:
   RemoteObjectMapType RemoteObjectMap;
   unsigned long InterpreterObserverID;
   vtkstd::map<vtkTypeUInt32, vtkSMMessage > MessageCacheMap;
+
+  // Messages waiting to be forwarded to the satellites (see MaxBatchSize).
+  vtkstd::vector<unsigned char> Batch;
+  bool BatchNeedsForward;
+  double BatchStartTime;
 };
 
 //****************************************************************************/
@@ -198,6 +223,8 @@ vtkPVSessionCore::vtkPVSessionCore()
     vtkClientServerInterpreterInitializer::GetInterpreter();
   this->MPIMToNSocketConnection = NULL;
   this->SymmetricMPIMode = false;
+  this->MaxBatchSize = 0;
+  this->MaxBatchLatency = 20;
 
   vtkPVSessionCoreInterpreterHelper* helper =
     vtkPVSessionCoreInterpreterHelper::New();
@@ -263,6 +290,9 @@ vtkPVSessionCore::~vtkPVSessionCore()
 {
   LOG("Closing session");
 
+  // Don't lose the messages still waiting for the satellites.
+  this->FlushPendingMessages();
+
   // Clean up interpreter
   this->Interpreter->RemoveObserver(this->Internals->InterpreterObserverID);
   vtkClientServerStream stream;
@@ -336,11 +366,13 @@ int vtkPVSessionCore::GetNumberOfProcesses()
 //----------------------------------------------------------------------------
 vtkSIObject* vtkPVSessionCore::GetSIObject(vtkTypeUInt32 globalid)
 {
+  this->FlushPendingMessages();
   return this->Internals->GetSIObject(globalid);
 }
 //----------------------------------------------------------------------------
 vtkObject* vtkPVSessionCore::GetRemoteObject(vtkTypeUInt32 globalid)
 {
+  this->FlushPendingMessages();
   return this->Internals->GetRemoteObject(globalid);
 }
 
@@ -410,6 +442,18 @@ void vtkPVSessionCore::PushState(vtkSMMessage* message)
           this->ParallelController->GetLocalProcessId() == 0 ||
           this->SymmetricMPIMode);
 
+  if (this->GetBatchingEnabled())
+    {
+    int byte_size = message->ByteSize();
+    unsigned char *raw_data = new unsigned char[byte_size + 1];
+    message->SerializeToArray(raw_data, byte_size);
+    this->AddToBatch(PUSH_STATE,
+      (message->location() & vtkProcessModule::SERVERS) != 0, false,
+      raw_data, byte_size);
+    delete [] raw_data;
+    return;
+    }
+
   if ( (message->location() & vtkProcessModule::SERVERS) != 0 &&
        !this->SymmetricMPIMode)
     {
@@ -470,11 +514,15 @@ void vtkPVSessionCore::PushStateSatelliteCallback()
 void vtkPVSessionCore::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaxBatchSize: " << this->MaxBatchSize << endl;
+  os << indent << "MaxBatchLatency: " << this->MaxBatchLatency << endl;
 }
 
 //----------------------------------------------------------------------------
 void vtkPVSessionCore::PullState(vtkSMMessage* message)
 {
+  this->FlushPendingMessages();
+
   LOG(
     << "----------------------------------------------------------------\n"
     << "Pull State ( " << message->ByteSize() << " bytes )\n"
@@ -514,6 +562,20 @@ void vtkPVSessionCore::ExecuteStream( vtkTypeUInt32 location,
           this->ParallelController->GetLocalProcessId() == 0 ||
           this->SymmetricMPIMode );
 
+  if (this->GetBatchingEnabled())
+    {
+    // The stream travels with the messages that preceded it. Flush right away
+    // since the caller may ask for the result.
+    size_t byte_size;
+    const unsigned char *raw_data;
+    stream.GetData(&raw_data, &byte_size);
+    this->AddToBatch(EXECUTE_STREAM,
+      (location & vtkProcessModule::SERVERS) != 0, ignore_errors,
+      raw_data, static_cast<int>(byte_size));
+    this->FlushPendingMessages();
+    return;
+    }
+
   if ( (location & vtkProcessModule::SERVERS) != 0 &&
        !this->SymmetricMPIMode)
     {
@@ -590,6 +652,17 @@ void vtkPVSessionCore::DeleteSIObject(vtkSMMessage* message)
 
   vtkTypeUInt32 location = message->location();
 
+  if (this->GetBatchingEnabled())
+    {
+    int byte_size = message->ByteSize();
+    unsigned char *raw_data = new unsigned char[byte_size + 1];
+    message->SerializeToArray(raw_data, byte_size);
+    this->AddToBatch(DELETE_SI,
+      (location & vtkProcessModule::SERVERS) != 0, false, raw_data, byte_size);
+    delete [] raw_data;
+    return;
+    }
+
   if ( (location & vtkProcessModule::SERVERS) != 0 && !this->SymmetricMPIMode)
     {
     // send message to satellites and then start processing.
@@ -696,6 +769,8 @@ bool vtkPVSessionCore::GatherInformation( vtkTypeUInt32 location,
           this->ParallelController->GetLocalProcessId() == 0 ||
           this->SymmetricMPIMode);
 
+  this->FlushPendingMessages();
+
   if (!this->GatherInformationInternal(information, globalid))
     {
     return false;
@@ -849,5 +924,155 @@ void vtkPVSessionCore::GetAllRemoteObjects(vtkCollection* collection)
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkPVSessionCore::GetLastResult()
 {
+  this->FlushPendingMessages();
   return this->Interpreter->GetLastResult();
 }
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::GetBatchingEnabled()
+{
+  return (this->MaxBatchSize > 0 &&
+    !this->SymmetricMPIMode &&
+    this->ParallelController &&
+    this->ParallelController->GetNumberOfProcesses() > 1 &&
+    this->ParallelController->GetLocalProcessId() == 0);
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionCore::HasPendingMessages()
+{
+  return !this->Internals->Batch.empty();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::AddToBatch(unsigned char type, bool forward,
+  bool ignore_errors, const unsigned char* data, int length)
+{
+  vtkstd::vector<unsigned char>& batch = this->Internals->Batch;
+  if (batch.empty())
+    {
+    this->Internals->BatchStartTime = vtkTimerLog::GetUniversalTime();
+    }
+
+  // Messages that are not forwarded are batched as well so that the root
+  // executes everything in the order it was received.
+  unsigned char header[BATCH_HEADER_SIZE];
+  header[0] = type;
+  header[1] = static_cast<unsigned char>(
+    (forward? BATCH_FORWARD : 0) | (ignore_errors? BATCH_IGNORE_ERRORS : 0));
+  memcpy(header + 2, &length, sizeof(int));
+  batch.insert(batch.end(), header, header + BATCH_HEADER_SIZE);
+  batch.insert(batch.end(), data, data + length);
+  this->Internals->BatchNeedsForward |= forward;
+
+  double elapsed =
+    vtkTimerLog::GetUniversalTime() - this->Internals->BatchStartTime;
+  if (static_cast<int>(batch.size()) >= this->MaxBatchSize ||
+    elapsed * 1000.0 >= this->MaxBatchLatency)
+    {
+    this->FlushPendingMessages();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::FlushPendingMessages()
+{
+  // Executing a batch may queue new messages, hence the loop. Swapping the
+  // batch out also makes nested calls (through GetSIObject() for example) a
+  // no-op.
+  while (!this->Internals->Batch.empty())
+    {
+    vtkstd::vector<unsigned char> batch;
+    batch.swap(this->Internals->Batch);
+    bool forward = this->Internals->BatchNeedsForward;
+    this->Internals->BatchNeedsForward = false;
+
+    int byte_size = static_cast<int>(batch.size());
+    LOG(<< "----------------------------------------------------------------\n"
+        << "Flush Batch ( " << byte_size << " bytes"
+        << (forward? ", forwarded" : "") << " )\n");
+    if (forward)
+      {
+      unsigned char type = BATCH;
+      this->ParallelController->TriggerRMIOnAllChildren(&type, 1,
+        ROOT_SATELLITE_RMI_TAG);
+      this->ParallelController->Broadcast(&byte_size, 1, 0);
+      this->ParallelController->Broadcast(&batch[0], byte_size, 0);
+      }
+    this->ProcessBatch(&batch[0], byte_size, false);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::BatchSatelliteCallback()
+{
+  int byte_size = 0;
+  this->ParallelController->Broadcast(&byte_size, 1, 0);
+
+  unsigned char *raw_data = new unsigned char[byte_size + 1];
+  this->ParallelController->Broadcast(raw_data, byte_size, 0);
+  this->ProcessBatch(raw_data, byte_size, true);
+  delete [] raw_data;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVSessionCore::ProcessBatch(const unsigned char* data, int length,
+  bool satellite)
+{
+  int offset = 0;
+  while (offset + BATCH_HEADER_SIZE <= length)
+    {
+    unsigned char type = data[offset];
+    unsigned char flags = data[offset + 1];
+    int byte_size;
+    memcpy(&byte_size, data + offset + 2, sizeof(int));
+    offset += BATCH_HEADER_SIZE;
+    if (byte_size < 0 || offset + byte_size > length)
+      {
+      vtkErrorMacro("Truncated message batch.");
+      return;
+      }
+    const unsigned char* raw_data = data + offset;
+    offset += byte_size;
+
+    if (satellite && (flags & BATCH_FORWARD) == 0)
+      {
+      continue;
+      }
+
+    switch (type)
+      {
+    case PUSH_STATE:
+    case DELETE_SI:
+        {
+        vtkSMMessage message;
+        if (!message.ParseFromArray(raw_data, byte_size))
+          {
+          vtkErrorMacro("Failed to parse protobuf message.");
+          }
+        else if (type == PUSH_STATE)
+          {
+          this->PushStateInternal(&message);
+          }
+        else
+          {
+          this->DeleteSIObjectInternal(&message);
+          }
+        }
+      break;
+
+    case EXECUTE_STREAM:
+        {
+        vtkClientServerStream stream;
+        stream.SetData(raw_data, byte_size);
+        this->ExecuteStreamInternal(stream,
+          (flags & BATCH_IGNORE_ERRORS) != 0);
+        }
+      break;
+
+    default:
+      vtkErrorMacro("Unknown message type in batch: "
+        << static_cast<int>(type));
+      }
+    }
+}
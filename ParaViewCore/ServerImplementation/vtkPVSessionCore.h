@@ -118,6 +118,32 @@ public:
   void SetMPIMToNSocketConnection(vtkMPIMToNSocketConnection*);
   vtkGetObjectMacro(MPIMToNSocketConnection, vtkMPIMToNSocketConnection);
 
+  // Description:
+  // When MaxBatchSize is greater than 0, the root node of a parallel server
+  // does not forward every PushState(), ExecuteStream() and DeleteSIObject()
+  // to the satellites individually. Instead the messages are accumulated and
+  // sent as a single broadcast that the satellites replay in order. The
+  // batch is flushed when it grows beyond MaxBatchSize bytes, when its oldest
+  // message is older than MaxBatchLatency milliseconds, on any ExecuteStream()
+  // and before any request that needs the processes to be up-to-date
+  // (PullState(), GatherInformation(), GetLastResult()...). The root itself
+  // executes the batched messages only when flushing so that collective
+  // operations triggered by them stay matched with the satellites.
+  // Default is 0 i.e. every message is forwarded as soon as it is received.
+  vtkSetClampMacro(MaxBatchSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaxBatchSize, int);
+  vtkSetClampMacro(MaxBatchLatency, int, 0, VTK_INT_MAX);
+  vtkGetMacro(MaxBatchLatency, int);
+
+  // Description:
+  // Forward and execute all the messages pending in the current batch, if any.
+  void FlushPendingMessages();
+
+  // Description:
+  // Returns true if some messages are waiting in the current batch. The
+  // server event loop uses this to know when to wake-up and flush them.
+  bool HasPendingMessages();
+
 //BTX
   enum MessageTypes
     {
@@ -125,13 +151,15 @@ public:
     PULL_STATE         = 13,
     EXECUTE_STREAM     = 14,
     GATHER_INFORMATION = 15,
-    DELETE_SI          = 16
+    DELETE_SI          = 16,
+    BATCH              = 17
     };
   // Methods used to managed MPI satellite
   void PushStateSatelliteCallback();
   void ExecuteStreamSatelliteCallback();
   void GatherInformationStatelliteCallback();
   void DeleteSIObjectSatelliteCallback();
+  void BatchSatelliteCallback();
 
   // Description:
   // Allow the user to fill a vtkCollection with all RemoteObjects
@@ -170,6 +198,23 @@ protected:
   // SIObject.
   virtual void DeleteSIObjectInternal(vtkSMMessage* message);
 
+  // Description:
+  // Returns true if the messages destined to the satellites are to be
+  // aggregated instead of being forwarded immediately.
+  bool GetBatchingEnabled();
+
+  // Description:
+  // Append a message to the current batch and flush it if it exceeds
+  // MaxBatchSize or MaxBatchLatency. \c forward indicates if the message must
+  // be executed on the satellites as well as on the root.
+  void AddToBatch(unsigned char type, bool forward, bool ignore_errors,
+    const unsigned char* data, int length);
+
+  // Description:
+  // Execute the messages of a batch. When \c satellite is true, only the
+  // messages forwarded to the satellites are executed.
+  void ProcessBatch(const unsigned char* data, int length, bool satellite);
+
   // Description:
   // Callback for reporting interpreter errors.
   void OnInterpreterError(vtkObject*, unsigned long, void* calldata);
@@ -184,6 +229,8 @@ protected:
   vtkWeakPointer<vtkMultiProcessController> ParallelController;
   vtkClientServerInterpreter* Interpreter;
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
+  int MaxBatchSize;
+  int MaxBatchLatency;
 
 private:
   vtkPVSessionCore(const vtkPVSessionCore&); // Not implemented
@@ -25,14 +25,18 @@
 #include "vtkPVConfig.h"
 #include "vtkPVInformation.h"
 #include "vtkPVOptions.h"
+#include "vtkPVSessionCore.h"
 #include "vtkProcessModule.h"
 #include "vtkSMMessage.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
 
+#include "vtk_zlib.h"
+
 #include <vtkstd/string>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
+#include <vtksys/SystemTools.hxx>
 
 #include <assert.h>
 
@@ -60,8 +64,23 @@ vtkStandardNewMacro(vtkPVSessionServer);
 vtkPVSessionServer::vtkPVSessionServer()
 {
   this->ClientController = 0;
+  this->CompressionThreshold = 0;
   this->ActivateObserverId = 0;
   this->DeActivateObserverId = 0;
+
+  // The messages from the client are aggregated before being forwarded to the
+  // satellites. This can be tuned with the PV_SATELLITE_BATCH_SIZE (bytes, 0
+  // to disable) and PV_SATELLITE_BATCH_LATENCY (milliseconds) variables.
+  this->SessionCore->SetMaxBatchSize(1024*1024);
+  if (const char* size = vtksys::SystemTools::GetEnv("PV_SATELLITE_BATCH_SIZE"))
+    {
+    this->SessionCore->SetMaxBatchSize(atoi(size));
+    }
+  if (const char* latency =
+    vtksys::SystemTools::GetEnv("PV_SATELLITE_BATCH_LATENCY"))
+    {
+    this->SessionCore->SetMaxBatchLatency(atoi(latency));
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -271,6 +290,8 @@ bool vtkPVSessionServer::Connect(const char* url)
   if (ccontroller)
     {
     this->SetClientController(ccontroller);
+    this->CompressionThreshold =
+      nam->GetNegotiatedCompressionThreshold(ccontroller);
     ccontroller->Delete();
     }
 
@@ -303,24 +324,64 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   case vtkPVSessionServer::PUSH:
       {
       vtkstd::string string;
-      stream >> string;
+      if (!vtkPVSessionServer::ReadMessage(stream, string))
+        {
+        break;
+        }
       vtkSMMessage msg;
       msg.ParseFromString(string);
       this->PushState(&msg);
       }
     break;
 
+  case vtkPVSessionServer::PUSH_BATCH:
+      {
+      vtkstd::string string;
+      if (!vtkPVSessionServer::ReadMessage(stream, string))
+        {
+        break;
+        }
+      vtkSMMessageCollection batch;
+      batch.ParseFromString(string);
+      for (int cc=0; cc < batch.item_size(); cc++)
+        {
+        this->PushState(batch.mutable_item(cc));
+        }
+      }
+    break;
+
   case vtkPVSessionServer::PULL:
       {
+      // Always reply, the client is waiting for it.
       vtkstd::string string;
-      stream >> string;
+      vtkPVSessionServer::ReadMessage(stream, string);
       vtkSMMessage msg;
       msg.ParseFromString(string);
       this->PullState(&msg);
 
       // Send the result back to client
       vtkMultiProcessStream css;
-      css << msg.SerializeAsString();
+      vtkPVSessionServer::WriteMessage(css, msg.SerializeAsString(),
+        this->CompressionThreshold);
+      this->ClientController->Send( css, 1, vtkPVSessionServer::REPLY_PULL);
+      }
+    break;
+
+  case vtkPVSessionServer::PULL_ASYNC:
+      {
+      vtkTypeUInt32 requestId;
+      vtkstd::string string;
+      stream >> requestId;
+      vtkPVSessionServer::ReadMessage(stream, string);
+      vtkSMMessage msg;
+      msg.ParseFromString(string);
+      this->PullState(&msg);
+
+      // Send the result back to client, tagged with the request id.
+      vtkMultiProcessStream css;
+      css << requestId;
+      vtkPVSessionServer::WriteMessage(css, msg.SerializeAsString(),
+        this->CompressionThreshold);
       this->ClientController->Send( css, 1, vtkPVSessionServer::REPLY_PULL);
       }
     break;
@@ -328,7 +389,10 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
   case vtkPVSessionServer::DELETE_SI:
       {
       vtkstd::string string;
-      stream >> string;
+      if (!vtkPVSessionServer::ReadMessage(stream, string))
+        {
+        break;
+        }
       vtkSMMessage msg;
       msg.ParseFromString(string);
       this->DeleteSIObject(&msg);
@@ -366,6 +430,16 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       }
     break;
 
+  case vtkPVSessionServer::GATHER_INFORMATION_ASYNC:
+      {
+      vtkstd::string classname;
+      vtkTypeUInt32 requestId, location, globalid;
+      stream >> requestId >> location >> classname >> globalid;
+      this->GatherInformationInternal(location, classname.c_str(), globalid,
+        stream, requestId);
+      }
+    break;
+
     }
 }
 
@@ -390,8 +464,14 @@ void vtkPVSessionServer::SendLastResultToClient()
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::GatherInformationInternal(
   vtkTypeUInt32 location, const char* classname, vtkTypeUInt32 globalid,
-  vtkMultiProcessStream& stream)
+  vtkMultiProcessStream& stream, vtkTypeUInt32 requestId/*=0*/)
 {
+  if (requestId != 0)
+    {
+    this->ClientController->Send(&requestId, 1, 1,
+      vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+    }
+
   vtkSmartPointer<vtkObject> o;
   o.TakeReference(vtkInstantiator::CreateInstance(classname));
 
@@ -436,8 +516,61 @@ void vtkPVSessionServer::OnCloseSessionRMI()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSessionServer::WriteMessage(vtkMultiProcessStream& stream,
+  const vtkstd::string& data, int threshold)
+{
+  // The message is preceded by its uncompressed size, 0 meaning that it is
+  // not compressed.
+  if (threshold > 0 && data.size() > static_cast<size_t>(threshold))
+    {
+    uLongf compressedSize = compressBound(static_cast<uLong>(data.size()));
+    vtkstd::string compressed(compressedSize, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressedSize,
+        reinterpret_cast<const Bytef*>(data.data()),
+        static_cast<uLong>(data.size()), Z_BEST_SPEED) == Z_OK &&
+      compressedSize < data.size())
+      {
+      compressed.resize(compressedSize);
+      stream << static_cast<int>(data.size()) << compressed;
+      return;
+      }
+    }
+  stream << 0 << data;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVSessionServer::ReadMessage(vtkMultiProcessStream& stream,
+  vtkstd::string& data)
+{
+  int size = 0;
+  stream >> size;
+  if (size == 0)
+    {
+    stream >> data;
+    return true;
+    }
+
+  vtkstd::string compressed;
+  stream >> compressed;
+  data.resize(size);
+  uLongf uncompressedSize = static_cast<uLongf>(size);
+  if (uncompress(reinterpret_cast<Bytef*>(&data[0]), &uncompressedSize,
+      reinterpret_cast<const Bytef*>(compressed.data()),
+      static_cast<uLong>(compressed.size())) != Z_OK ||
+    uncompressedSize != static_cast<uLongf>(size))
+    {
+    vtkGenericWarningMacro("Failed to decompress message.");
+    data.clear();
+    return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSessionServer::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CompressionThreshold: " << this->CompressionThreshold
+    << endl;
 }
@@ -24,6 +24,7 @@
 #define __vtkPVSessionServer_h
 
 #include "vtkPVSessionBase.h"
+#include <vtkstd/string> // needed for vtkstd::string.
 
 class vtkMultiProcessController;
 class vtkMultiProcessStream;
@@ -72,6 +73,9 @@ public:
     GATHER_INFORMATION=4,
     DELETE_SI=5,
     LAST_RESULT=6,
+    PUSH_BATCH=7,
+    PULL_ASYNC=8,
+    GATHER_INFORMATION_ASYNC=9,
     CLIENT_SERVER_MESSAGE_RMI=55625,
     CLOSE_SESSION=55626,
     REPLY_GATHER_INFORMATION_TAG=55627,
@@ -85,6 +89,16 @@ public:
   void OnClientServerMessageRMI(void* message, int message_length);
   void OnCloseSessionRMI();
 
+  // Description:
+  // Append a serialized message to the stream. When \c threshold is positive,
+  // messages larger than \c threshold bytes are zlib-compressed (unless that
+  // does not make them smaller). ReadMessage() extracts a message written by
+  // WriteMessage(), returning false if it cannot be decompressed. Used on
+  // both ends of the client-server connection.
+  static void WriteMessage(vtkMultiProcessStream& stream,
+    const vtkstd::string& data, int threshold);
+  static bool ReadMessage(vtkMultiProcessStream& stream, vtkstd::string& data);
+
 protected:
   vtkPVSessionServer();
   ~vtkPVSessionServer();
@@ -92,16 +106,22 @@ protected:
   void SetClientController(vtkMultiProcessController*);
 
   // Description:
-  // Called when client triggers GatherInformation().
+  // Called when client triggers GatherInformation(). When \c requestId is
+  // non-zero the reply is prefixed by it so that the client can match it with
+  // the asynchronous request it belongs to.
   void GatherInformationInternal(
     vtkTypeUInt32 location, const char* classname, vtkTypeUInt32 globalid,
-    vtkMultiProcessStream&);
+    vtkMultiProcessStream&, vtkTypeUInt32 requestId=0);
 
   // Description:
   // Sends the last result to client.
   void SendLastResultToClient();
 
   vtkMultiProcessController* ClientController;
+
+  // Compression threshold negotiated with the client, see
+  // vtkNetworkAccessManager::GetNegotiatedCompressionThreshold().
+  int CompressionThreshold;
   vtkMPIMToNSocketConnection* MPIMToNSocketConnection;
 
   unsigned long ActivateObserverId;
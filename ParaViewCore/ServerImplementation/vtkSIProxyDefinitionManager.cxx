@@ -18,6 +18,7 @@
 #include "vtkCollectionIterator.h"
 #include "vtkCommand.h"
 #include "vtkInstantiator.h"
+#include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkNew.h"
 #include "vtkPVConfig.h"
@@ -39,11 +40,19 @@
 #include <vtksys/ios/sstream>
 #include <vtkstd/map>
 #include <vtksys/RegularExpression.hxx>
+#include <vtksys/SystemTools.hxx>
 #include <vtkstd/set>
 #include <vtkstd/string>
 #include <vtkstd/vector>
 
 #include <assert.h>
+#include <stdio.h>
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# include <process.h>
+# define getpid _getpid
+#else
+# include <unistd.h>
+#endif
 
 //****************************************************************************/
 //                    Internal Classes and typedefs
@@ -59,11 +68,21 @@ public:
   StrToStrToXmlMap CoreDefinitions;
   // Keep track of custom definition
   StrToStrToXmlMap CustomsDefinitions;
+  // Last state returned by Pull(), serializing all the definitions is
+  // expensive so it is kept until the definitions change.
+  vtkSMMessage PulledState;
+  bool PulledStateValid;
+  //-------------------------------------------------------------------------
+  vtkInternals()
+    {
+    this->PulledStateValid = false;
+    }
   //-------------------------------------------------------------------------
   void Clear()
     {
     this->CoreDefinitions.clear();
     this->CustomsDefinitions.clear();
+    this->PulledStateValid = false;
     }
   //-------------------------------------------------------------------------
   bool HasCoreDefinition( const char* groupName, const char* proxyName)
@@ -438,6 +457,154 @@ private:
   bool InvalidCustomIterator;
 };
 
+//****************************************************************************/
+//               Cache of the parsed configuration files
+//****************************************************************************/
+// Parsing the configuration xmls is a significant part of the start-up time
+// of every process. When the PV_PROXY_DEFINITION_CACHE_DIR environment
+// variable points to a directory, the parsed xmls are saved there using
+// vtkPVXMLElement::WriteBinary() in a file named after a hash of the xmls.
+// Processes loading the same xmls later simply read that file back. Since the
+// file name is derived from the content, a cache file never needs to be
+// invalidated: modified xmls (new build, other plugin version...) just use
+// another file.
+namespace
+{
+  const char vtkSIProxyDefinitionCacheMagic[8] =
+    { 'P', 'V', 'D', 'E', 'F', 'S', '0', '1' };
+
+  // Header of a cache file, followed by the encoded root elements.
+  struct vtkSIProxyDefinitionCacheHeader
+    {
+    char Magic[8];
+    vtkTypeUInt32 ByteOrder; // 0x01020304 in the native byte order.
+    vtkTypeUInt32 NumberOfRoots;
+    vtkTypeUInt64 Hash;
+    vtkTypeUInt64 Length; // of the encoded elements.
+    };
+
+  //-------------------------------------------------------------------------
+  // 64 bits FNV-1a hash of the xmls.
+  vtkTypeUInt64 vtkSIProxyDefinitionCacheHash(vtkStringList* xmls,
+    bool attachHints)
+    {
+    vtkTypeUInt64 hash = 14695981039346656037ULL;
+    for (int cc=0; cc < xmls->GetNumberOfStrings(); cc++)
+      {
+      // hash the terminating null too, to separate the xmls.
+      const unsigned char* xml =
+        reinterpret_cast<const unsigned char*>(xmls->GetString(cc));
+      do
+        {
+        hash = (hash ^ *xml) * 1099511628211ULL;
+        }
+      while (*xml++);
+      }
+    return (hash ^ (attachHints? 1 : 0)) * 1099511628211ULL;
+    }
+
+  //-------------------------------------------------------------------------
+  // Returns the cache file to use for the given hash or an empty string if
+  // caching is disabled.
+  vtkstd::string vtkSIProxyDefinitionCacheFile(vtkTypeUInt64 hash)
+    {
+    const char* dir = getenv("PV_PROXY_DEFINITION_CACHE_DIR");
+    if (!dir || !*dir)
+      {
+      return vtkstd::string();
+      }
+    char name[64];
+    sprintf(name, "/pvdefs-%08x%08x.bin",
+      static_cast<unsigned int>(hash >> 32),
+      static_cast<unsigned int>(hash & 0xffffffff));
+    return vtkstd::string(dir) + name;
+    }
+
+  //-------------------------------------------------------------------------
+  // Reads the root elements saved in the cache file. Returns false if the
+  // file does not exist or cannot be used.
+  bool vtkSIProxyDefinitionCacheRead(const vtkstd::string& fname,
+    vtkTypeUInt64 hash, vtkstd::vector<XMLElement>& roots)
+    {
+    FILE* file = fopen(fname.c_str(), "rb");
+    if (!file)
+      {
+      return false;
+      }
+
+    // Only the header is checked, the encoded elements are validated while
+    // being read.
+    vtkSIProxyDefinitionCacheHeader header;
+    vtkstd::vector<char> buffer;
+    bool valid =
+      fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.Magic, vtkSIProxyDefinitionCacheMagic, 8) == 0 &&
+      header.ByteOrder == 0x01020304 && header.Hash == hash &&
+      header.Length > 0 && header.Length < 0x7fffffff;
+    if (valid)
+      {
+      buffer.resize(static_cast<size_t>(header.Length));
+      valid = fread(&buffer[0], 1, buffer.size(), file) == buffer.size();
+      }
+    fclose(file);
+
+    const char* data = valid? &buffer[0] : NULL;
+    const char* end = data + buffer.size();
+    for (vtkTypeUInt32 cc=0; valid && cc < header.NumberOfRoots; cc++)
+      {
+      vtkPVXMLElement* root = vtkPVXMLElement::ReadBinary(data, end);
+      if (root)
+        {
+        roots.push_back(root);
+        root->Delete();
+        }
+      valid = (root != NULL);
+      }
+    if (!valid || data != end)
+      {
+      roots.clear();
+      return false;
+      }
+    return true;
+    }
+
+  //-------------------------------------------------------------------------
+  // Saves the root elements in the cache file. The file is written under a
+  // temporary name and then renamed so that concurrent processes never read
+  // a partial file.
+  void vtkSIProxyDefinitionCacheWrite(const vtkstd::string& fname,
+    vtkTypeUInt64 hash, const vtkstd::vector<XMLElement>& roots)
+    {
+    vtkStdString buffer;
+    for (size_t cc=0; cc < roots.size(); cc++)
+      {
+      roots[cc]->WriteBinary(buffer);
+      }
+
+    vtkSIProxyDefinitionCacheHeader header;
+    memcpy(header.Magic, vtkSIProxyDefinitionCacheMagic, 8);
+    header.ByteOrder = 0x01020304;
+    header.NumberOfRoots = static_cast<vtkTypeUInt32>(roots.size());
+    header.Hash = hash;
+    header.Length = buffer.size();
+
+    vtksys_ios::ostringstream tmpname;
+    tmpname << fname << "." << getpid() << ".tmp";
+    FILE* file = fopen(tmpname.str().c_str(), "wb");
+    if (!file)
+      {
+      return;
+      }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(buffer.c_str(), 1, buffer.size(), file) == buffer.size();
+    written = (fclose(file) == 0) && written;
+    if (!written || rename(tmpname.str().c_str(), fname.c_str()) != 0)
+      {
+      vtksys::SystemTools::RemoveFile(tmpname.str().c_str());
+      }
+    }
+};
+
 //****************************************************************************/
 vtkStandardNewMacro(vtkSIProxyDefinitionManager)
 vtkStandardNewMacro(vtkInternalDefinitionIterator)
@@ -484,6 +651,7 @@ void vtkSIProxyDefinitionManager::AddElement(const char* groupName,
     if(coreElem)
       {
       // We found it, so we can extend it
+      this->Internals->PulledStateValid = false;
       for (unsigned int cc=0; cc < element->GetNumberOfNestedElements(); cc++)
         {
         coreElem->AddNestedElement(element->GetNestedElement(cc));
@@ -499,6 +667,7 @@ void vtkSIProxyDefinitionManager::AddElement(const char* groupName,
     {
     // Just referenced it
     this->Internals->CoreDefinitions[groupName][proxyName] = element;
+    this->Internals->PulledStateValid = false;
     if(this->TriggerNotificationEvent)
       {
       RegisteredDefinitionInformation info(groupName, proxyName, false);
@@ -530,6 +699,7 @@ vtkPVXMLElement* vtkSIProxyDefinitionManager::GetProxyDefinition(
 void vtkSIProxyDefinitionManager::ClearCustomProxyDefinitions()
 {
   this->Internals->CustomsDefinitions.clear();
+  this->Internals->PulledStateValid = false;
   if(this->TriggerNotificationEvent)
     {
     this->InvokeEvent(
@@ -544,6 +714,7 @@ void vtkSIProxyDefinitionManager::RemoveCustomProxyDefinition(
   if (this->Internals->HasCustomDefinition(groupName, proxyName))
     {
     this->Internals->CustomsDefinitions[groupName].erase(proxyName);
+    this->Internals->PulledStateValid = false;
 
     // Let the world know that definitions may have changed.
     if(this->TriggerNotificationEvent)
@@ -666,6 +837,7 @@ void vtkSIProxyDefinitionManager::AddCustomProxyDefinition(
   else
     {
     this->Internals->CustomsDefinitions[groupName][proxyName] = top;
+    this->Internals->PulledStateValid = false;
 
     // Let the world know that definitions may have changed.
     if(this->TriggerNotificationEvent)
@@ -814,6 +986,52 @@ bool vtkSIProxyDefinitionManager::LoadConfigurationXML(vtkPVXMLElement* root, bo
   return true;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSIProxyDefinitionManager::LoadConfigurationXMLs(vtkStringList* xmls,
+                                                        bool attachHints)
+{
+  vtkTypeUInt64 hash = vtkSIProxyDefinitionCacheHash(xmls, attachHints);
+  vtkstd::string cacheFile = vtkSIProxyDefinitionCacheFile(hash);
+
+  vtkstd::vector<XMLElement> roots;
+  if (cacheFile.empty() ||
+    !vtkSIProxyDefinitionCacheRead(cacheFile, hash, roots))
+    {
+    for (int cc=0; cc < xmls->GetNumberOfStrings(); cc++)
+      {
+      vtkNew<vtkPVXMLParser> parser;
+      if (!parser->Parse(xmls->GetString(cc)))
+        {
+        vtkErrorMacro("Failed to parse server manager configuration xml.");
+        return false;
+        }
+      roots.push_back(parser->GetRootElement());
+      if (attachHints)
+        {
+        this->AttachShowInMenuHintsToProxyFromProxyGroups(
+          parser->GetRootElement());
+        }
+      }
+
+    // Only one process of a parallel job writes the cache.
+    vtkMultiProcessController* controller =
+      vtkMultiProcessController::GetGlobalController();
+    if (!cacheFile.empty() &&
+      (!controller || controller->GetLocalProcessId() == 0))
+      {
+      vtkSIProxyDefinitionCacheWrite(cacheFile, hash, roots);
+      }
+    }
+
+  // The hints, if requested, have already been attached before caching.
+  bool status = true;
+  for (size_t cc=0; cc < roots.size(); cc++)
+    {
+    status = this->LoadConfigurationXML(roots[cc], false) && status;
+    }
+  return status;
+}
+
 //---------------------------------------------------------------------------
 void vtkSIProxyDefinitionManager::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -1059,14 +1277,18 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
 {
   // Setup required message header
   msg->Clear();
+
+  // Serializing every definition is expensive, reuse the previous state
+  // unless some definition has been added or removed since.
+  if (this->Internals->PulledStateValid)
+    {
+    msg->CopyFrom(this->Internals->PulledState);
+    return;
+    }
+
   msg->set_global_id(vtkSIProxyDefinitionManager::GetReservedGlobalID());
   msg->set_location(vtkPVSession::DATA_SERVER);
 
-  // This is made in a naive way, but we are sure that at each request
-  // we have the correct and latest definition available.
-  // This is not the most efficient way to do it. But optimistation should come
-  // after. And for now, it is the less intrusive way to deal with server
-  // XML definition centralisation state.
   ProxyDefinitionState_ProxyXMLDefinition *xmlDef;
   vtkPVProxyDefinitionIterator* iter;
 
@@ -1103,6 +1325,9 @@ void vtkSIProxyDefinitionManager::Pull(vtkSMMessage* msg)
     iter->GoToNextItem();
     }
   iter->Delete();
+
+  this->Internals->PulledState.CopyFrom(*msg);
+  this->Internals->PulledStateValid = true;
 }
 
 //---------------------------------------------------------------------------
@@ -1160,10 +1385,12 @@ void vtkSIProxyDefinitionManager::HandlePlugin(vtkPVPlugin* plugin)
     {
     vtkstd::vector<vtkstd::string> xmls;
     smplugin->GetXMLs(xmls);
+    vtkNew<vtkStringList> xmlList;
     for (size_t cc=0; cc < xmls.size(); cc++)
       {
-      this->LoadConfigurationXMLFromString(xmls[cc].c_str(), true);
+      xmlList->AddString(xmls[cc].c_str());
       }
+    this->LoadConfigurationXMLs(xmlList.GetPointer(), true);
     }
 }
 //---------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 class vtkPVPlugin;
 class vtkPVProxyDefinitionIterator;
 class vtkPVXMLElement;
+class vtkStringList;
 
 class VTK_EXPORT vtkSIProxyDefinitionManager : public vtkSIObject
 {
@@ -222,6 +223,15 @@ protected:
   bool LoadConfigurationXML(vtkPVXMLElement* root, bool attachShowInMenuHints);
   bool LoadConfigurationXMLFromString(const char* xmlContent, bool attachShowInMenuHints);
 
+  // Description:
+  // Loads a set of server-manager configuration xmls. This is used for the
+  // xmls compiled in the executables and for the plugin xmls. When the
+  // environment variable PV_PROXY_DEFINITION_CACHE_DIR is set, the parsed
+  // xmls are cached in that directory under a name derived from their
+  // content, so that the next processes loading the same xmls don't have to
+  // parse them again.
+  bool LoadConfigurationXMLs(vtkStringList* xmls, bool attachShowInMenuHints);
+
   // Description:
   // Callback called when a plugin is loaded.
   void OnPluginLoaded(vtkObject* caller, unsigned long event, void* calldata);
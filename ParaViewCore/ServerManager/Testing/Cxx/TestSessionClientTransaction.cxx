@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSessionClientTransaction.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the states pushed during a transaction of vtkSMSessionClient are
+// only folded into the previous push of the same proxy, so that the push
+// order is kept.
+
+#include "vtkObjectFactory.h"
+#include "vtkPVSession.h"
+#include "vtkSMMessage.h"
+#include "vtkSMSessionClient.h"
+
+// Gives access to SendPushState() without a server connection.
+class vtkTestSessionClient : public vtkSMSessionClient
+{
+public:
+  static vtkTestSessionClient* New();
+  vtkTypeMacro(vtkTestSessionClient, vtkSMSessionClient);
+
+  void Send(vtkSMMessage* message)
+    {
+    this->SendPushState(vtkPVSession::DATA_SERVER, message);
+    }
+};
+vtkStandardNewMacro(vtkTestSessionClient);
+
+//----------------------------------------------------------------------------
+static void SetupCreation(vtkSMMessage& message, vtkTypeUInt64 gid)
+{
+  message.set_global_id(gid);
+  message.set_location(vtkPVSession::DATA_SERVER);
+  message.SetExtension(ProxyState::xml_group, "sources");
+  message.SetExtension(ProxyState::xml_name, "SphereSource");
+}
+
+//----------------------------------------------------------------------------
+static void SetupProperty(vtkSMMessage& message, vtkTypeUInt64 gid,
+  const char* name, double value)
+{
+  message.set_global_id(gid);
+  message.set_location(vtkPVSession::DATA_SERVER);
+  ProxyState_Property* prop = message.AddExtension(ProxyState::property);
+  prop->set_name(name);
+  Variant* variant = prop->mutable_value();
+  variant->set_type(Variant::FLOAT64);
+  variant->add_float64(value);
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  vtkTestSessionClient* session = vtkTestSessionClient::New();
+  session->BeginTransaction();
+
+  // Creation of proxy 1, then one of its properties: folded together.
+  vtkSMMessage create1, radius1;
+  SetupCreation(create1, 1);
+  session->Send(&create1);
+  SetupProperty(radius1, 1, "Radius", 1.0);
+  session->Send(&radius1);
+  if (session->GetNumberOfPendingStates() != 1)
+    {
+    cerr << "ERROR: consecutive pushes of the same proxy must be folded"
+      << endl;
+    return 1;
+    }
+
+  // Creation of proxy 2 then a property of proxy 1 (e.g. one referring to
+  // proxy 2): must stay after the creation of proxy 2.
+  vtkSMMessage create2, center1, radius1Again;
+  SetupCreation(create2, 2);
+  session->Send(&create2);
+  SetupProperty(center1, 1, "Center", 2.0);
+  session->Send(&center1);
+  if (session->GetNumberOfPendingStates() != 3)
+    {
+    cerr << "ERROR: a push must not be folded across pushes of another proxy"
+      << endl;
+    return 1;
+    }
+
+  // Another property of proxy 1 is folded into the last push.
+  SetupProperty(radius1Again, 1, "Radius", 3.0);
+  session->Send(&radius1Again);
+  if (session->GetNumberOfPendingStates() != 3)
+    {
+    cerr << "ERROR: consecutive property pushes must be folded" << endl;
+    return 1;
+    }
+
+  vtkTypeUInt64 expected[3] = { 1, 2, 1 };
+  for (int cc=0; cc < 3; cc++)
+    {
+    if (session->GetPendingState(cc)->global_id() != expected[cc])
+      {
+      cerr << "ERROR: push order not kept" << endl;
+      return 1;
+      }
+    }
+
+  const vtkSMMessage* last = session->GetPendingState(2);
+  if (last->ExtensionSize(ProxyState::property) != 2 ||
+    last->GetExtension(ProxyState::property, 1).value().float64(0) != 3.0)
+    {
+    cerr << "ERROR: properties not merged in the last push" << endl;
+    return 1;
+    }
+  const vtkSMMessage* first = session->GetPendingState(0);
+  if (first->ExtensionSize(ProxyState::property) != 1 ||
+    first->GetExtension(ProxyState::property, 0).value().float64(0) != 1.0)
+    {
+    cerr << "ERROR: a later value leaked into an earlier push" << endl;
+    return 1;
+    }
+
+  // Nothing is connected, the flush only empties the queue.
+  session->CommitTransaction();
+  if (session->GetNumberOfPendingStates() != 0)
+    {
+    cerr << "ERROR: queue not flushed" << endl;
+    return 1;
+    }
+  session->Delete();
+  return 0;
+}
@@ -51,6 +51,21 @@ struct vtkSMArrayListDomainInternals
   vtkstd::map<int,int> DomainAssociation;
   vtkstd::vector<vtkSMArrayListDomainInformationKey> InformationKeys;
 
+  // What the list was last built from. Rebuilding it is expensive for inputs
+  // with many arrays, so Update() skips it when none of these changed.
+  bool LastValid;
+  vtkSMSourceProxy* LastSource;
+  int LastOutputPort;
+  unsigned long LastInformationTime;
+  int LastFieldDataSelection;
+  int LastAutomaticPropertyConversion;
+
+  vtkSMArrayListDomainInternals() : LastValid(false), LastSource(0),
+    LastOutputPort(0), LastInformationTime(0), LastFieldDataSelection(-1),
+    LastAutomaticPropertyConversion(0)
+    {
+    }
+
   void SetAssociations(int index, int field, int domain)
     {
     this->FieldAssociation[index] = field;
@@ -58,6 +73,46 @@ struct vtkSMArrayListDomainInternals
     }
 };
 
+//---------------------------------------------------------------------------
+namespace
+{
+  // Returns the first input of the property, looking at the unchecked
+  // proxies first.
+  vtkSMSourceProxy* vtkSMArrayListDomainGetInput(vtkSMProxyProperty* pp,
+    int& outputport)
+    {
+    vtkSMInputProperty* ip = vtkSMInputProperty::SafeDownCast(pp);
+
+    unsigned int i;
+    unsigned int numProxs = pp->GetNumberOfUncheckedProxies();
+    for (i=0; i<numProxs; i++)
+      {
+      vtkSMSourceProxy* sp =
+        vtkSMSourceProxy::SafeDownCast(pp->GetUncheckedProxy(i));
+      if (sp)
+        {
+        outputport = (ip? ip->GetUncheckedOutputPortForConnection(i) : 0);
+        return sp;
+        }
+      }
+
+    // In case there is no valid unchecked proxy, use the actual
+    // proxy values
+    numProxs = pp->GetNumberOfProxies();
+    for (i=0; i<numProxs; i++)
+      {
+      vtkSMSourceProxy* sp =
+        vtkSMSourceProxy::SafeDownCast(pp->GetProxy(i));
+      if (sp)
+        {
+        outputport = (ip? ip->GetOutputPortForConnection(i) : 0);
+        return sp;
+        }
+      }
+    return NULL;
+    }
+};
+
 //---------------------------------------------------------------------------
 vtkSMArrayListDomain::vtkSMArrayListDomain()
 {
@@ -365,41 +420,57 @@ void vtkSMArrayListDomain::Update(vtkSMProxyProperty* pp,
 //---------------------------------------------------------------------------
 void vtkSMArrayListDomain::Update(vtkSMProxyProperty* pp)
 {
-  vtkSMInputProperty* ip = vtkSMInputProperty::SafeDownCast(pp);
-
-  unsigned int i;
-  unsigned int numProxs = pp->GetNumberOfUncheckedProxies();
-  for (i=0; i<numProxs; i++)
+  int outputport = 0;
+  vtkSMSourceProxy* sp = vtkSMArrayListDomainGetInput(pp, outputport);
+  if (sp)
     {
-    vtkSMSourceProxy* sp =
-      vtkSMSourceProxy::SafeDownCast(pp->GetUncheckedProxy(i));
-    if (sp)
-      {
-      this->Update(pp, sp,
-        (ip? ip->GetUncheckedOutputPortForConnection(i) : 0));
-      return;
-      }
-    }
-
-  // In case there is no valid unchecked proxy, use the actual
-  // proxy values
-  numProxs = pp->GetNumberOfProxies();
-  for (i=0; i<numProxs; i++)
-    {
-    vtkSMSourceProxy* sp =
-      vtkSMSourceProxy::SafeDownCast(pp->GetProxy(i));
-    if (sp)
-      {
-      this->Update(pp, sp,
-        (ip? ip->GetOutputPortForConnection(i) : 0));
-      return;
-      }
+    this->Update(pp, sp, outputport);
     }
 }
 
 //---------------------------------------------------------------------------
 void vtkSMArrayListDomain::Update(vtkSMProperty*)
 {
+  vtkSMProxyProperty* pp = vtkSMProxyProperty::SafeDownCast(
+    this->GetRequiredProperty("Input"));
+
+  // Skip the update if the input, its data information and the selected
+  // field are the same as for the previous one.
+  int outputport = 0;
+  vtkSMSourceProxy* sp = pp? vtkSMArrayListDomainGetInput(pp, outputport) : 0;
+  unsigned long informationTime = 0;
+  if (sp)
+    {
+    sp->CreateOutputPorts();
+    vtkPVDataInformation* info = sp->GetDataInformation(outputport);
+    informationTime = info? info->GetMTime() : 0;
+    }
+  int fieldDataSelection = -1;
+  vtkSMIntVectorProperty* ivp = vtkSMIntVectorProperty::SafeDownCast(
+    this->GetRequiredProperty("FieldDataSelection"));
+  if (ivp && ivp->GetNumberOfElements() == 1)
+    {
+    fieldDataSelection = (ivp->GetNumberOfUncheckedElements() == 1)?
+      ivp->GetUncheckedElement(0) : ivp->GetElement(0);
+    }
+  int conversion = vtkSMInputArrayDomain::GetAutomaticPropertyConversion();
+
+  vtkSMArrayListDomainInternals* internals = this->ALDInternals;
+  if (internals->LastValid && internals->LastSource == sp &&
+    internals->LastOutputPort == outputport &&
+    internals->LastInformationTime == informationTime &&
+    internals->LastFieldDataSelection == fieldDataSelection &&
+    internals->LastAutomaticPropertyConversion == conversion)
+    {
+    return;
+    }
+  internals->LastValid = true;
+  internals->LastSource = sp;
+  internals->LastOutputPort = outputport;
+  internals->LastInformationTime = informationTime;
+  internals->LastFieldDataSelection = fieldDataSelection;
+  internals->LastAutomaticPropertyConversion = conversion;
+
   this->RemoveAllStrings();
   if (this->NoneString)
     {
@@ -408,8 +479,6 @@ void vtkSMArrayListDomain::Update(vtkSMProperty*)
       vtkDataObject::NUMBER_OF_ASSOCIATIONS;
     }
 
-  vtkSMProxyProperty* pp = vtkSMProxyProperty::SafeDownCast(
-    this->GetRequiredProperty("Input"));
   if (pp)
     {
     this->Update(pp);
@@ -692,6 +761,7 @@ unsigned int vtkSMArrayListDomain::AddInformationKey(const char* location, const
   key.Name = name;
   key.Strategy = strategy;
   this->ALDInternals->InformationKeys.push_back(key);
+  this->ALDInternals->LastValid = false;
   return this->ALDInternals->InformationKeys.size() - 1;
 }
 
@@ -707,6 +777,7 @@ unsigned int vtkSMArrayListDomain::RemoveInformationKey(const char* location, co
     if(key.Location == location && key.Name == name)
       {
       this->ALDInternals->InformationKeys.erase(it);
+      this->ALDInternals->LastValid = false;
       return index;
       }
     it++;
@@ -725,6 +796,7 @@ unsigned int vtkSMArrayListDomain::GetNumberOfInformationKeys()
 void vtkSMArrayListDomain::RemoveAllInformationKeys()
 {
   this->ALDInternals->InformationKeys.clear();
+  this->ALDInternals->LastValid = false;
 }
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,429 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSMBinaryStateLocator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSMBinaryStateLocator.h"
+
+#include "vtkByteSwap.h"
+#include "vtkObjectFactory.h"
+#include "vtkReservedRemoteObjectIds.h"
+#include "vtkSMMessage.h"
+#include "vtkSMProxyManager.h"
+#include "vtkSMSession.h"
+
+#include <string.h>
+#include <vtkstd/map>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+// File layout (all numbers are little-endian):
+//   char[8]   magic "PVSMBIN" followed by the format revision
+//   uint32    server manager version (major, minor, patch)
+//   uint32    number of states
+//   uint64    offset of the index
+//   ...       the serialized states
+//   index     for each state: uint32 global id, uint32 parent global id,
+//             uint64 offset, uint32 size
+namespace
+{
+  const char BINARY_STATE_MAGIC[8] = { 'P','V','S','M','B','I','N','1' };
+
+  //---------------------------------------------------------------------------
+  void WriteUInt32(ostream& os, vtkTypeUInt32 value)
+    {
+    vtkByteSwap::Swap4LE(static_cast<void*>(&value));
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+  //---------------------------------------------------------------------------
+  void WriteUInt64(ostream& os, vtkTypeUInt64 value)
+    {
+    vtkByteSwap::Swap8LE(static_cast<void*>(&value));
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+  //---------------------------------------------------------------------------
+  bool ReadUInt32(istream& is, vtkTypeUInt32& value)
+    {
+    if (!is.read(reinterpret_cast<char*>(&value), sizeof(value)))
+      {
+      return false;
+      }
+    vtkByteSwap::Swap4LE(static_cast<void*>(&value));
+    return true;
+    }
+
+  //---------------------------------------------------------------------------
+  bool ReadUInt64(istream& is, vtkTypeUInt64& value)
+    {
+    if (!is.read(reinterpret_cast<char*>(&value), sizeof(value)))
+      {
+      return false;
+      }
+    vtkByteSwap::Swap8LE(static_cast<void*>(&value));
+    return true;
+    }
+};
+
+//****************************************************************************
+class vtkSMBinaryStateLocator::vtkInternals
+{
+public:
+  struct StateEntry
+    {
+    vtkTypeUInt32 FileGlobalID;
+    vtkTypeUInt32 ParentGlobalID;
+    vtkTypeUInt64 Offset;
+    vtkTypeUInt32 Size;
+    };
+
+  // Entries of the file being read, indexed by their new global id.
+  vtkstd::map<vtkTypeUInt32, StateEntry> Index;
+
+  // Global ids of the file mapped to the ones used in the session.
+  vtkstd::map<vtkTypeUInt32, vtkTypeUInt32> GlobalIDMap;
+
+  ifstream* Stream;
+
+  // States to write.
+  struct PendingState
+    {
+    vtkTypeUInt32 GlobalID;
+    vtkTypeUInt32 ParentGlobalID;
+    vtkstd::string Data;
+    };
+  vtkstd::vector<PendingState> PendingStates;
+  vtkstd::map<vtkTypeUInt32, size_t> PendingStateIndex;
+
+  vtkInternals()
+    {
+    this->Stream = NULL;
+    }
+
+  ~vtkInternals()
+    {
+    this->Close();
+    }
+
+  void Close()
+    {
+    delete this->Stream;
+    this->Stream = NULL;
+    this->Index.clear();
+    this->GlobalIDMap.clear();
+    }
+
+  //---------------------------------------------------------------------------
+  vtkTypeUInt32 MapGlobalID(vtkTypeUInt64 id)
+    {
+    if (id < vtkReservedRemoteObjectIds::RESERVED_MAX_IDS)
+      {
+      return static_cast<vtkTypeUInt32>(id);
+      }
+    vtkstd::map<vtkTypeUInt32, vtkTypeUInt32>::iterator iter =
+      this->GlobalIDMap.find(static_cast<vtkTypeUInt32>(id));
+    // References to proxies that were not saved are dropped.
+    return iter != this->GlobalIDMap.end()? iter->second : 0;
+    }
+
+  //---------------------------------------------------------------------------
+  // Replace the global ids of the file by the ones of the session in all the
+  // places a state may refer to a proxy.
+  void MapGlobalIDs(vtkSMMessage* state)
+    {
+    state->set_global_id(this->MapGlobalID(state->global_id()));
+
+    int nbSubProxies = state->ExtensionSize(ProxyState::subproxy);
+    for (int cc=0; cc < nbSubProxies; cc++)
+      {
+      ProxyState_SubProxy* subproxy =
+        state->MutableExtension(ProxyState::subproxy, cc);
+      subproxy->set_global_id(this->MapGlobalID(subproxy->global_id()));
+      }
+
+    int nbProperties = state->ExtensionSize(ProxyState::property);
+    for (int cc=0; cc < nbProperties; cc++)
+      {
+      ProxyState_Property* prop =
+        state->MutableExtension(ProxyState::property, cc);
+      if (!prop->has_value())
+        {
+        continue;
+        }
+      Variant* value = prop->mutable_value();
+      for (int i=0; i < value->proxy_global_id_size(); i++)
+        {
+        value->set_proxy_global_id(i,
+          this->MapGlobalID(value->proxy_global_id(i)));
+        }
+      }
+
+    int nbRegistrations =
+      state->ExtensionSize(ProxyManagerState::registered_proxy);
+    for (int cc=0; cc < nbRegistrations; cc++)
+      {
+      ProxyManagerState_ProxyRegistrationInfo* reg =
+        state->MutableExtension(ProxyManagerState::registered_proxy, cc);
+      reg->set_global_id(this->MapGlobalID(reg->global_id()));
+      }
+    }
+};
+
+//****************************************************************************
+vtkStandardNewMacro(vtkSMBinaryStateLocator);
+//----------------------------------------------------------------------------
+vtkSMBinaryStateLocator::vtkSMBinaryStateLocator()
+{
+  this->FileName = 0;
+  this->FileVersion[0] = this->FileVersion[1] = this->FileVersion[2] = 0;
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkSMBinaryStateLocator::~vtkSMBinaryStateLocator()
+{
+  this->SetFileName(0);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMBinaryStateLocator::Open(vtkSMSession* session)
+{
+  this->Internals->Close();
+  if (!this->FileName || !session)
+    {
+    vtkErrorMacro("FileName and session must be set.");
+    return false;
+    }
+
+  ifstream* stream = new ifstream(this->FileName, ios::in | ios::binary);
+  char magic[8];
+  if (!stream->is_open() ||
+    !stream->read(magic, 8) ||
+    memcmp(magic, BINARY_STATE_MAGIC, 8) != 0)
+    {
+    vtkErrorMacro("Not a binary state file: " << this->FileName);
+    delete stream;
+    return false;
+    }
+
+  vtkTypeUInt32 version[3], count;
+  vtkTypeUInt64 indexOffset;
+  if (!ReadUInt32(*stream, version[0]) || !ReadUInt32(*stream, version[1]) ||
+    !ReadUInt32(*stream, version[2]) || !ReadUInt32(*stream, count) ||
+    !ReadUInt64(*stream, indexOffset) ||
+    !stream->seekg(static_cast<streamoff>(indexOffset)))
+    {
+    vtkErrorMacro("Truncated binary state file: " << this->FileName);
+    delete stream;
+    return false;
+    }
+  for (int cc=0; cc < 3; cc++)
+    {
+    this->FileVersion[cc] = static_cast<int>(version[cc]);
+    }
+
+  vtkstd::vector<vtkInternals::StateEntry> entries(count);
+  for (vtkTypeUInt32 cc=0; cc < count; cc++)
+    {
+    vtkInternals::StateEntry& entry = entries[cc];
+    if (!ReadUInt32(*stream, entry.FileGlobalID) ||
+      !ReadUInt32(*stream, entry.ParentGlobalID) ||
+      !ReadUInt64(*stream, entry.Offset) ||
+      !ReadUInt32(*stream, entry.Size))
+      {
+      vtkErrorMacro("Truncated binary state file: " << this->FileName);
+      delete stream;
+      return false;
+      }
+
+    // Reserve a new global id for the state. Only ids are handed out here,
+    // the state itself is parsed when requested.
+    vtkTypeUInt32 newID = entry.FileGlobalID;
+    if (entry.FileGlobalID >= vtkReservedRemoteObjectIds::RESERVED_MAX_IDS)
+      {
+      newID = session->GetNextGlobalUniqueIdentifier();
+      }
+    this->Internals->GlobalIDMap[entry.FileGlobalID] = newID;
+    }
+
+  for (vtkTypeUInt32 cc=0; cc < count; cc++)
+    {
+    vtkInternals::StateEntry& entry = entries[cc];
+    entry.ParentGlobalID = this->Internals->MapGlobalID(entry.ParentGlobalID);
+    this->Internals->Index[
+      this->Internals->MapGlobalID(entry.FileGlobalID)] = entry;
+    }
+
+  this->Internals->Stream = stream;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSMBinaryStateLocator::GetNumberOfStates()
+{
+  return static_cast<unsigned int>(this->Internals->Stream?
+    this->Internals->Index.size() : this->Internals->PendingStates.size());
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMBinaryStateLocator::FindState(vtkTypeUInt32 globalID,
+  vtkSMMessage* stateToFill)
+{
+  if (stateToFill == NULL)
+    {
+    return false;
+    }
+
+  vtkstd::map<vtkTypeUInt32, vtkInternals::StateEntry>::iterator iter =
+    this->Internals->Index.find(globalID);
+  if (this->Superclass::IsStateLocal(globalID) ||
+    iter == this->Internals->Index.end() ||
+    this->Internals->Stream == NULL)
+    {
+    return this->Superclass::FindState(globalID, stateToFill);
+    }
+
+  ifstream* stream = this->Internals->Stream;
+  vtkstd::string data;
+  data.resize(iter->second.Size);
+  stream->clear();
+  if (!stream->seekg(static_cast<streamoff>(iter->second.Offset)) ||
+    (iter->second.Size > 0 && !stream->read(&data[0], iter->second.Size)))
+    {
+    vtkErrorMacro("Failed to read state " << globalID << " from "
+      << this->FileName);
+    return false;
+    }
+
+  stateToFill->Clear();
+  if (!stateToFill->ParseFromString(data))
+    {
+    vtkErrorMacro("Failed to parse state " << globalID << " from "
+      << this->FileName);
+    return false;
+    }
+  this->Internals->MapGlobalIDs(stateToFill);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMBinaryStateLocator::IsStateLocal(vtkTypeUInt32 globalID)
+{
+  return (this->Internals->Index.find(globalID) !=
+    this->Internals->Index.end()) || this->Superclass::IsStateLocal(globalID);
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMBinaryStateLocator::GetParentGlobalID(
+  vtkTypeUInt32 globalID)
+{
+  vtkstd::map<vtkTypeUInt32, vtkInternals::StateEntry>::iterator iter =
+    this->Internals->Index.find(globalID);
+  return iter != this->Internals->Index.end()? iter->second.ParentGlobalID : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMBinaryStateLocator::AddState(const vtkSMMessage* state,
+  vtkTypeUInt32 parentID)
+{
+  vtkTypeUInt32 globalID = static_cast<vtkTypeUInt32>(state->global_id());
+  vtkstd::map<vtkTypeUInt32, size_t>::iterator iter =
+    this->Internals->PendingStateIndex.find(globalID);
+  if (iter != this->Internals->PendingStateIndex.end())
+    {
+    // Already added, simply record its parent if it was unknown.
+    vtkInternals::PendingState& pending =
+      this->Internals->PendingStates[iter->second];
+    if (pending.ParentGlobalID == 0)
+      {
+      pending.ParentGlobalID = parentID;
+      }
+    return;
+    }
+
+  vtkInternals::PendingState pending;
+  pending.GlobalID = globalID;
+  pending.ParentGlobalID = parentID;
+  state->SerializeToString(&pending.Data);
+  this->Internals->PendingStateIndex[globalID] =
+    this->Internals->PendingStates.size();
+  this->Internals->PendingStates.push_back(pending);
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMBinaryStateLocator::Write()
+{
+  if (!this->FileName)
+    {
+    vtkErrorMacro("FileName must be set.");
+    return false;
+    }
+
+  ofstream os(this->FileName, ios::out | ios::binary);
+  if (!os)
+    {
+    vtkErrorMacro("Failed to open " << this->FileName << " for writing.");
+    return false;
+    }
+
+  vtkstd::vector<vtkInternals::PendingState>& states =
+    this->Internals->PendingStates;
+  const vtkTypeUInt64 headerSize = 8 + 4 * sizeof(vtkTypeUInt32) +
+    sizeof(vtkTypeUInt64);
+  vtkTypeUInt64 indexOffset = headerSize;
+  for (size_t cc=0; cc < states.size(); cc++)
+    {
+    indexOffset += states[cc].Data.size();
+    }
+
+  os.write(BINARY_STATE_MAGIC, 8);
+  WriteUInt32(os, vtkSMProxyManager::GetVersionMajor());
+  WriteUInt32(os, vtkSMProxyManager::GetVersionMinor());
+  WriteUInt32(os, vtkSMProxyManager::GetVersionPatch());
+  WriteUInt32(os, static_cast<vtkTypeUInt32>(states.size()));
+  WriteUInt64(os, indexOffset);
+
+  for (size_t cc=0; cc < states.size(); cc++)
+    {
+    os.write(states[cc].Data.data(), states[cc].Data.size());
+    }
+
+  vtkTypeUInt64 offset = headerSize;
+  for (size_t cc=0; cc < states.size(); cc++)
+    {
+    WriteUInt32(os, states[cc].GlobalID);
+    WriteUInt32(os, states[cc].ParentGlobalID);
+    WriteUInt64(os, offset);
+    WriteUInt32(os, static_cast<vtkTypeUInt32>(states[cc].Data.size()));
+    offset += states[cc].Data.size();
+    }
+
+  if (!os)
+    {
+    vtkErrorMacro("Failed to write " << this->FileName);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMBinaryStateLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: "
+     << (this->FileName? this->FileName : "(none)") << endl;
+  os << indent << "FileVersion: " << this->FileVersion[0] << "."
+     << this->FileVersion[1] << "." << this->FileVersion[2] << endl;
+  os << indent << "NumberOfStates: " << this->GetNumberOfStates() << endl;
+}
@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkSMBinaryStateLocator.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMBinaryStateLocator - state locator backed by a binary state file.
+// .SECTION Description
+// vtkSMBinaryStateLocator reads and writes the binary state files used by
+// vtkSMProxyManager::SaveBinaryState() and
+// vtkSMProxyManager::LoadBinaryState(). A binary state file stores the
+// vtkSMMessage states (as returned by GetFullState()) of the proxy manager and
+// of every saved proxy, followed by an index giving, for each state, its
+// global id, the global id of its parent proxy (for sub-proxies) and its
+// location in the file.
+//
+// When reading, only the header and the index are loaded by Open(). The
+// states are parsed from the file one at a time, when FindState() asks for
+// them, so proxies that are never needed are never parsed. Since the global
+// ids stored in the file may already be in use in the current session, Open()
+// assigns a new global id to each state of the file and FindState() expects
+// and returns the new ids.
+// .SECTION See Also
+// vtkSMStateLocator vtkSMProxyManager
+
+#ifndef __vtkSMBinaryStateLocator_h
+#define __vtkSMBinaryStateLocator_h
+
+#include "vtkSMStateLocator.h"
+
+class vtkSMSession;
+
+class VTK_EXPORT vtkSMBinaryStateLocator : public vtkSMStateLocator
+{
+public:
+  static vtkSMBinaryStateLocator* New();
+  vtkTypeMacro(vtkSMBinaryStateLocator, vtkSMStateLocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Name of the file to read from or to write to.
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  // Description:
+  // Read the header and the index of FileName. New global ids are taken from
+  // the given session for every state in the file. Returns false if the file
+  // could not be read or is not a binary state file.
+  bool Open(vtkSMSession* session);
+
+  // Description:
+  // Returns the version of the server manager that wrote the file. Valid
+  // after Open().
+  vtkGetVector3Macro(FileVersion, int);
+
+  // Description:
+  // Returns the number of states in the file (or added with AddState()).
+  unsigned int GetNumberOfStates();
+
+//BTX
+  // Description:
+  // Fill the provided state with the one found in the file. The states
+  // registered with RegisterState() take precedence over the ones of the
+  // file.
+  virtual bool FindState(vtkTypeUInt32 globalID, vtkSMMessage* stateToFill);
+
+  // Description:
+  // Returns the global id of the proxy owning the sub-proxy identified by
+  // \c globalID or 0 if \c globalID is not a sub-proxy.
+  vtkTypeUInt32 GetParentGlobalID(vtkTypeUInt32 globalID);
+
+  // Description:
+  // Add a state to be saved by Write(). \c parentID is the global id of the
+  // proxy owning that state, if any.
+  void AddState(const vtkSMMessage* state, vtkTypeUInt32 parentID);
+//ETX
+
+  // Description:
+  // Return true if the given state is in the file or was registered locally.
+  virtual bool IsStateLocal(vtkTypeUInt32 globalID);
+
+  // Description:
+  // Write all the states added with AddState() to FileName.
+  bool Write();
+
+protected:
+  vtkSMBinaryStateLocator();
+  ~vtkSMBinaryStateLocator();
+
+  char* FileName;
+  int FileVersion[3];
+
+private:
+  vtkSMBinaryStateLocator(const vtkSMBinaryStateLocator&); // Not implemented
+  void operator=(const vtkSMBinaryStateLocator&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
@@ -18,10 +18,12 @@
 #include "vtkObjectFactory.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSMMessage.h"
+#include "vtkSMOutputPort.h"
 #include "vtkSMProxy.h"
 #include "vtkSMProxyLocator.h"
 #include "vtkSMProxyManager.h"
 #include "vtkSMSession.h"
+#include "vtkSMSourceProxy.h"
 #include "vtkSMStateLocator.h"
 
 #include <vtkstd/algorithm>
@@ -361,6 +363,34 @@ unsigned int vtkSMInputProperty::GetUncheckedOutputPortForConnection(
   return this->IPInternals->UncheckedOutputPorts[idx];
 }
 
+//---------------------------------------------------------------------------
+void vtkSMInputProperty::PrefetchDomainInformation()
+{
+  unsigned int numProxies = this->GetNumberOfProxies();
+  for (unsigned int cc=0; cc < numProxies; cc++)
+    {
+    vtkSMSourceProxy* source =
+      vtkSMSourceProxy::SafeDownCast(this->GetProxy(cc));
+    unsigned int port = this->GetOutputPortForConnection(cc);
+    if (source && port < source->GetNumberOfOutputPorts())
+      {
+      source->GetOutputPort(port)->PrefetchDataInformation();
+      }
+    }
+
+  unsigned int numUnchecked = this->GetNumberOfUncheckedProxies();
+  for (unsigned int cc=0; cc < numUnchecked; cc++)
+    {
+    vtkSMSourceProxy* source =
+      vtkSMSourceProxy::SafeDownCast(this->GetUncheckedProxy(cc));
+    unsigned int port = this->GetUncheckedOutputPortForConnection(cc);
+    if (source && port < source->GetNumberOfOutputPorts())
+      {
+      source->GetOutputPort(port)->PrefetchDataInformation();
+      }
+    }
+}
+
 //---------------------------------------------------------------------------
 vtkPVXMLElement* vtkSMInputProperty::AddProxyElementState(vtkPVXMLElement *prop,
                                                           unsigned int idx)
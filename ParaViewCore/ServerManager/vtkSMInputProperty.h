@@ -128,6 +128,11 @@ protected:
 
   virtual void RemoveAllProxies(int modify);
 
+  // Description:
+  // Requests the data information of all the (checked and unchecked) inputs
+  // at once, instead of letting each domain fetch them one after the other.
+  virtual void PrefetchDomainInformation();
+
   // Description:
   // Set the appropriate ivars from the xml element. Should
   // be overwritten by subclass if adding ivars.
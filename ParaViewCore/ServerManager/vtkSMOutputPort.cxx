@@ -47,6 +47,7 @@ vtkSMOutputPort::vtkSMOutputPort()
   this->TemporalDataInformation = vtkPVTemporalDataInformation::New();
   this->ClassNameInformationValid = 0;
   this->DataInformationValid = false;
+  this->DataInformationRequest = 0;
   this->TemporalDataInformationValid = false;
   this->PortIndex = 0;
   this->SourceProxy = 0;
@@ -56,6 +57,7 @@ vtkSMOutputPort::vtkSMOutputPort()
 //----------------------------------------------------------------------------
 vtkSMOutputPort::~vtkSMOutputPort()
 {
+  this->CompleteDataInformationRequest();
   this->SetSourceProxy(0);
   this->ClassNameInformation->Delete();
   this->DataInformation->Delete();
@@ -65,6 +67,7 @@ vtkSMOutputPort::~vtkSMOutputPort()
 //----------------------------------------------------------------------------
 vtkPVDataInformation* vtkSMOutputPort::GetDataInformation()
 {
+  this->CompleteDataInformationRequest();
   if (!this->DataInformationValid)
     {
     vtksys_ios::ostringstream mystr;
@@ -105,6 +108,8 @@ const char* vtkSMOutputPort::GetDataClassName()
 //----------------------------------------------------------------------------
 void vtkSMOutputPort::InvalidateDataInformation()
 {
+  // Do not let a reply arriving later overwrite the next data information.
+  this->CompleteDataInformationRequest();
   this->DataInformationValid = false;
   this->ClassNameInformationValid = false;
   this->TemporalDataInformationValid = false;
@@ -124,9 +129,57 @@ void vtkSMOutputPort::GatherDataInformation()
   this->DataInformation->SetPortNumber(this->PortIndex);
   this->SourceProxy->GatherInformation(this->DataInformation);
   this->DataInformationValid = true;
+  // The information object is reused, mark it modified so that the domains
+  // can tell new information apart.
+  this->DataInformation->Modified();
   this->SourceProxy->GetSession()->CleanupPendingProgress();
 }
 
+//----------------------------------------------------------------------------
+void vtkSMOutputPort::PrefetchDataInformation()
+{
+  if (!this->SourceProxy || this->DataInformationValid ||
+    this->DataInformationRequest != 0)
+    {
+    return;
+    }
+
+  // Progress is reported until the reply is received, as in
+  // GatherDataInformation().
+  vtkSMSession* session = this->SourceProxy->GetSession();
+  session->PrepareProgress();
+  this->DataInformation->Initialize();
+  this->DataInformation->SetPortNumber(this->PortIndex);
+  this->DataInformationRequest =
+    this->SourceProxy->GatherInformationAsync(this->DataInformation);
+  if (this->DataInformationRequest == 0)
+    {
+    this->DataInformationValid = true;
+    this->DataInformation->Modified();
+    session->CleanupPendingProgress();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMOutputPort::CompleteDataInformationRequest()
+{
+  if (this->DataInformationRequest == 0)
+    {
+    return;
+    }
+
+  vtkTypeUInt32 requestId = this->DataInformationRequest;
+  this->DataInformationRequest = 0;
+  vtkSMSession* session =
+    this->SourceProxy? this->SourceProxy->GetSession() : NULL;
+  this->DataInformationValid = session && session->WaitForReply(requestId);
+  this->DataInformation->Modified();
+  if (session)
+    {
+    session->CleanupPendingProgress();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMOutputPort::GatherTemporalDataInformation()
 {
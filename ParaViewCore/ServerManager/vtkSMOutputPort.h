@@ -63,6 +63,13 @@ public:
   // Returns classname information.
   virtual vtkPVClassNameInformation* GetClassNameInformation();
 
+  // Description:
+  // Sends the request for the data information without waiting for the
+  // reply, which is received by the next GetDataInformation(). Used to fetch
+  // the data information of several ports concurrently. Does nothing if the
+  // data information is valid.
+  void PrefetchDataInformation();
+
   // Description:
   // Mark data information as invalid.
   virtual void InvalidateDataInformation();
@@ -99,6 +106,11 @@ protected:
   // Fires the vtkCommand::UpdateInformationEvent event.
   virtual void GatherDataInformation();
 
+  // Description:
+  // Waits for the reply to the request sent by PrefetchDataInformation(), if
+  // any.
+  void CompleteDataInformationRequest();
+
   // Description:
   // Get temporal information from the server.
   virtual void GatherTemporalDataInformation();
@@ -120,6 +132,7 @@ protected:
   int ClassNameInformationValid;
   vtkPVDataInformation* DataInformation;
   bool DataInformationValid;
+  vtkTypeUInt32 DataInformationRequest;
 
   vtkPVTemporalDataInformation* TemporalDataInformation;
   bool TemporalDataInformationValid;
@@ -26,6 +26,8 @@
 #include "vtkSMProperty.h"
 #include "vtkSMProxy.h"
 
+#include <vtkstd/set>
+#include <vtkstd/utility>
 #include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 
@@ -33,6 +35,43 @@
 
 vtkStandardNewMacro(vtkSMProperty);
 
+namespace
+{
+  // Domain updates recorded between BeginDomainUpdates() and
+  // EndDomainUpdates().
+  struct vtkSMPropertyDomainUpdates
+    {
+    typedef vtkstd::pair<vtkSmartPointer<vtkSMDomain>,
+      vtkSmartPointer<vtkSMProperty> > UpdateType;
+    int Depth;
+    vtkstd::vector<UpdateType> Pending;
+    vtkstd::set<vtkstd::pair<vtkSMDomain*, vtkSMProperty*> > Recorded;
+    vtkSMPropertyDomainUpdates() : Depth(0) {}
+    };
+
+  vtkSMPropertyDomainUpdates& vtkSMPropertyGetDomainUpdates()
+    {
+    static vtkSMPropertyDomainUpdates updates;
+    return updates;
+    }
+
+  //---------------------------------------------------------------------------
+  void vtkSMPropertyUpdateDomain(vtkSMDomain* domain, vtkSMProperty* prop)
+    {
+    vtkSMPropertyDomainUpdates& updates = vtkSMPropertyGetDomainUpdates();
+    if (updates.Depth == 0)
+      {
+      domain->Update(prop);
+      }
+    else if (updates.Recorded.insert(
+        vtkstd::make_pair(domain, prop)).second)
+      {
+      updates.Pending.push_back(vtkSMPropertyDomainUpdates::UpdateType(
+          domain, prop));
+      }
+    }
+};
+
 vtkCxxSetObjectMacro(vtkSMProperty, InformationProperty, vtkSMProperty);
 vtkCxxSetObjectMacro(vtkSMProperty, Documentation, vtkSMDocumentation);
 vtkCxxSetObjectMacro(vtkSMProperty, Hints, vtkPVXMLElement);
@@ -203,11 +242,16 @@ void vtkSMProperty::RemoveAllDependents()
 //---------------------------------------------------------------------------
 void vtkSMProperty::UpdateDependentDomains()
 {
+  if (!this->PInternals->Dependents.empty())
+    {
+    this->PrefetchDomainInformation();
+    }
+
   // Update own domains
   this->DomainIterator->Begin();
   while(!this->DomainIterator->IsAtEnd())
     {
-    this->DomainIterator->GetDomain()->Update(0);
+    vtkSMPropertyUpdateDomain(this->DomainIterator->GetDomain(), 0);
     this->DomainIterator->Next();
     }
 
@@ -216,7 +260,32 @@ void vtkSMProperty::UpdateDependentDomains()
     this->PInternals->Dependents.begin();
   for (; iter != this->PInternals->Dependents.end(); iter++)
     {
-    iter->GetPointer()->Update(this);
+    vtkSMPropertyUpdateDomain(iter->GetPointer(), this);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSMProperty::BeginDomainUpdates()
+{
+  vtkSMPropertyGetDomainUpdates().Depth++;
+}
+
+//---------------------------------------------------------------------------
+void vtkSMProperty::EndDomainUpdates()
+{
+  vtkSMPropertyDomainUpdates& updates = vtkSMPropertyGetDomainUpdates();
+  if (updates.Depth == 0 || --updates.Depth > 0)
+    {
+    return;
+    }
+
+  // Domains updated now may cause other updates, those are not deferred.
+  vtkstd::vector<vtkSMPropertyDomainUpdates::UpdateType> pending;
+  pending.swap(updates.Pending);
+  updates.Recorded.clear();
+  for (size_t cc=0; cc < pending.size(); cc++)
+    {
+    pending[cc].first->Update(pending[cc].second);
     }
 }
 
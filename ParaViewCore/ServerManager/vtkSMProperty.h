@@ -146,6 +146,18 @@ public:
   // passes itself as the argument.
   void UpdateDependentDomains();
 
+  // Description:
+  // Domain updates can be grouped between BeginDomainUpdates() and
+  // EndDomainUpdates(). These calls can be nested. In between,
+  // UpdateDependentDomains() only sends the information requests the domains
+  // need and records the domains to update. The outermost
+  // EndDomainUpdates() then updates each recorded domain once per
+  // property, in the order in which they were first requested. Use this
+  // when several properties of a proxy are changed at once, so that a domain
+  // depending on several of them is not rebuilt for each.
+  static void BeginDomainUpdates();
+  static void EndDomainUpdates();
+
   // Description:
   // Static boolean used to determine whether domain checking should
   // be performed when setting values. On by default.
@@ -281,6 +293,12 @@ protected:
   // by vtkSMProxyProperty and sub-classes.
   virtual void UpdateAllInputs() {};
 
+  // Description:
+  // Called by UpdateDependentDomains() before updating the domains so that
+  // the information the domains are going to need can be requested from the
+  // server concurrently. Overwritten by vtkSMInputProperty.
+  virtual void PrefetchDomainInformation() {};
+
   // Description:
   // The name assigned by the xml parser. Used to get the property
   // from a proxy. Note that the name used to obtain a property
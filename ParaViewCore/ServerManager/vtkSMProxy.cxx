@@ -37,12 +37,56 @@
 #include "vtkSMStateLocator.h"
 
 #include <vtkstd/algorithm>
+#include <vtkstd/list>
 #include <vtkstd/string>
 #include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
 #include <assert.h>
 
+//---------------------------------------------------------------------------
+// Replace the entry for "prop" in the property list of "state". The entry is
+// expected at index "hint" (properties are kept in the same order as the
+// proxy's property map); other entries are searched otherwise. Appends when
+// the state has no entry for that property yet.
+static void vtkSMProxyUpdateStateProperty(vtkSMMessage* state, int hint,
+  const ProxyState_Property& prop)
+{
+  int nbProps = state->ExtensionSize(ProxyState::property);
+  if (hint >= 0 && hint < nbProps &&
+    state->GetExtension(ProxyState::property, hint).name() == prop.name())
+    {
+    state->MutableExtension(ProxyState::property, hint)->CopyFrom(prop);
+    return;
+    }
+  for (int cc=0; cc < nbProps; cc++)
+    {
+    if (state->GetExtension(ProxyState::property, cc).name() == prop.name())
+      {
+      state->MutableExtension(ProxyState::property, cc)->CopyFrom(prop);
+      return;
+      }
+    }
+  state->AddExtension(ProxyState::property)->CopyFrom(prop);
+}
+
+//---------------------------------------------------------------------------
+// Pull requests sent by UpdatePropertyInformation() for a proxy and its
+// sub-proxies. All of them are sent before waiting for the first reply so that
+// the whole proxy tree costs one round trip instead of one per proxy. A list
+// is used since the messages must not move while a request is in flight.
+struct vtkSMProxyInformationRequest
+{
+  vtkSmartPointer<vtkSMProxy> Proxy;
+  vtkTypeUInt32 RequestId;
+  vtkSMMessage Message;
+};
+typedef vtkstd::list<vtkSMProxyInformationRequest>
+  vtkSMProxyInformationRequestList;
+
+// Requests of the UpdatePropertyInformation() call in progress, if any.
+static vtkSMProxyInformationRequestList* vtkSMProxyPendingInformation = NULL;
+
 //---------------------------------------------------------------------------
 // Observer for modified event of the property
 class vtkSMProxyObserver : public vtkCommand
@@ -107,6 +151,7 @@ vtkSMProxy::vtkSMProxy()
   this->XMLLabel = 0;
   this->XMLSubProxyName = 0;
   this->ObjectsCreated = 0;
+  this->DeferredCreation = 0;
 
   this->XMLElement = 0;
   this->DoNotUpdateImmediately = 0;
@@ -376,31 +421,26 @@ bool vtkSMProxy::UpdateProperty(const char* name, int force)
 
   vtkSMMessage message;
 
-  // Make sure the local state is updated as well
+  it->second.Property->WriteTo(&message);
+
+  // Make sure the local state is updated as well, only for properties that
+  // are part of it.
   if(this->State)
     {
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-    int nbProps = oldState.ExtensionSize(ProxyState::property);
+    const ProxyState_Property& prop =
+      message.GetExtension(ProxyState::property, 0);
+    int nbProps = this->State->ExtensionSize(ProxyState::property);
     for(int cc=0; cc < nbProps; cc++)
       {
-      const ProxyState_Property *oldProperty =
-          &oldState.GetExtension(ProxyState::property, cc);
-
-      if(oldProperty->name() == it->second.Property->GetXMLName())
+      if (this->State->GetExtension(ProxyState::property, cc).name() ==
+        prop.name())
         {
-        it->second.Property->WriteTo(this->State);
-        }
-      else
-        {
-        ProxyState_Property *newProperty = this->State->AddExtension(ProxyState::property);
-        newProperty->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
+        vtkSMProxyUpdateStateProperty(this->State, cc, prop);
+        break;
         }
       }
     }
 
-  it->second.Property->WriteTo(&message);
   this->PushState(&message);
 
   // Fire event to let everyone know that a property has been updated.
@@ -503,6 +543,16 @@ void vtkSMProxy::UpdatePropertyInformation(vtkSMProperty* prop)
 //---------------------------------------------------------------------------
 void vtkSMProxy::UpdatePropertyInformation()
 {
+  // The outer-most call collects the pull requests issued for this proxy and
+  // its sub-proxies (see UpdatePropertyInformationInternal()) and only then
+  // waits for the replies.
+  vtkSMProxyInformationRequestList requests;
+  bool outerMost = (vtkSMProxyPendingInformation == NULL);
+  if (outerMost)
+    {
+    vtkSMProxyPendingInformation = &requests;
+    }
+
   this->UpdatePropertyInformationInternal(NULL);
 
   vtkSMProxyInternals::ProxyMap::iterator it2 =
@@ -511,6 +561,22 @@ void vtkSMProxy::UpdatePropertyInformation()
     {
     it2->second.GetPointer()->UpdatePropertyInformation();
     }
+
+  if (!outerMost)
+    {
+    return;
+    }
+  vtkSMProxyPendingInformation = NULL;
+
+  vtkSMProxyInformationRequestList::iterator iter;
+  for (iter = requests.begin(); iter != requests.end(); ++iter)
+    {
+    vtkSMSession* session = iter->Proxy->GetSession();
+    if (session->WaitForReply(iter->RequestId))
+      {
+      iter->Proxy->LoadState(&iter->Message, session->GetStateLocator());
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -559,6 +625,21 @@ void vtkSMProxy::UpdatePropertyInformationInternal(
     return;
     }
 
+  if (single_property == NULL && vtkSMProxyPendingInformation != NULL)
+    {
+    // Part of an UpdatePropertyInformation() call: send the request now and
+    // let the outer-most call wait for the reply.
+    vtkSMProxyPendingInformation->push_back(vtkSMProxyInformationRequest());
+    vtkSMProxyInformationRequest& request =
+      vtkSMProxyPendingInformation->back();
+    request.Proxy = this;
+    request.Message.CopyFrom(message);
+    request.Message.set_global_id(this->GlobalID);
+    request.Message.set_location(this->Location);
+    request.RequestId = this->Session->PullStateAsync(&request.Message);
+    return;
+    }
+
   // Hmm, this changes message itself. Funky.
   this->PullState(&message);
 
@@ -576,16 +657,19 @@ void vtkSMProxy::UpdateVTKObjects()
     return;
     }
 
+  // Send this proxy's and its sub-proxies' updates in one go.
+  vtkSMSession* session = this->GetSession();
+  if (session)
+    {
+    session->BeginTransaction();
+    }
+
   if (this->PropertiesModified)
     {
     this->InUpdateVTKObjects = 1;
 
-    // Save previous property values and clear the State properties
-    vtkSMMessage oldState;
-    oldState.CopyFrom(*this->State);
-    this->State->ClearExtension(ProxyState::property);
-
-    // iterate over all properties and push modified ones.
+    // iterate over all properties and push modified ones. Only the modified
+    // entries of the State are replaced.
     vtkSMMessage message;
     vtkSMProxyInternals::PropertyInfoMap::iterator iter;
     int cc = 0;
@@ -619,15 +703,16 @@ void vtkSMProxy::UpdateVTKObjects()
           // Push only modified properties
           if(iter->second.ModifiedFlag)
             {
-            // Write to state
-            property->WriteTo(this->State);
+            // Write to Push message
+            property->WriteTo(&message);
 
             // the property is no longer dirty.
             iter->second.ModifiedFlag = 0;
 
-            // Write to Push message
-            ProxyState_Property *prop = message.AddExtension(ProxyState::property);
-            prop->CopyFrom(this->State->GetExtension(ProxyState::property, cc));
+            // Write to state
+            vtkSMProxyUpdateStateProperty(this->State, cc,
+              message.GetExtension(ProxyState::property,
+                message.ExtensionSize(ProxyState::property) - 1));
 
             // Fire event to let everyone know that a property has been updated.
             // This is currently used by vtkSMLink. Need to see if we can avoid this
@@ -635,12 +720,6 @@ void vtkSMProxy::UpdateVTKObjects()
             this->InvokeEvent(vtkCommand::UpdatePropertyEvent,
               const_cast<char*>(iter->first.c_str()));
             }
-          else
-            {
-            // Just copy the previous old value to the state
-            ProxyState_Property *prop = this->State->AddExtension(ProxyState::property);
-            prop->CopyFrom(oldState.GetExtension(ProxyState::property, cc));
-            }
 
           // One more property
           ++cc;
@@ -661,6 +740,11 @@ void vtkSMProxy::UpdateVTKObjects()
     it2->second.GetPointer()->UpdateVTKObjects();
     }
 
+  if (session)
+    {
+    session->CommitTransaction();
+    }
+
   this->MarkModified(this);
   this->InvokeEvent(vtkCommand::UpdateEvent, 0);
 }
@@ -758,6 +842,16 @@ void vtkSMProxy::CreateVTKObjects()
   // Update assigned id/location while the push
   this->State->set_global_id(message.global_id());
   this->State->set_location(message.location());
+
+  if (this->DeferredCreation)
+    {
+    // Whatever led to the creation, the property values set while it was
+    // deferred have not been pushed yet. Reset the flag first: pushing the
+    // properties may come back here through proxies referring to this one.
+    this->DeferredCreation = 0;
+    this->UpdateVTKObjects();
+    this->UpdatePipelineInformation();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -775,6 +869,21 @@ bool vtkSMProxy::GatherInformation(vtkPVInformation* information)
   return false;
 }
 
+//---------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMProxy::GatherInformationAsync(vtkPVInformation* information)
+{
+  assert(information);
+  if (this->GetSession() && this->Location != 0)
+    {
+    // ensure that the proxy is created.
+    this->CreateVTKObjects();
+
+    return this->GetSession()->GatherInformationAsync(this->Location,
+      information, this->GetGlobalID());
+    }
+  return 0;
+}
+
 //---------------------------------------------------------------------------
 bool vtkSMProxy::WarnIfDeprecated()
 {
@@ -1697,6 +1806,7 @@ void vtkSMProxy::PrintSelf(ostream& os, vtkIndent indent)
     << endl;
   os << indent << "Documentation: " << this->Documentation << endl;
   os << indent << "ObjectsCreated: " << this->ObjectsCreated << endl;
+  os << indent << "DeferredCreation: " << this->DeferredCreation << endl;
   os << indent << "Hints: " ;
   if (this->Hints)
     {
@@ -1894,10 +2004,12 @@ void vtkSMProxy::LoadState( const vtkSMMessage* message,
 
     // Make sure all dependent domains are updated. UpdateInformation()
     // might have produced new information that invalidates the domains.
+    vtkSMProperty::BeginDomainUpdates();
     for (int i=0, nb=touchedProperties.size(); i < nb; i++)
       {
       touchedProperties[i]->UpdateDependentDomains();
       }
+    vtkSMProperty::EndDomainUpdates();
     }
 }
 //---------------------------------------------------------------------------
@@ -333,6 +333,19 @@ public:
   // Retuns if the VTK objects for this proxy have been created.
   vtkGetMacro(ObjectsCreated, int);
 
+  // Description:
+  // When DeferredCreation is set on a proxy whose VTK objects have not been
+  // created yet, the objects are created only when the proxy is first used
+  // (i.e. whenever CreateVTKObjects() is first called: its client side object
+  // or some information is requested, it is updated, a property referring to
+  // it is pushed...). At that point, all the property values set so far are
+  // pushed as well, as UpdateVTKObjects() would do, and the pipeline
+  // information is updated. vtkSMStateLoader uses this to avoid
+  // creating the objects of the proxies of a state that are never used.
+  // Default is 0.
+  vtkSetMacro(DeferredCreation, int);
+  vtkGetMacro(DeferredCreation, int);
+
   // Description:
   // Given a source proxy, makes this proxy point to the same server-side
   // object (with a new id). This method copies connection id as well as
@@ -358,6 +371,13 @@ public:
   // VTK object.
   bool GatherInformation(vtkPVInformation* information);
 
+  // Description:
+  // Same as GatherInformation() but does not wait for the reply. The
+  // \c information object is filled up once vtkSMSession::WaitForReply() is
+  // called with the returned request id. Returns 0 when the information has
+  // already been gathered (or could not be).
+  vtkTypeUInt32 GatherInformationAsync(vtkPVInformation* information);
+
   // Description:
   // Saves the state of the proxy. This state can be reloaded
   // to create a new proxy that is identical the present state of this proxy.
@@ -646,6 +666,7 @@ protected:
   char* XMLLabel;
   char* XMLSubProxyName;
   int ObjectsCreated;
+  int DeferredCreation;
   int DoNotUpdateImmediately;
   int DoNotModifyProperty;
 
@@ -26,8 +26,10 @@
 #include "vtkPVXMLParser.h"
 #include "vtkReservedRemoteObjectIds.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMBinaryStateLocator.h"
 #include "vtkSMDocumentation.h"
 #include "vtkSMGlobalPropertiesLinkUndoElement.h"
+#include "vtkSMMessage.h"
 #include "vtkSMPipelineState.h"
 #include "vtkSMPropertyIterator.h"
 #include "vtkSMProxyDefinitionManager.h"
@@ -36,6 +38,7 @@
 #include "vtkSMProxyLocator.h"
 #include "vtkSMProxyProperty.h"
 #include "vtkSMReaderFactory.h"
+#include "vtkSMSession.h"
 #include "vtkSMStateLoader.h"
 #include "vtkSMStateLocator.h"
 #include "vtkSMUndoStackBuilder.h"
@@ -54,6 +57,119 @@
 
 #include "vtkSMProxyManagerInternals.h"
 
+namespace
+{
+  typedef vtkstd::map<vtkTypeUInt32, vtkSmartPointer<vtkSMProxy> >
+    vtkSMBinaryStateProxyMap;
+
+  vtkSMProxy* vtkSMLoadBinaryStateProxy(vtkSMProxyManager* pxm,
+    vtkTypeUInt32 globalId, vtkSMBinaryStateLocator* locator,
+    vtkSMBinaryStateProxyMap& loaded);
+
+  //---------------------------------------------------------------------------
+  // Make sure the proxies referred to by the properties of the state (and of
+  // the states of its sub-proxies) exist, since vtkSMProxyProperty::ReadFrom()
+  // only looks for existing proxies.
+  void vtkSMLoadBinaryStateDependencies(vtkSMProxyManager* pxm,
+    const vtkSMMessage& state, vtkSMBinaryStateLocator* locator,
+    vtkSMBinaryStateProxyMap& loaded)
+    {
+    int nbProperties = state.ExtensionSize(ProxyState::property);
+    for (int cc=0; cc < nbProperties; cc++)
+      {
+      const ProxyState_Property& prop =
+        state.GetExtension(ProxyState::property, cc);
+      for (int i=0; prop.has_value() &&
+        i < prop.value().proxy_global_id_size(); i++)
+        {
+        vtkTypeUInt32 id =
+          static_cast<vtkTypeUInt32>(prop.value().proxy_global_id(i));
+        if (id != 0 && locator->GetParentGlobalID(id) != state.global_id())
+          {
+          vtkSMLoadBinaryStateProxy(pxm, id, locator, loaded);
+          }
+        }
+      }
+
+    int nbSubProxies = state.ExtensionSize(ProxyState::subproxy);
+    for (int cc=0; cc < nbSubProxies; cc++)
+      {
+      vtkSMMessage subProxyState;
+      if (locator->FindState(
+          state.GetExtension(ProxyState::subproxy, cc).global_id(),
+          &subProxyState))
+        {
+        vtkSMLoadBinaryStateDependencies(pxm, subProxyState, locator, loaded);
+        }
+      }
+    }
+
+  //---------------------------------------------------------------------------
+  // Returns the proxy for the given state of a binary state file, creating it
+  // (and the proxies it depends on) if needed.
+  vtkSMProxy* vtkSMLoadBinaryStateProxy(vtkSMProxyManager* pxm,
+    vtkTypeUInt32 globalId, vtkSMBinaryStateLocator* locator,
+    vtkSMBinaryStateProxyMap& loaded)
+    {
+    vtkSMProxy* proxy = vtkSMProxy::SafeDownCast(
+      pxm->GetSession()->GetRemoteObject(globalId));
+    if (proxy)
+      {
+      return proxy;
+      }
+    vtkSMBinaryStateProxyMap::iterator iter = loaded.find(globalId);
+    if (iter != loaded.end())
+      {
+      // NULL if the proxy is being loaded i.e. there is a cycle.
+      return iter->second;
+      }
+
+    // Sub-proxies are created by their parent.
+    vtkTypeUInt32 parentId = locator->GetParentGlobalID(globalId);
+    if (parentId != 0)
+      {
+      vtkSMLoadBinaryStateProxy(pxm, parentId, locator, loaded);
+      return vtkSMProxy::SafeDownCast(
+        pxm->GetSession()->GetRemoteObject(globalId));
+      }
+
+    vtkSMMessage state;
+    if (!locator->FindState(globalId, &state))
+      {
+      return NULL;
+      }
+    loaded[globalId] = NULL;
+    vtkSMLoadBinaryStateDependencies(pxm, state, locator, loaded);
+
+    // Unlike ReNewProxy(), the VTK objects are not created: the proxy only
+    // gets its global id and property values. The objects are created, and
+    // the values pushed, on first use.
+    proxy = pxm->NewProxy(state.GetExtension(ProxyState::xml_group).c_str(),
+      state.GetExtension(ProxyState::xml_name).c_str(), NULL);
+    if (proxy)
+      {
+      proxy->SetDeferredCreation(1);
+      proxy->LoadState(&state, locator, false);
+      }
+    loaded[globalId].TakeReference(proxy);
+    return proxy;
+    }
+
+  //---------------------------------------------------------------------------
+  // Returns false for the groups whose proxies are not saved in states i.e.
+  // prototypes and groups starting with "_".
+  bool vtkSMIsStateGroup(const char* colname)
+    {
+    const char* protstr = "_prototypes";
+    if (strlen(colname) > strlen(protstr))
+      {
+      const char* newstr = colname + strlen(colname) - strlen(protstr);
+      return strcmp(newstr, protstr) != 0;
+      }
+    return colname[0] != '_';
+    }
+};
+
 #if 0 // for debugging
 class vtkSMProxyRegObserver : public vtkCommand
 {
@@ -790,7 +906,10 @@ void vtkSMProxyManager::RegisterProxy(const char* groupname,
 
   if(proxy->GetLocation() != 0 && !proxy->IsPrototype()) // Not a prototype !!!
     {
-    proxy->CreateVTKObjects(); // Make sure an ID has been assigned to it
+    if (!proxy->GetDeferredCreation())
+      {
+      proxy->CreateVTKObjects(); // Make sure an ID has been assigned to it
+      }
 
     ProxyManagerState_ProxyRegistrationInfo *registration =
         this->Internals->State.AddExtension(ProxyManagerState::registered_proxy);
@@ -1116,7 +1235,20 @@ void vtkSMProxyManager::LoadXMLState( vtkPVXMLElement* rootElement,
     {
     spLoader = loader;
     }
-  if (spLoader->LoadState(rootElement))
+
+  // Send the states of all the proxies being loaded in as few messages as
+  // possible.
+  vtkSMSession* session = this->GetSession();
+  if (session)
+    {
+    session->BeginTransaction();
+    }
+  int loaded = spLoader->LoadState(rootElement);
+  if (session)
+    {
+    session->CommitTransaction();
+    }
+  if (loaded)
     {
     LoadStateInformation info;
     info.RootElement = rootElement;
@@ -1134,6 +1266,21 @@ void vtkSMProxyManager::SaveXMLState(const char* filename)
   rootElement->Delete();
 }
 
+//---------------------------------------------------------------------------
+void vtkSMProxyManager::SaveXMLState(const char* filename,
+  vtkCollection* proxies)
+{
+  vtkSMProxyManagerProxySet restriction;
+  this->CollectRestriction(restriction, proxies);
+
+  vtkPVXMLElement* root = vtkPVXMLElement::New();
+  root->SetName("GenericParaViewApplication");
+  this->AddInternalState(root, &restriction);
+  ofstream os(filename, ios::out);
+  root->PrintXML(os, vtkIndent());
+  root->Delete();
+}
+
 //---------------------------------------------------------------------------
 vtkPVXMLElement* vtkSMProxyManager::SaveXMLState()
 {
@@ -1148,6 +1295,165 @@ vtkPVXMLElement* vtkSMProxyManager::SaveXMLState()
   return root;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSMProxyManager::SaveBinaryState(const char* filename)
+{
+  return this->SaveBinaryStateInternal(filename, NULL);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSMProxyManager::SaveBinaryState(const char* filename,
+  vtkCollection* proxies)
+{
+  vtkSMProxyManagerProxySet restriction;
+  this->CollectRestriction(restriction, proxies);
+  return this->SaveBinaryStateInternal(filename, &restriction);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSMProxyManager::SaveBinaryStateInternal(const char* filename,
+  vtkSMProxyManagerProxySet* restriction)
+{
+  vtkSmartPointer<vtkSMBinaryStateLocator> writer =
+    vtkSmartPointer<vtkSMBinaryStateLocator>::New();
+  writer->SetFileName(filename);
+
+  vtkSMMessage registrations;
+  registrations.set_global_id(vtkSMProxyManager::GetReservedGlobalID());
+  registrations.set_location(vtkProcessModule::PROCESS_DATA_SERVER);
+
+  // Save the states of the registered proxies and of their sub-proxies, along
+  // with the proxies they are registered as.
+  vtkstd::vector<vtkSMMessage> states;
+  vtkstd::vector<vtkTypeUInt32> parents;
+  vtkstd::set<vtkSMProxy*> visited_proxies;
+  vtkSMProxyManagerInternals::ProxyGroupType::iterator it =
+    this->Internals->RegisteredProxyMap.begin();
+  for (; it != this->Internals->RegisteredProxyMap.end(); it++)
+    {
+    if (!vtkSMIsStateGroup(it->first.c_str()))
+      {
+      continue;
+      }
+    vtkSMProxyManagerProxyMapType::iterator it2 = it->second.begin();
+    for (; it2 != it->second.end(); it2++)
+      {
+      vtkSMProxyManagerProxyListType::iterator it3 = it2->second.begin();
+      for (; it3 != it2->second.end(); ++it3)
+        {
+        vtkSMProxy* proxy = it3->GetPointer()->Proxy.GetPointer();
+        if (restriction && restriction->find(proxy) == restriction->end())
+          {
+          continue;
+          }
+        // Proxies whose creation was deferred have no state yet.
+        proxy->CreateVTKObjects();
+        const vtkSMMessage* state = proxy->GetFullState();
+        if (!state || !state->has_global_id())
+          {
+          // Proxy without any state to save.
+          continue;
+          }
+
+        ProxyManagerState_ProxyRegistrationInfo* reg =
+          registrations.AddExtension(ProxyManagerState::registered_proxy);
+        reg->set_group(it->first.c_str());
+        reg->set_name(it2->first.c_str());
+        reg->set_global_id(state->global_id());
+
+        if (visited_proxies.insert(proxy).second)
+          {
+          states.push_back(*state);
+          parents.push_back(0);
+          }
+        }
+      }
+    }
+
+  writer->AddState(&registrations, 0);
+  for (size_t cc=0; cc < states.size(); cc++)
+    {
+    writer->AddState(&states[cc], parents[cc]);
+
+    // Sub-proxies are appended, hence saved as well.
+    int nbSubProxies = states[cc].ExtensionSize(ProxyState::subproxy);
+    vtkTypeUInt32 parentId = static_cast<vtkTypeUInt32>(states[cc].global_id());
+    vtkSMProxy* parent = vtkSMProxy::SafeDownCast(
+      this->GetSession()->GetRemoteObject(parentId));
+    for (int i=0; parent && i < nbSubProxies; i++)
+      {
+      vtkSMProxy* subProxy = parent->GetSubProxy(
+        states[cc].GetExtension(ProxyState::subproxy, i).name().c_str());
+      const vtkSMMessage* subState = subProxy? subProxy->GetFullState() : NULL;
+      if (subState && subState->has_global_id() &&
+        visited_proxies.insert(subProxy).second)
+        {
+        states.push_back(*subState);
+        parents.push_back(parentId);
+        }
+      }
+    }
+
+  return writer->Write();
+}
+
+//---------------------------------------------------------------------------
+bool vtkSMProxyManager::LoadBinaryState(const char* filename)
+{
+  vtkSMSession* session = this->GetSession();
+  vtkSmartPointer<vtkSMBinaryStateLocator> locator =
+    vtkSmartPointer<vtkSMBinaryStateLocator>::New();
+  locator->SetFileName(filename);
+  if (!locator->Open(session))
+    {
+    return false;
+    }
+
+  int* version = locator->GetFileVersion();
+  if (version[0] != vtkSMProxyManager::GetVersionMajor() ||
+    version[1] != vtkSMProxyManager::GetVersionMinor())
+    {
+    // There is no version controller for binary states. Properties unknown
+    // to this version are simply ignored.
+    vtkWarningMacro("State file " << filename << " was saved by version "
+      << version[0] << "." << version[1] << "." << version[2]
+      << ". Some properties may not be restored.");
+    }
+
+  vtkSMMessage registrations;
+  if (!locator->FindState(vtkSMProxyManager::GetReservedGlobalID(),
+      &registrations))
+    {
+    vtkErrorMacro("Missing proxy registrations in " << filename);
+    return false;
+    }
+
+  // The proxies are not created here, but registering them pushes the state
+  // of the proxy manager: send it in as few messages as possible.
+  session->BeginTransaction();
+  vtkSMBinaryStateProxyMap loaded;
+  int nbRegistrations =
+    registrations.ExtensionSize(ProxyManagerState::registered_proxy);
+  for (int cc=0; cc < nbRegistrations; cc++)
+    {
+    const ProxyManagerState_ProxyRegistrationInfo& reg =
+      registrations.GetExtension(ProxyManagerState::registered_proxy, cc);
+    vtkSMProxy* proxy = vtkSMLoadBinaryStateProxy(this,
+      static_cast<vtkTypeUInt32>(reg.global_id()), locator, loaded);
+    if (proxy)
+      {
+      this->RegisterProxy(reg.group().c_str(), reg.name().c_str(), proxy);
+      }
+    else
+      {
+      vtkWarningMacro("Failed to restore proxy " << reg.group().c_str()
+        << ", " << reg.name().c_str());
+      }
+    }
+  session->CommitTransaction();
+  return true;
+}
+
 //---------------------------------------------------------------------------
 void vtkSMProxyManager::CollectReferredProxies(
   vtkSMProxyManagerProxySet& setOfProxies, vtkSMProxy* proxy)
@@ -1161,9 +1467,8 @@ void vtkSMProxyManager::CollectReferredProxies(
     for (unsigned int cc=0; pp && (pp->GetNumberOfProxies() > cc); cc++)
       {
       vtkSMProxy* referredProxy = pp->GetProxy(cc);
-      if (referredProxy)
+      if (referredProxy && setOfProxies.insert(referredProxy).second)
         {
-        setOfProxies.insert(referredProxy);
         this->CollectReferredProxies(setOfProxies, referredProxy);
         }
       }
@@ -1172,7 +1477,23 @@ void vtkSMProxyManager::CollectReferredProxies(
 
 
 //---------------------------------------------------------------------------
-vtkPVXMLElement* vtkSMProxyManager::AddInternalState(vtkPVXMLElement *parentElem)
+void vtkSMProxyManager::CollectRestriction(
+  vtkSMProxyManagerProxySet& restriction, vtkCollection* proxies)
+{
+  for (int cc=0; proxies && cc < proxies->GetNumberOfItems(); cc++)
+    {
+    vtkSMProxy* proxy =
+      vtkSMProxy::SafeDownCast(proxies->GetItemAsObject(cc));
+    if (proxy && restriction.insert(proxy).second)
+      {
+      this->CollectReferredProxies(restriction, proxy);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkPVXMLElement* vtkSMProxyManager::AddInternalState(vtkPVXMLElement *parentElem,
+  vtkSMProxyManagerProxySet* restriction)
 {
   vtkPVXMLElement* rootElement = vtkPVXMLElement::New();
   rootElement->SetName("ServerManagerState");
@@ -1195,23 +1516,7 @@ vtkPVXMLElement* vtkSMProxyManager::AddInternalState(vtkPVXMLElement *parentElem
       it->second.begin();
 
     // Do not save the state of prototypes.
-    const char* protstr = "_prototypes";
-    const char* colname = it->first.c_str();
-    int do_group = 1;
-    if (strlen(colname) > strlen(protstr))
-      {
-      const char* newstr = colname + strlen(colname) -
-        strlen(protstr);
-      if (strcmp(newstr, protstr) == 0)
-        {
-        do_group = 0;
-        }
-      }
-    else if ( colname[0] == '_' )
-      {
-      do_group = 0;
-      }
-    if (!do_group)
+    if (!vtkSMIsStateGroup(it->first.c_str()))
       {
       continue;
       }
@@ -1229,6 +1534,11 @@ vtkPVXMLElement* vtkSMProxyManager::AddInternalState(vtkPVXMLElement *parentElem
           // proxy has been saved.
           continue;
           }
+        if (restriction && restriction->find(
+            it3->GetPointer()->Proxy.GetPointer()) == restriction->end())
+          {
+          continue;
+          }
         it3->GetPointer()->Proxy.GetPointer()->SaveXMLState(rootElement);
         visited_proxies.insert(it3->GetPointer()->Proxy.GetPointer());
         }
@@ -1296,18 +1606,23 @@ vtkPVXMLElement* vtkSMProxyManager::AddInternalState(vtkPVXMLElement *parentElem
   rootElement->AddNestedElement(defs);
   defs->Delete();
 
-  // Save links
-  vtkPVXMLElement* links = vtkPVXMLElement::New();
-  links->SetName("Links");
-  this->SaveRegisteredLinks(links);
-  rootElement->AddNestedElement(links);
-  links->Delete();
-
-  vtkPVXMLElement* globalProps = vtkPVXMLElement::New();
-  globalProps->SetName("GlobalPropertiesManagers");
-  this->SaveGlobalPropertiesManagers(globalProps);
-  rootElement->AddNestedElement(globalProps);
-  globalProps->Delete();
+  // Links and global property managers may refer to any proxy of the
+  // session: they are not saved with a subset of the proxies.
+  if (!restriction)
+    {
+    // Save links
+    vtkPVXMLElement* links = vtkPVXMLElement::New();
+    links->SetName("Links");
+    this->SaveRegisteredLinks(links);
+    rootElement->AddNestedElement(links);
+    links->Delete();
+
+    vtkPVXMLElement* globalProps = vtkPVXMLElement::New();
+    globalProps->SetName("GlobalPropertiesManagers");
+    this->SaveGlobalPropertiesManagers(globalProps);
+    rootElement->AddNestedElement(globalProps);
+    globalProps->Delete();
+    }
 
   if(parentElem)
     {
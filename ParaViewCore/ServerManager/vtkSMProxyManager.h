@@ -333,6 +333,12 @@ public:
   // This saves the state of all proxies and properties.
   void SaveXMLState(const char* filename);
 
+  // Description:
+  // Same as SaveXMLState(filename), but only the given proxies, and the
+  // proxies they refer to, are saved if they are registered. Links and global
+  // property managers, which concern the whole session, are not saved.
+  void SaveXMLState(const char* filename, vtkCollection* proxies);
+
   // Description:
   // Saves the state of the server manager as XML, and returns the
   // vtkPVXMLElement for the root of the state.
@@ -340,6 +346,28 @@ public:
   // it's the caller's responsibility to free it by calling Delete().
   vtkPVXMLElement* SaveXMLState();
 
+  // Description:
+  // Save the state of the server manager in the binary format in a file.
+  // Binary state files store the protobuf states of the registered proxies
+  // (see vtkSMBinaryStateLocator) and load much faster than XML states.
+  // Unlike SaveXMLState(), links, global property managers and custom proxy
+  // definitions are not saved. Returns false on failure.
+  bool SaveBinaryState(const char* filename);
+
+  // Description:
+  // Same as SaveBinaryState(filename), but only the given proxies, and the
+  // proxies they refer to, are saved if they are registered.
+  bool SaveBinaryState(const char* filename, vtkCollection* proxies);
+
+  // Description:
+  // Loads a state saved with SaveBinaryState(). The proxies are created in
+  // the current session with new global ids. Proxy states are only parsed
+  // from the file when the proxy, or a proxy referring to it, is created.
+  // As with vtkSMStateLoader::DeferProxyCreation, the proxies are registered
+  // without their VTK objects, which are only created on first use (see
+  // vtkSMProxy::SetDeferredCreation()). Returns false on failure.
+  bool LoadBinaryState(const char* filename);
+
   // Description:
   // Given a group name, create prototypes and store them
   // in a instance group called groupName_prototypes.
@@ -568,8 +596,21 @@ protected:
   // Internal method to save server manager state in an XML
   // and return the created vtkPVXMLElement for it. The caller has
   // the responsibility of freeing the vtkPVXMLElement returned IF the
-  // parentElement is NULL.
-  vtkPVXMLElement* AddInternalState(vtkPVXMLElement* parentElement);
+  // parentElement is NULL. When restriction is not NULL, only the proxies
+  // in it are saved, without links nor global property managers.
+  vtkPVXMLElement* AddInternalState(vtkPVXMLElement* parentElement,
+    vtkSMProxyManagerProxySet* restriction=NULL);
+
+  // Description:
+  // Saves the binary state of the registered proxies, or of the ones in
+  // restriction when not NULL.
+  bool SaveBinaryStateInternal(const char* filename,
+    vtkSMProxyManagerProxySet* restriction);
+
+  // Description:
+  // Fills restriction with the given proxies and the proxies they refer to.
+  void CollectRestriction(vtkSMProxyManagerProxySet& restriction,
+    vtkCollection* proxies);
 
   // Recursively collects all proxies referred by the proxy in the set.
   void CollectReferredProxies( vtkSMProxyManagerProxySet& setOfProxies,
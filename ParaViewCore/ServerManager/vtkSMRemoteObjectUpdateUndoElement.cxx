@@ -23,38 +23,102 @@
 #include "vtkSMProxyManager.h"
 #include "vtkSMProxy.h"
 
+#include <vtkstd/map>
+#include <vtkstd/string>
+
+//-----------------------------------------------------------------------------
+namespace
+{
+  typedef vtkstd::map<vtkstd::string, vtkstd::string> PropertyValueMap;
+
+  // Fill "values" with the serialized value of each property of the state.
+  void vtkGetPropertyValues(const vtkSMMessage& state, PropertyValueMap& values)
+    {
+    for (int cc=0; cc < state.ExtensionSize(ProxyState::property); cc++)
+      {
+      const ProxyState_Property& prop =
+        state.GetExtension(ProxyState::property, cc);
+      prop.SerializeToString(&values[prop.name()]);
+      }
+    }
+
+  // Remove from "state" the properties having the same value in "other".
+  void vtkRemoveUnchangedProperties(vtkSMMessage& state,
+    const PropertyValueMap& stateValues, const PropertyValueMap& otherValues)
+    {
+    vtkSMMessage full;
+    full.CopyFrom(state);
+    state.ClearExtension(ProxyState::property);
+    for (int cc=0; cc < full.ExtensionSize(ProxyState::property); cc++)
+      {
+      const ProxyState_Property& prop =
+        full.GetExtension(ProxyState::property, cc);
+      PropertyValueMap::const_iterator other = otherValues.find(prop.name());
+      if (other == otherValues.end() ||
+        other->second != stateValues.find(prop.name())->second)
+        {
+        state.AddExtension(ProxyState::property)->CopyFrom(prop);
+        }
+      }
+    }
+
+  // Append to "state" the properties of "other" that "state" does not have.
+  void vtkAddMissingProperties(vtkSMMessage& state, const vtkSMMessage& other)
+    {
+    PropertyValueMap values;
+    vtkGetPropertyValues(state, values);
+    for (int cc=0; cc < other.ExtensionSize(ProxyState::property); cc++)
+      {
+      const ProxyState_Property& prop =
+        other.GetExtension(ProxyState::property, cc);
+      if (values.find(prop.name()) == values.end())
+        {
+        state.AddExtension(ProxyState::property)->CopyFrom(prop);
+        }
+      }
+    }
+};
+
 vtkStandardNewMacro(vtkSMRemoteObjectUpdateUndoElement);
 //-----------------------------------------------------------------------------
 vtkSMRemoteObjectUpdateUndoElement::vtkSMRemoteObjectUpdateUndoElement()
 {
-  this->AfterState = new vtkSMMessage();
-  this->BeforeState = new vtkSMMessage();
+  this->GlobalID = 0;
 }
 
 //-----------------------------------------------------------------------------
 vtkSMRemoteObjectUpdateUndoElement::~vtkSMRemoteObjectUpdateUndoElement()
 {
-  delete this->AfterState;
-  delete this->BeforeState;
-  this->AfterState = NULL;
-  this->BeforeState = NULL;
 }
 
 //-----------------------------------------------------------------------------
 void vtkSMRemoteObjectUpdateUndoElement::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "GlobalID: " << this->GlobalID << endl;
+  os << indent << "MemorySize: " << this->GetMemorySize() << endl;
 }
 //-----------------------------------------------------------------------------
 int vtkSMRemoteObjectUpdateUndoElement::Undo()
 {
-  return this->UpdateState(this->BeforeState);
+  return this->UpdateState(this->BeforeStateData);
 }
 
 //-----------------------------------------------------------------------------
 int vtkSMRemoteObjectUpdateUndoElement::Redo()
 {
-  return this->UpdateState(this->AfterState);
+  return this->UpdateState(this->AfterStateData);
+}
+
+//-----------------------------------------------------------------------------
+int vtkSMRemoteObjectUpdateUndoElement::UpdateState(const vtkStdString& data)
+{
+  vtkSMMessage state;
+  if (data.empty() || !state.ParseFromString(data))
+    {
+    return 1;
+    }
+  return this->UpdateState(&state);
 }
 
 //-----------------------------------------------------------------------------
@@ -86,23 +150,86 @@ int vtkSMRemoteObjectUpdateUndoElement::UpdateState(const vtkSMMessage* state)
 void vtkSMRemoteObjectUpdateUndoElement::SetUndoRedoState(
     const vtkSMMessage* before, const vtkSMMessage* after)
 {
-  this->BeforeState->Clear();
-  this->AfterState->Clear();
-  if(before && after)
+  this->BeforeStateData.clear();
+  this->AfterStateData.clear();
+  this->GlobalID = 0;
+  this->SetMergeable(false);
+  if(!before || !after)
+    {
+    vtkErrorMacro( "Invalid SetUndoRedoState. "
+                   << "At least one of the provided states is NULL.");
+    return;
+    }
+
+  this->GlobalID = static_cast<vtkTypeUInt32>(before->global_id());
+  if (before->HasExtension(ProxyState::xml_group) &&
+    after->HasExtension(ProxyState::xml_group) &&
+    before->global_id() == after->global_id())
     {
-    this->BeforeState->CopyFrom(*before);
-    this->AfterState->CopyFrom(*after);
+    // Proxy state: only keep the properties that changed. Since LoadState()
+    // only touches the properties present in the state, this is enough to
+    // undo/redo the change.
+    PropertyValueMap beforeValues, afterValues;
+    vtkGetPropertyValues(*before, beforeValues);
+    vtkGetPropertyValues(*after, afterValues);
+
+    vtkSMMessage beforeDelta, afterDelta;
+    beforeDelta.CopyFrom(*before);
+    afterDelta.CopyFrom(*after);
+    vtkRemoveUnchangedProperties(beforeDelta, beforeValues, afterValues);
+    vtkRemoveUnchangedProperties(afterDelta, afterValues, beforeValues);
+    beforeDelta.SerializeToString(&this->BeforeStateData);
+    afterDelta.SerializeToString(&this->AfterStateData);
+    this->SetMergeable(true);
     }
   else
     {
-    vtkErrorMacro( "Invalid SetUndoRedoState. "
-                   << "At least one of the provided states is NULL.");
+    before->SerializeToString(&this->BeforeStateData);
+    after->SerializeToString(&this->AfterStateData);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSMRemoteObjectUpdateUndoElement::Merge(vtkUndoElement* new_element)
+{
+  vtkSMRemoteObjectUpdateUndoElement* other =
+    vtkSMRemoteObjectUpdateUndoElement::SafeDownCast(new_element);
+  if (!other || strcmp(other->GetClassName(), this->GetClassName()) != 0 ||
+    !this->GetMergeable() || !other->GetMergeable() ||
+    other->GlobalID != this->GlobalID || other->Session != this->Session ||
+    other->Locator.GetPointer() != this->Locator.GetPointer())
+    {
+    return false;
+    }
+
+  vtkSMMessage before, after, otherBefore, otherAfter;
+  if (!before.ParseFromString(this->BeforeStateData) ||
+    !after.ParseFromString(this->AfterStateData) ||
+    !otherBefore.ParseFromString(other->BeforeStateData) ||
+    !otherAfter.ParseFromString(other->AfterStateData))
+    {
+    return false;
     }
+
+  // Undo restores the oldest value of each property, redo the newest one.
+  vtkAddMissingProperties(before, otherBefore);
+  vtkAddMissingProperties(otherAfter, after);
+  before.SerializeToString(&this->BeforeStateData);
+  otherAfter.SerializeToString(&this->AfterStateData);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkSMRemoteObjectUpdateUndoElement::GetMemorySize()
+{
+  return static_cast<unsigned long>(sizeof(*this) +
+    this->BeforeStateData.capacity() + this->AfterStateData.capacity());
 }
+
 //-----------------------------------------------------------------------------
 vtkTypeUInt32 vtkSMRemoteObjectUpdateUndoElement::GetGlobalId()
 {
-  return this->BeforeState->global_id();
+  return this->GlobalID;
 }
 //-----------------------------------------------------------------------------
 void vtkSMRemoteObjectUpdateUndoElement::SetStateLocator(vtkSMStateLocator* locator)
@@ -17,12 +17,18 @@
 // This class keeps the before and after state of the RemoteObject in the
 // vtkSMMessage form. It works with any proxy and RemoteObject. It is a very
 // generic undoElement.
+//
+// To keep the undo stack small, the states are stored serialized and, for
+// proxies, only the properties that differ between the before and the after
+// states are kept. Consecutive elements updating the same proxy within an
+// undo set are merged into a single one.
 
 #ifndef __vtkSMRemoteObjectUpdateUndoElement_h
 #define __vtkSMRemoteObjectUpdateUndoElement_h
 
 #include "vtkSMUndoElement.h"
 #include "vtkSMMessageMinimal.h" // needed for vtkSMMessage
+#include "vtkStdString.h" // needed for vtkStdString.
 #include "vtkWeakPointer.h" //  needed for vtkWeakPointer.
 
 class vtkSMStateLocator;
@@ -57,12 +63,20 @@ public:
   virtual void SetUndoRedoState(const vtkSMMessage* before,
                                 const vtkSMMessage* after);
 
-  // Current full state of the UndoElement
-  vtkSMMessage* BeforeState;
-  vtkSMMessage* AfterState;
-
+  // Description:
+  // Returns the global id of the remote object this element updates.
   virtual vtkTypeUInt32 GetGlobalId();
 
+  // Description:
+  // Merge with a more recent element updating the same proxy: the resulting
+  // element restores the oldest value of every property on undo and the
+  // newest one on redo.
+  virtual bool Merge(vtkUndoElement* new_element);
+
+  // Description:
+  // Returns the memory used by the stored states.
+  virtual unsigned long GetMemorySize();
+
 protected:
   vtkSMRemoteObjectUpdateUndoElement();
   ~vtkSMRemoteObjectUpdateUndoElement();
@@ -70,8 +84,17 @@ protected:
   // Internal method used to update proxy state based on the state info
   int UpdateState(const vtkSMMessage* state);
 
+  // Internal method used to update proxy state based on the serialized state
+  int UpdateState(const vtkStdString& data);
+
   vtkWeakPointer<vtkSMStateLocator> Locator;
 
+  // Serialized before and after states. For proxies, only the properties that
+  // changed are kept.
+  vtkStdString BeforeStateData;
+  vtkStdString AfterStateData;
+  vtkTypeUInt32 GlobalID;
+
 private:
   vtkSMRemoteObjectUpdateUndoElement(const vtkSMRemoteObjectUpdateUndoElement&); // Not implemented.
   void operator=(const vtkSMRemoteObjectUpdateUndoElement&); // Not implemented.
@@ -48,6 +48,7 @@ vtkSMSession::vtkSMSession(bool initialize_during_constructor/*=true*/)
   this->PluginManager->SetSession(this);
   this->UndoStackBuilder = NULL;
   this->IsAutoMPI = false;
+  this->TransactionDepth = 0;
 
   // Start after the reserved one
   this->LastGUID = vtkReservedRemoteObjectIds::RESERVED_MAX_IDS;
@@ -93,6 +94,41 @@ void vtkSMSession::PushState(vtkSMMessage* msg)
   this->Superclass::PushState(msg);
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSession::BeginTransaction()
+{
+  this->TransactionDepth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSession::CommitTransaction()
+{
+  if (this->TransactionDepth <= 0)
+    {
+    vtkErrorMacro("CommitTransaction() called without BeginTransaction().");
+    return;
+    }
+  if (--this->TransactionDepth == 0)
+    {
+    this->FlushTransaction();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMSession::PullStateAsync(vtkSMMessage* message)
+{
+  this->PullState(message);
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMSession::GatherInformationAsync(vtkTypeUInt32 location,
+  vtkPVInformation* information, vtkTypeUInt32 globalid)
+{
+  this->GatherInformation(location, information, globalid);
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSession::UpdateStateHistory(vtkSMMessage* msg)
 {
@@ -170,6 +206,7 @@ int vtkSMSession::GetNumberOfProcesses(vtkTypeUInt32 servers)
 void vtkSMSession::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "TransactionDepth: " << this->TransactionDepth << endl;
 }
 
 //----------------------------------------------------------------------------
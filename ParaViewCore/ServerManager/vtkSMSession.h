@@ -90,6 +90,54 @@ public:
   // StateManagement is set to true.
   vtkGetObjectMacro(StateLocator, vtkSMStateLocator);
 
+  //---------------------------------------------------------------------------
+  // Transaction API.
+  //---------------------------------------------------------------------------
+
+  // Description:
+  // Between BeginTransaction() and the matching CommitTransaction() the
+  // session is allowed to buffer the states pushed to remote processes and
+  // send them together when the transaction is committed, or earlier as soon
+  // as an operation needs the remote processes to be up to date (executing a
+  // stream, pulling a state, gathering information...). Transactions nest;
+  // only the outer-most commit flushes. The builtin session executes
+  // everything immediately.
+  void BeginTransaction();
+  void CommitTransaction();
+  bool GetInTransaction() { return this->TransactionDepth > 0; }
+
+  //---------------------------------------------------------------------------
+  // Asynchronous requests API.
+  //---------------------------------------------------------------------------
+
+//BTX
+  // Description:
+  // Asynchronous variants of PullState() and GatherInformation(). The request
+  // is sent right away and an id identifying it is returned. The reply is
+  // stored into \c message only when WaitForReply() is called for that id,
+  // hence the caller must keep the message alive and call WaitForReply().
+  // \c information is registered by the session until its reply is received
+  // and is filled up at the latest when WaitForReply() (or
+  // WaitForAllReplies()) returns. Several requests can be in
+  // flight at the same time, which avoids paying one round trip per request.
+  // A returned id of 0 means that the request has already been completed.
+  // The implementation provided by this class simply executes the request
+  // synchronously.
+  virtual vtkTypeUInt32 PullStateAsync(vtkSMMessage* message);
+//ETX
+  virtual vtkTypeUInt32 GatherInformationAsync(vtkTypeUInt32 location,
+    vtkPVInformation* information, vtkTypeUInt32 globalid);
+
+  // Description:
+  // Block until the reply to the given asynchronous request has been
+  // received. Returns false if the request failed.
+  virtual bool WaitForReply(vtkTypeUInt32 vtkNotUsed(requestId))
+    { return true; }
+
+  // Description:
+  // Block until all asynchronous requests have been answered.
+  virtual void WaitForAllReplies() {}
+
   //---------------------------------------------------------------------------
   // Superclass Implementations
   //---------------------------------------------------------------------------
@@ -191,10 +239,16 @@ protected:
   // maintain the UndoRedo mecanisme.
   void UpdateStateHistory(vtkSMMessage* msg);
 
+  // Description:
+  // Send the states buffered by the current transaction, if any. The default
+  // implementation does nothing since nothing is ever buffered.
+  virtual void FlushTransaction() {}
+
   vtkSMUndoStackBuilder* UndoStackBuilder;
   vtkSMPluginManager* PluginManager;
   vtkSMStateLocator* StateLocator;
   bool StateManagement;
+  int TransactionDepth;
 
   // GlobalID managed locally
   vtkTypeUInt32 LastGUID;
@@ -22,6 +22,7 @@
 #include "vtkNetworkAccessManager.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h"
+#include "vtkPVInformation.h"
 #include "vtkPVServerInformation.h"
 #include "vtkProcessModule.h"
 #include "vtkSMMessage.h"
@@ -29,14 +30,190 @@
 #include "vtkSMProxy.h"
 #include "vtkSMProxyManager.h"
 #include "vtkPVSessionServer.h"
+#include "vtkSmartPointer.h"
 #include "vtkSocketCommunicator.h"
+#include "vtkTimerLog.h"
 
+#include <vtkstd/deque>
+#include <vtkstd/map>
 #include <vtkstd/string>
+#include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
 
+//----------------------------------------------------------------------------
+class vtkSMSessionClient::vtkInternals
+{
+public:
+  vtkInternals() : LastRequestId(0),
+    DataServerCompressionThreshold(0), RenderServerCompressionThreshold(0) {}
+
+  // States pushed during the current transaction, in push order, together
+  // with the (real) location they were sent to.
+  struct PendingPush
+    {
+    vtkTypeUInt32 Location;
+    vtkSMMessage Message;
+    };
+  vtkstd::vector<PendingPush> Pending;
+
+  // Asynchronous requests sent to the servers and not answered yet, in the
+  // order they were sent, which is the order the replies come back in. Only
+  // one of Message (pull) or Information (gather) is set. The information
+  // object is registered until its reply is received. The message is only
+  // written to by WaitForReply() for that request (see Completed).
+  struct InFlightRequest
+    {
+    vtkTypeUInt32 Id;
+    int Type;
+    double SendTime;
+    vtkMultiProcessController* Controller;
+    vtkSMMessage* Message;
+    vtkSmartPointer<vtkPVInformation> Information;
+    };
+  vtkstd::deque<InFlightRequest> InFlight;
+  vtkTypeUInt32 LastRequestId;
+
+  // Requests whose reply was received, possibly while waiting for another
+  // request, but that were not waited for yet. Pull replies are kept as
+  // received and only copied into the caller's message when the caller
+  // waits for them.
+  struct CompletedRequest
+    {
+    bool Status;
+    vtkSMMessage* Message;
+    vtkstd::string State;
+    CompletedRequest() : Status(false), Message(NULL) {}
+    };
+  vtkstd::map<vtkTypeUInt32, CompletedRequest> Completed;
+
+  // Hands the reply to the given request over to the caller. Returns false
+  // if the request failed.
+  bool FinishRequest(vtkTypeUInt32 requestId)
+    {
+    vtkstd::map<vtkTypeUInt32, CompletedRequest>::iterator iter =
+      this->Completed.find(requestId);
+    if (iter == this->Completed.end())
+      {
+      // Completed synchronously, or already waited for.
+      return true;
+      }
+    bool status = iter->second.Status;
+    if (status && iter->second.Message)
+      {
+      iter->second.Message->ParseFromString(iter->second.State);
+      }
+    this->Completed.erase(iter);
+    return status;
+    }
+
+  // Compression thresholds negotiated with each server.
+  int DataServerCompressionThreshold;
+  int RenderServerCompressionThreshold;
+
+  // Traffic statistics, per message type.
+  struct Counters
+    {
+    vtkIdType Messages;
+    vtkIdType BytesSent;
+    vtkIdType BytesReceived;
+    vtkIdType RoundTrips;
+    double RoundTripTime;
+    Counters() : Messages(0), BytesSent(0), BytesReceived(0), RoundTrips(0),
+      RoundTripTime(0.0) {}
+    };
+  vtkstd::map<int, Counters> Statistics;
+
+  // Records a reply of the given size, as received on the wire i.e.
+  // including the headers and before decompression.
+  void RecordReply(int type, vtkIdType bytes, double sendTime)
+    {
+    Counters& counters = this->Statistics[type];
+    counters.BytesReceived += bytes;
+    counters.RoundTrips++;
+    counters.RoundTripTime += vtkTimerLog::GetUniversalTime() - sendTime;
+    }
+
+  Counters GetCounters(int type) const
+    {
+    vtkstd::map<int, Counters>::const_iterator iter =
+      this->Statistics.find(type);
+    return iter != this->Statistics.end()? iter->second : Counters();
+    }
+
+  // Size of a stream as sent over the wire.
+  static vtkIdType GetWireSize(vtkMultiProcessStream& stream)
+    {
+    vtkstd::vector<unsigned char> raw;
+    stream.GetRawData(raw);
+    return static_cast<vtkIdType>(raw.size());
+    }
+
+  vtkTypeUInt32 NextRequestId()
+    {
+    // 0 is reserved for "already completed".
+    if (++this->LastRequestId == 0)
+      {
+      this->LastRequestId = 1;
+      }
+    return this->LastRequestId;
+    }
+
+  bool IsInFlight(vtkTypeUInt32 requestId)
+    {
+    vtkstd::deque<InFlightRequest>::iterator iter;
+    for (iter = this->InFlight.begin(); iter != this->InFlight.end(); ++iter)
+      {
+      if (iter->Id == requestId)
+        {
+        return true;
+        }
+      }
+    return false;
+    }
+
+  // Returns true when the message only carries property values for an
+  // existing proxy, i.e. it can be folded into an earlier push for the same
+  // proxy.
+  static bool IsPropertyUpdate(const vtkSMMessage& message)
+    {
+    return message.ExtensionSize(ProxyState::property) > 0 &&
+      !message.HasExtension(ProxyState::xml_group) &&
+      message.ExtensionSize(ProxyState::subproxy) == 0;
+    }
+
+  // Fold the properties of "newer" into "older". Properties with a value
+  // replace the earlier value of the same property; command properties
+  // (without value) are always appended so that they are invoked every time.
+  static void Merge(vtkSMMessage* older, const vtkSMMessage& newer)
+    {
+    int nbOld = older->ExtensionSize(ProxyState::property);
+    for (int cc=0; cc < newer.ExtensionSize(ProxyState::property); cc++)
+      {
+      const ProxyState_Property& prop =
+        newer.GetExtension(ProxyState::property, cc);
+      bool replaced = false;
+      for (int kk=0; prop.has_value() && !replaced && kk < nbOld; kk++)
+        {
+        ProxyState_Property* oldProp =
+          older->MutableExtension(ProxyState::property, kk);
+        if (oldProp->has_value() && oldProp->name() == prop.name())
+          {
+          oldProp->CopyFrom(prop);
+          replaced = true;
+          }
+        }
+      if (!replaced)
+        {
+        older->AddExtension(ProxyState::property)->CopyFrom(prop);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSMSessionClient);
 vtkCxxSetObjectMacro(vtkSMSessionClient, RenderServerController,
   vtkMultiProcessController);
@@ -56,6 +233,7 @@ vtkSMSessionClient::vtkSMSessionClient()
   this->RenderServerInformation = vtkPVServerInformation::New();
   this->ServerInformation = vtkPVServerInformation::New();
   this->ServerLastInvokeResult = new vtkClientServerStream();
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
@@ -74,11 +252,17 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+  delete this->Internals;
+  this->Internals = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkMultiProcessController* vtkSMSessionClient::GetController(ServerFlags processType)
 {
+  // The controller is used for direct communication with the servers, which
+  // must not find replies to asynchronous requests still on the socket.
+  this->WaitForAllReplies();
+
   switch (processType)
     {
   case CLIENT:
@@ -214,6 +398,8 @@ bool vtkSMSessionClient::Connect(const char* url)
   if (dcontroller)
     {
     this->SetDataServerController(dcontroller);
+    this->Internals->DataServerCompressionThreshold =
+      nam->GetNegotiatedCompressionThreshold(dcontroller);
     dcontroller->GetCommunicator()->AddObserver(
       vtkCommand::WrongTagEvent, this, &vtkSMSessionClient::OnWrongTagEvent);
     dcontroller->Delete();
@@ -221,6 +407,8 @@ bool vtkSMSessionClient::Connect(const char* url)
   if (rcontroller)
     {
     this->SetRenderServerController(rcontroller);
+    this->Internals->RenderServerCompressionThreshold =
+      nam->GetNegotiatedCompressionThreshold(rcontroller);
     rcontroller->GetCommunicator()->AddObserver(
       vtkCommand::WrongTagEvent, this, &vtkSMSessionClient::OnWrongTagEvent);
     rcontroller->Delete();
@@ -359,6 +547,8 @@ int vtkSMSessionClient::GetNumberOfProcesses(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushTransaction();
+  this->WaitForAllReplies();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -403,6 +593,51 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
+  if ((location & (vtkPVSession::DATA_SERVER|vtkPVSession::DATA_SERVER_ROOT|
+        vtkPVSession::RENDER_SERVER|vtkPVSession::RENDER_SERVER_ROOT)) != 0)
+    {
+    this->SendPushState(location, message);
+    }
+
+  if ((location & vtkPVSession::CLIENT) != 0)
+    {
+    this->Superclass::PushState(message);
+    }
+  else
+    {
+    // We do not execute anything locally we just keep track
+    // of the State History for Undo/Redo
+    this->UpdateStateHistory(message);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendPushState(
+  vtkTypeUInt32 location, vtkSMMessage* message)
+{
+  if (this->GetInTransaction())
+    {
+    // Fold into the previous push when it is for the same proxy, otherwise
+    // queue it. Folding into an older push would move this one ahead of the
+    // pushes queued in between (e.g. the creation of a proxy it refers to).
+    // Either way nothing goes on the wire until the flush.
+    vtkstd::vector<vtkInternals::PendingPush>& pending =
+      this->Internals->Pending;
+    if (!pending.empty() &&
+      pending.back().Message.global_id() == message->global_id() &&
+      pending.back().Location == location &&
+      vtkInternals::IsPropertyUpdate(*message))
+      {
+      vtkInternals::Merge(&pending.back().Message, *message);
+      return;
+      }
+    vtkInternals::PendingPush item;
+    item.Location = location;
+    pending.push_back(item);
+    pending.back().Message.CopyFrom(*message);
+    return;
+    }
+
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
   int num_controllers=0;
   if ( (location &
@@ -415,36 +650,88 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     {
     controllers[num_controllers++] = this->RenderServerController;
     }
-  if (num_controllers > 0)
+  vtkstd::string data = message->SerializeAsString();
+  for (int cc=0; cc < num_controllers; cc++)
     {
+    // Each connection may have its own compression settings.
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PUSH);
-    stream << message->SerializeAsString();
-    vtkstd::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
-    for (int cc=0; cc < num_controllers; cc++)
-      {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
-      }
+    vtkPVSessionServer::WriteMessage(stream, data,
+      this->GetCompressionThreshold(controllers[cc]));
+    this->TriggerRMI(controllers[cc], vtkPVSessionServer::PUSH, stream);
     }
+}
 
-  if ((location & vtkPVSession::CLIENT) != 0)
+//----------------------------------------------------------------------------
+int vtkSMSessionClient::GetNumberOfPendingStates()
+{
+  return static_cast<int>(this->Internals->Pending.size());
+}
+
+//----------------------------------------------------------------------------
+const vtkSMMessage* vtkSMSessionClient::GetPendingState(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfPendingStates())
     {
-    this->Superclass::PushState(message);
+    return NULL;
     }
-  else
+  return &this->Internals->Pending[index].Message;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushTransaction()
+{
+  if (this->Internals->Pending.empty())
     {
-    // We do not execute anything locally we just keep track
-    // of the State History for Undo/Redo
-    this->UpdateStateHistory(message);
+    return;
+    }
+
+  // Split the queue per server connection, keeping the push order.
+  vtkSMMessageCollection dataServerBatch;
+  vtkSMMessageCollection renderServerBatch;
+  vtkstd::vector<vtkInternals::PendingPush>::iterator iter;
+  for (iter = this->Internals->Pending.begin();
+    iter != this->Internals->Pending.end(); ++iter)
+    {
+    if ((iter->Location &
+        (vtkPVSession::DATA_SERVER|vtkPVSession::DATA_SERVER_ROOT)) != 0)
+      {
+      dataServerBatch.add_item()->CopyFrom(iter->Message);
+      }
+    if ((iter->Location &
+        (vtkPVSession::RENDER_SERVER|vtkPVSession::RENDER_SERVER_ROOT)) != 0)
+      {
+      renderServerBatch.add_item()->CopyFrom(iter->Message);
+      }
+    }
+  this->Internals->Pending.clear();
+
+  vtkMultiProcessController* controllers[2] = {
+    this->DataServerController, this->RenderServerController };
+  vtkSMMessageCollection* batches[2] = {
+    &dataServerBatch, &renderServerBatch };
+  for (int cc=0; cc < 2; cc++)
+    {
+    if (controllers[cc] == NULL || batches[cc]->item_size() == 0)
+      {
+      continue;
+      }
+    vtkMultiProcessStream stream;
+    stream << static_cast<int>(vtkPVSessionServer::PUSH_BATCH);
+    vtkPVSessionServer::WriteMessage(stream, batches[cc]->SerializeAsString(),
+      this->GetCompressionThreshold(controllers[cc]));
+    this->TriggerRMI(controllers[cc], vtkPVSessionServer::PUSH_BATCH, stream);
     }
 }
 
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  // The server must see every state pushed so far before answering, and the
+  // replies to pending asynchronous requests come first on the connection.
+  this->FlushTransaction();
+  this->WaitForAllReplies();
+
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
@@ -469,21 +756,23 @@ void vtkSMSessionClient::PullState(vtkSMMessage* message)
 
   if (controller)
     {
+    double sendTime = vtkTimerLog::GetUniversalTime();
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PULL);
-    stream << message->SerializeAsString();
-    vtkstd::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    vtkPVSessionServer::WriteMessage(stream, message->SerializeAsString(),
+      this->GetCompressionThreshold(controller));
+    this->TriggerRMI(controller, vtkPVSessionServer::PULL, stream);
 
     // Get the reply
     vtkMultiProcessStream replyStream;
     controller->Receive(replyStream, 1, vtkPVSessionServer::REPLY_PULL);
+    this->Internals->RecordReply(vtkPVSessionServer::PULL,
+      vtkInternals::GetWireSize(replyStream), sendTime);
     vtkstd::string string;
-    replyStream >> string;
-    message->ParseFromString(string);
+    if (vtkPVSessionServer::ReadMessage(replyStream, string))
+      {
+      message->ParseFromString(string);
+      }
     }
   else
     {
@@ -497,6 +786,10 @@ void vtkSMSessionClient::ExecuteStream(
   vtkTypeUInt32 location, const vtkClientServerStream& cssstream,
   bool ignore_errors)
 {
+  this->FlushTransaction();
+  // The stream may make the servers send data to the client directly (e.g.
+  // vtkClientServerMoveData), which must come after the pending replies.
+  this->WaitForAllReplies();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
@@ -521,16 +814,15 @@ void vtkSMSessionClient::ExecuteStream(
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::EXECUTE_STREAM)
       << static_cast<int>(ignore_errors) << static_cast<int>(size);
-    vtkstd::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
 
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->TriggerRMI(controllers[cc], vtkPVSessionServer::EXECUTE_STREAM,
+        stream);
       controllers[cc]->Send(data, static_cast<int>(size), 1,
         vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      this->Internals->Statistics[vtkPVSessionServer::EXECUTE_STREAM]
+        .BytesSent += static_cast<vtkIdType>(size);
       }
     }
 
@@ -543,6 +835,8 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushTransaction();
+  this->WaitForAllReplies();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controller = NULL;
@@ -565,13 +859,10 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
     {
     this->ServerLastInvokeResult->Reset();
 
+    double sendTime = vtkTimerLog::GetUniversalTime();
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::LAST_RESULT);
-    vtkstd::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    this->TriggerRMI(controller, vtkPVSessionServer::LAST_RESULT, stream);
 
     // Get the reply
     int size=0;
@@ -580,6 +871,8 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
     controller->Receive(raw_data, size, 1, vtkPVSessionServer::REPLY_LAST_RESULT);
     this->ServerLastInvokeResult->SetData(raw_data, size);
     delete [] raw_data;
+    this->Internals->RecordReply(vtkPVSessionServer::LAST_RESULT,
+      static_cast<vtkIdType>(sizeof(size) + size), sendTime);
     return *this->ServerLastInvokeResult;
     }
 
@@ -590,6 +883,8 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushTransaction();
+  this->WaitForAllReplies();
   if (this->RenderServerController == NULL)
     {
     // re-route all render-server messages to data-server.
@@ -621,8 +916,6 @@ bool vtkSMSessionClient::GatherInformation(
     << information->GetClassName()
     << globalid;
   information->CopyParametersToStream(stream);
-  vtkstd::vector<unsigned char> raw_message;
-  stream.GetRawData(raw_message);
 
   vtkMultiProcessController* controller = NULL;
 
@@ -641,9 +934,9 @@ bool vtkSMSessionClient::GatherInformation(
 
   if (controller)
     {
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    double sendTime = vtkTimerLog::GetUniversalTime();
+    this->TriggerRMI(controller, vtkPVSessionServer::GATHER_INFORMATION,
+      stream);
 
     int length2 = 0;
     controller->Receive(&length2, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
@@ -664,14 +957,209 @@ bool vtkSMSessionClient::GatherInformation(
     csstream.SetData(data2, length2);
     information->CopyFromStream(&csstream);
     delete [] data2;
+    this->Internals->RecordReply(vtkPVSessionServer::GATHER_INFORMATION,
+      static_cast<vtkIdType>(sizeof(length2) + length2), sendTime);
     }
 
   return false;
 }
 
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMSessionClient::PullStateAsync(vtkSMMessage* message)
+{
+  this->FlushTransaction();
+  vtkTypeUInt32 location = this->GetRealLocation(message->location());
+  message->set_location(location);
+
+  // Same priority order as PullState().
+  vtkMultiProcessController* controller = NULL;
+  if ( (location & vtkPVSession::CLIENT) != 0)
+    {
+    controller = NULL;
+    }
+  else if ( (location &
+      (vtkPVSession::DATA_SERVER | vtkPVSession::DATA_SERVER_ROOT)) != 0)
+    {
+    controller = this->DataServerController;
+    }
+  else if ( (location &
+      (vtkPVSession::RENDER_SERVER | vtkPVSession::RENDER_SERVER_ROOT)) != 0)
+    {
+    controller = this->RenderServerController;
+    }
+
+  if (!controller)
+    {
+    this->PullState(message);
+    return 0;
+    }
+
+  vtkInternals::InFlightRequest request;
+  request.Id = this->Internals->NextRequestId();
+  request.Type = vtkPVSessionServer::PULL_ASYNC;
+  request.SendTime = vtkTimerLog::GetUniversalTime();
+  request.Controller = controller;
+  request.Message = message;
+  request.Information = NULL;
+
+  vtkMultiProcessStream stream;
+  stream << static_cast<int>(vtkPVSessionServer::PULL_ASYNC);
+  stream << request.Id;
+  vtkPVSessionServer::WriteMessage(stream, message->SerializeAsString(),
+    this->GetCompressionThreshold(controller));
+  this->TriggerRMI(controller, vtkPVSessionServer::PULL_ASYNC, stream);
+
+  this->Internals->InFlight.push_back(request);
+  return request.Id;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt32 vtkSMSessionClient::GatherInformationAsync(
+  vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
+{
+  this->FlushTransaction();
+  location = this->GetRealLocation(location);
+
+  // Same controller selection as GatherInformation().
+  vtkMultiProcessController* controller = NULL;
+  if ( (location & vtkPVSession::CLIENT) != 0)
+    {
+    controller = NULL;
+    }
+  else if ( (location &
+      (vtkPVSession::DATA_SERVER | vtkPVSession::DATA_SERVER_ROOT)) != 0)
+    {
+    controller = this->DataServerController;
+    }
+  else if ( (location &
+      (vtkPVSession::RENDER_SERVER | vtkPVSession::RENDER_SERVER_ROOT)) != 0)
+    {
+    controller = this->RenderServerController;
+    }
+
+  if (!controller)
+    {
+    this->GatherInformation(location, information, globalid);
+    return 0;
+    }
+
+  vtkInternals::InFlightRequest request;
+  request.Id = this->Internals->NextRequestId();
+  request.Type = vtkPVSessionServer::GATHER_INFORMATION_ASYNC;
+  request.SendTime = vtkTimerLog::GetUniversalTime();
+  request.Controller = controller;
+  request.Message = NULL;
+  request.Information = information;
+
+  vtkMultiProcessStream stream;
+  stream << static_cast<int>(vtkPVSessionServer::GATHER_INFORMATION_ASYNC)
+    << request.Id
+    << location
+    << information->GetClassName()
+    << globalid;
+  information->CopyParametersToStream(stream);
+  this->TriggerRMI(controller, vtkPVSessionServer::GATHER_INFORMATION_ASYNC,
+    stream);
+
+  this->Internals->InFlight.push_back(request);
+  return request.Id;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMSessionClient::WaitForReply(vtkTypeUInt32 requestId)
+{
+  // Replies come back in order, hence receive every earlier one first.
+  while (this->Internals->IsInFlight(requestId))
+    {
+    this->ReceiveNextReply();
+    }
+  return this->Internals->FinishRequest(requestId);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::WaitForAllReplies()
+{
+  while (!this->Internals->InFlight.empty())
+    {
+    this->ReceiveNextReply();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkSMSessionClient::ReceiveNextReply()
+{
+  vtkInternals::InFlightRequest request = this->Internals->InFlight.front();
+  this->Internals->InFlight.pop_front();
+
+  // Marked as failed until the reply is successfully received.
+  vtkInternals::CompletedRequest& completed =
+    this->Internals->Completed[request.Id];
+  completed.Message = request.Message;
+
+  vtkTypeUInt32 replyId = 0;
+  if (request.Message)
+    {
+    vtkMultiProcessStream replyStream;
+    request.Controller->Receive(replyStream, 1, vtkPVSessionServer::REPLY_PULL);
+    this->Internals->RecordReply(request.Type,
+      vtkInternals::GetWireSize(replyStream), request.SendTime);
+    vtkstd::string string;
+    replyStream >> replyId;
+    if (replyId != request.Id)
+      {
+      vtkErrorMacro("Received reply " << replyId << " while expecting "
+        << request.Id << ".");
+      return false;
+      }
+    if (!vtkPVSessionServer::ReadMessage(replyStream, string))
+      {
+      return false;
+      }
+    completed.State = string;
+    completed.Status = true;
+    return true;
+    }
+
+  request.Controller->Receive(&replyId, 1, 1,
+    vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+  if (replyId != request.Id)
+    {
+    vtkErrorMacro("Received reply " << replyId << " while expecting "
+      << request.Id << ".");
+    return false;
+    }
+
+  int length = 0;
+  request.Controller->Receive(&length, 1, 1,
+    vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
+  if (length <= 0)
+    {
+    vtkErrorMacro("Server failed to gather information.");
+    return false;
+    }
+  unsigned char* data = new unsigned char[length];
+  if (!request.Controller->Receive((char*)data, length, 1,
+      vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG))
+    {
+    vtkErrorMacro("Failed to receive information correctly.");
+    delete [] data;
+    return false;
+    }
+  vtkClientServerStream csstream;
+  csstream.SetData(data, length);
+  request.Information->CopyFromStream(&csstream);
+  delete [] data;
+  this->Internals->RecordReply(request.Type,
+    static_cast<vtkIdType>(sizeof(replyId) + sizeof(length) + length),
+    request.SendTime);
+  completed.Status = true;
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::DeleteSIObject(vtkSMMessage* message)
 {
+  this->FlushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
@@ -689,16 +1177,13 @@ void vtkSMSessionClient::DeleteSIObject(vtkSMMessage* message)
     }
   if (num_controllers > 0)
     {
+    // Not worth compressing.
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::DELETE_SI);
-    stream << message->SerializeAsString();
-    vtkstd::vector<unsigned char> raw_message;
-    stream.GetRawData(raw_message);
+    vtkPVSessionServer::WriteMessage(stream, message->SerializeAsString(), 0);
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->TriggerRMI(controllers[cc], vtkPVSessionServer::DELETE_SI, stream);
       }
     }
 
@@ -708,8 +1193,89 @@ void vtkSMSessionClient::DeleteSIObject(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::TriggerRMI(vtkMultiProcessController* controller,
+  int type, vtkMultiProcessStream& stream)
+{
+  vtkstd::vector<unsigned char> raw_message;
+  stream.GetRawData(raw_message);
+  controller->TriggerRMIOnAllChildren(
+    &raw_message[0], static_cast<int>(raw_message.size()),
+    vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+
+  vtkInternals::Counters& counters = this->Internals->Statistics[type];
+  counters.Messages++;
+  counters.BytesSent += static_cast<vtkIdType>(raw_message.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkSMSessionClient::GetCompressionThreshold(
+  vtkMultiProcessController* controller)
+{
+  if (controller != NULL && controller == this->DataServerController)
+    {
+    return this->Internals->DataServerCompressionThreshold;
+    }
+  if (controller != NULL && controller == this->RenderServerController)
+    {
+    return this->Internals->RenderServerCompressionThreshold;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSMSessionClient::GetNumberOfMessages(int type)
+{
+  return this->Internals->GetCounters(type).Messages;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSMSessionClient::GetNumberOfBytesSent(int type)
+{
+  return this->Internals->GetCounters(type).BytesSent;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSMSessionClient::GetNumberOfBytesReceived(int type)
+{
+  return this->Internals->GetCounters(type).BytesReceived;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSMSessionClient::GetNumberOfRoundTrips(int type)
+{
+  return this->Internals->GetCounters(type).RoundTrips;
+}
+
+//----------------------------------------------------------------------------
+double vtkSMSessionClient::GetRoundTripTime(int type)
+{
+  return this->Internals->GetCounters(type).RoundTripTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::ResetCounters()
+{
+  this->Internals->Statistics.clear();
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DataServerCompressionThreshold: "
+    << this->Internals->DataServerCompressionThreshold << endl;
+  os << indent << "RenderServerCompressionThreshold: "
+    << this->Internals->RenderServerCompressionThreshold << endl;
+  vtkstd::map<int, vtkInternals::Counters>::iterator iter;
+  for (iter = this->Internals->Statistics.begin();
+    iter != this->Internals->Statistics.end(); ++iter)
+    {
+    os << indent << "Message type " << iter->first << ": "
+      << iter->second.Messages << " messages, "
+      << iter->second.BytesSent << " bytes sent, "
+      << iter->second.BytesReceived << " bytes received, "
+      << iter->second.RoundTrips << " round trips in "
+      << iter->second.RoundTripTime << " s" << endl;
+    }
 }
@@ -24,6 +24,7 @@
 #include "vtkSMSession.h"
 
 class vtkMultiProcessController;
+class vtkMultiProcessStream;
 class vtkPVServerInformation;
 
 class VTK_EXPORT vtkSMSessionClient : public vtkSMSession
@@ -65,6 +66,8 @@ public:
   // Description:
   // Returns the controller used to communicate with the process. Value must be
   // DATA_SERVER_ROOT or RENDER_SERVER_ROOT or CLIENT.
+  // Overridden to receive the replies to pending asynchronous requests first,
+  // so that the controller can be used directly.
   virtual vtkMultiProcessController* GetController(ServerFlags processType);
 
   // Description:
@@ -92,6 +95,12 @@ public:
     vtkTypeUInt32 location, const vtkClientServerStream& stream,
     bool ignore_errors=false);
   virtual const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location);
+
+  // Description:
+  // Returns the states queued by the current transaction, after folding.
+  // Provided for testing.
+  int GetNumberOfPendingStates();
+  const vtkSMMessage* GetPendingState(int index);
 //ETX
 
   // Description:
@@ -113,6 +122,34 @@ public:
   virtual bool GatherInformation(vtkTypeUInt32 location,
     vtkPVInformation* information, vtkTypeUInt32 globalid);
 
+//BTX
+  // Description:
+  // Asynchronous requests. Overridden to send the request to the server and
+  // return without waiting for the reply. Replies are received, in the order
+  // the requests were sent, when waited for or when anything else needs the
+  // connection (synchronous requests, ExecuteStream(), GetController()). Requests targeting the client are executed
+  // synchronously.
+  virtual vtkTypeUInt32 PullStateAsync(vtkSMMessage* message);
+//ETX
+  virtual vtkTypeUInt32 GatherInformationAsync(vtkTypeUInt32 location,
+    vtkPVInformation* information, vtkTypeUInt32 globalid);
+  virtual bool WaitForReply(vtkTypeUInt32 requestId);
+  virtual void WaitForAllReplies();
+
+  // Description:
+  // Traffic statistics on the connections to the servers, per message type
+  // (vtkPVSessionServer::PUSH, PULL, GATHER_INFORMATION, ...): number of
+  // messages and bytes sent, bytes received in replies, number of requests
+  // that waited for a reply and the total time (in seconds) spent between
+  // sending them and receiving their reply. Byte counts are the sizes on the
+  // wire, i.e. after compression. Types never used report 0.
+  vtkIdType GetNumberOfMessages(int type);
+  vtkIdType GetNumberOfBytesSent(int type);
+  vtkIdType GetNumberOfBytesReceived(int type);
+  vtkIdType GetNumberOfRoundTrips(int type);
+  double GetRoundTripTime(int type);
+  void ResetCounters();
+
   // Description:
   // Returns the number of processes on the given server/s. If more than 1
   // server is identified, than it returns the maximum number of processes e.g.
@@ -134,6 +171,32 @@ protected:
   // Delete server side object. (SIObject)
   virtual void DeleteSIObject(vtkSMMessage* msg);
 
+  // Description:
+  // Send the states pushed during the current transaction to the servers,
+  // one batch per server connection.
+  virtual void FlushTransaction();
+
+  // Description:
+  // Send a state to the servers identified by location, right away or into
+  // the current transaction.
+  void SendPushState(vtkTypeUInt32 location, vtkSMMessage* message);
+
+  // Description:
+  // Triggers CLIENT_SERVER_MESSAGE_RMI with the stream on the given server and
+  // updates the statistics for the message type.
+  void TriggerRMI(vtkMultiProcessController* controller, int type,
+    vtkMultiProcessStream& stream);
+
+  // Description:
+  // Returns the compression threshold negotiated with the server the
+  // controller is connected to.
+  int GetCompressionThreshold(vtkMultiProcessController* controller);
+
+  // Description:
+  // Receive the reply to the oldest asynchronous request still in flight.
+  // Returns false if the request failed.
+  bool ReceiveNextReply();
+
   // Description:
   // Translates the location to a real location based on whether a separate
   // render-server exists.
@@ -152,6 +215,9 @@ protected:
 
   bool AbortConnect;
   char* URI;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 private:
   vtkSMSessionClient(const vtkSMSessionClient&); // Not implemented
   void operator=(const vtkSMSessionClient&); // Not implemented
@@ -56,6 +56,7 @@ vtkSMStateLoader::vtkSMStateLoader()
   this->ServerManagerStateElement = 0;
   this->Session = 0;
   this->ProxyLocator = vtkSMProxyLocator::New();
+  this->DeferProxyCreation = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -134,10 +135,19 @@ void vtkSMStateLoader::CreatedNewProxy(int id, vtkSMProxy* proxy)
 {
   // Ensure that the proxy is created before it is registered, unless we are
   // reviving the server-side server manager, which needs special handling.
-  proxy->UpdateVTKObjects();
-  if (proxy->IsA("vtkSMSourceProxy"))
+  // In deferred mode, the creation happens on first use instead, which also
+  // takes care of updating the pipeline information.
+  if (this->DeferProxyCreation && !proxy->GetObjectsCreated())
     {
-    vtkSMSourceProxy::SafeDownCast(proxy)->UpdatePipelineInformation();
+    proxy->SetDeferredCreation(1);
+    }
+  else
+    {
+    proxy->UpdateVTKObjects();
+    if (proxy->IsA("vtkSMSourceProxy"))
+      {
+      vtkSMSourceProxy::SafeDownCast(proxy)->UpdatePipelineInformation();
+      }
     }
   this->RegisterProxy(id, proxy);
 }
@@ -562,4 +572,5 @@ int vtkSMStateLoader::LoadStateInternal(vtkPVXMLElement* rootElement)
 void vtkSMStateLoader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DeferProxyCreation: " << this->DeferProxyCreation << endl;
 }
@@ -49,6 +49,18 @@ public:
   void SetProxyLocator(vtkSMProxyLocator* loc);
   vtkGetObjectMacro(ProxyLocator, vtkSMProxyLocator);
 
+  // Description:
+  // When DeferProxyCreation is on, the proxies created from the state are
+  // registered without creating their VTK objects (see
+  // vtkSMProxy::SetDeferredCreation()). The objects are created, on all the
+  // processes, only when the proxies are first used, e.g. when a view showing
+  // them is rendered. Loading a large state then only pays for what is
+  // actually displayed. Proxies that already exist (time-keeper, animation
+  // scene) are always updated immediately. Default is off.
+  vtkSetMacro(DeferProxyCreation, int);
+  vtkGetMacro(DeferProxyCreation, int);
+  vtkBooleanMacro(DeferProxyCreation, int);
+
 protected:
   vtkSMStateLoader();
   ~vtkSMStateLoader();
@@ -106,6 +118,7 @@ protected:
 
   vtkPVXMLElement* ServerManagerStateElement;
   vtkSMProxyLocator* ProxyLocator;
+  int DeferProxyCreation;
 private:
   vtkSMStateLoader(const vtkSMStateLoader&); // Not implemented
   void operator=(const vtkSMStateLoader&); // Not implemented
@@ -0,0 +1,204 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestRedistributePolyDataExchange.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests that the non-blocking exchange of vtkRedistributePolyData gives the
+// same cells, points and attributes as the blocking one.
+// This test requires MPI and at least 2 processes.
+
+#include "vtkAllToNRedistributePolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCommunicator.h"
+#include "vtkDataArray.h"
+#include "vtkIntArray.h"
+#include "vtkMPIController.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+
+#include <string.h>
+
+//----------------------------------------------------------------------------
+// A sphere of a different size on each process, with a few vertices, the
+// sphere normals as point data and a cell data array of global cell ids.
+static vtkPolyData* CreateInput(int me)
+{
+  vtkSphereSource* sphere = vtkSphereSource::New();
+  sphere->SetCenter(me, 0.0, 0.0);
+  sphere->SetThetaResolution(8 + 8 * me);
+  sphere->SetPhiResolution(8 + 4 * me);
+  sphere->Update();
+
+  vtkPolyData* input = vtkPolyData::New();
+  input->DeepCopy(sphere->GetOutput());
+  sphere->Delete();
+
+  vtkCellArray* verts = vtkCellArray::New();
+  for (vtkIdType i = 0; i < 5; i++)
+    {
+    verts->InsertNextCell(1, &i);
+    }
+  input->SetVerts(verts);
+  verts->Delete();
+
+  vtkIntArray* ids = vtkIntArray::New();
+  ids->SetName("GlobalCellIds");
+  vtkIdType numCells = input->GetNumberOfCells();
+  ids->SetNumberOfTuples(numCells);
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    ids->SetValue(i, static_cast<int>(me * 100000 + i));
+    }
+  input->GetCellData()->AddArray(ids);
+  ids->Delete();
+  return input;
+}
+
+//----------------------------------------------------------------------------
+static bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetDataType() != b->GetDataType() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents() ||
+    a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+    return false;
+    }
+  return memcmp(a->GetVoidPointer(0), b->GetVoidPointer(0),
+    a->GetNumberOfTuples() * a->GetNumberOfComponents() *
+    a->GetDataTypeSize()) == 0;
+}
+
+//----------------------------------------------------------------------------
+static bool SameCells(vtkCellArray* a, vtkCellArray* b)
+{
+  vtkIdType size = a->GetNumberOfConnectivityEntries();
+  return a->GetNumberOfCells() == b->GetNumberOfCells() &&
+    size == b->GetNumberOfConnectivityEntries() &&
+    (size == 0 ||
+     memcmp(a->GetPointer(), b->GetPointer(), size * sizeof(vtkIdType)) == 0);
+}
+
+//----------------------------------------------------------------------------
+static bool SameAttributes(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    return false;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* array = a->GetArray(i);
+    if (!SameArrays(array, b->GetArray(array->GetName())))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static int TestExchange(vtkMPIController* controller)
+{
+  int me = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  vtkPolyData* input = CreateInput(me);
+
+  // Everything goes to the first half of the processes.
+  vtkAllToNRedistributePolyData* blocking =
+    vtkAllToNRedistributePolyData::New();
+  blocking->SetController(controller);
+  blocking->SetNumberOfProcesses(numProcs / 2);
+  blocking->UseNonBlockingExchangeOff();
+  blocking->SetInput(input);
+  blocking->Update();
+
+  vtkAllToNRedistributePolyData* nonBlocking =
+    vtkAllToNRedistributePolyData::New();
+  nonBlocking->SetController(controller);
+  nonBlocking->SetNumberOfProcesses(numProcs / 2);
+  nonBlocking->UseNonBlockingExchangeOn();
+  nonBlocking->SetNumberOfThreads(2);
+  nonBlocking->SetInput(input);
+  nonBlocking->Update();
+
+  vtkPolyData* expected = blocking->GetOutput();
+  vtkPolyData* output = nonBlocking->GetOutput();
+  int result = 0;
+  if (!SameCells(expected->GetVerts(), output->GetVerts()) ||
+    !SameCells(expected->GetLines(), output->GetLines()) ||
+    !SameCells(expected->GetPolys(), output->GetPolys()) ||
+    !SameCells(expected->GetStrips(), output->GetStrips()))
+    {
+    cerr << "ERROR: process " << me << ": cells differ" << endl;
+    result = 1;
+    }
+  else if (expected->GetNumberOfPoints() != output->GetNumberOfPoints() ||
+    (expected->GetNumberOfPoints() > 0 && !SameArrays(
+      expected->GetPoints()->GetData(), output->GetPoints()->GetData())))
+    {
+    cerr << "ERROR: process " << me << ": points differ" << endl;
+    result = 1;
+    }
+  else if (!SameAttributes(expected->GetPointData(), output->GetPointData()) ||
+    !SameAttributes(expected->GetCellData(), output->GetCellData()))
+    {
+    cerr << "ERROR: process " << me << ": attributes differ" << endl;
+    result = 1;
+    }
+
+  // No cell lost on the way.
+  vtkIdType counts[2] = { input->GetNumberOfCells(),
+    output->GetNumberOfCells() };
+  vtkIdType totals[2];
+  controller->AllReduce(counts, totals, 2, vtkCommunicator::SUM_OP);
+  if (totals[0] != totals[1])
+    {
+    cerr << "ERROR: process " << me << ": cells lost" << endl;
+    result = 1;
+    }
+  if (me >= numProcs / 2 && output->GetNumberOfCells() != 0)
+    {
+    cerr << "ERROR: process " << me << ": cells not sent" << endl;
+    result = 1;
+    }
+
+  nonBlocking->Delete();
+  blocking->Delete();
+  input->Delete();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int result = 1;
+  if (controller->GetNumberOfProcesses() < 2)
+    {
+    cerr << "ERROR: this test requires at least 2 processes" << endl;
+    }
+  else
+    {
+    int localResult = TestExchange(controller);
+    controller->AllReduce(&localResult, &result, 1, vtkCommunicator::MAX_OP);
+    }
+
+  controller->Finalize();
+  controller->Delete();
+  return result;
+}
@@ -29,12 +29,15 @@ vtkBSPCutsGenerator::vtkBSPCutsGenerator()
 {
   this->Enabled = true;
   this->PKdTree = 0;
+  this->CutsReuseTolerance = 0.1;
+  this->KdTreeManager = vtkKdTreeManager::New();
 }
 
 //----------------------------------------------------------------------------
 vtkBSPCutsGenerator::~vtkBSPCutsGenerator()
 {
   this->SetPKdTree(0);
+  this->KdTreeManager->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -78,7 +81,8 @@ int vtkBSPCutsGenerator::RequestData(vtkInformation *,
     vtkMultiProcessController::GetGlobalController();
   if (this->Enabled && controller && controller->GetNumberOfProcesses() > 1)
     {
-    vtkKdTreeManager* mgr = vtkKdTreeManager::New();
+    vtkKdTreeManager* mgr = this->KdTreeManager;
+    mgr->SetCutsReuseTolerance(this->CutsReuseTolerance);
     vtkBSPCuts* output = vtkBSPCuts::GetData(outputVector, 0);
     for (int cc=0; cc < inputVector[0]->GetNumberOfInformationObjects(); cc++)
       {
@@ -101,9 +105,10 @@ int vtkBSPCutsGenerator::RequestData(vtkInformation *,
 
     this->SetPKdTree(mgr->GetKdTree());
 
+    // Don't hold on to the producers, the KdTree is kept for the next
+    // execution.
     mgr->RemoveAllProducers();
     mgr->SetStructuredProducer(NULL);
-    mgr->Delete();
     }
   return 1;
 }
@@ -126,5 +131,7 @@ void vtkBSPCutsGenerator::SetPKdTree(vtkPKdTree* tree)
 void vtkBSPCutsGenerator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << this->Enabled << endl;
+  os << indent << "CutsReuseTolerance: " << this->CutsReuseTolerance << endl;
 }
 
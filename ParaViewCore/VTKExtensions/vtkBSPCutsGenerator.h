@@ -14,12 +14,17 @@
 =========================================================================*/
 // .NAME vtkBSPCutsGenerator
 // .SECTION Description
-//
+// vtkBSPCutsGenerator builds a vtkPKdTree partitioning all its inputs among
+// the processes and produces its cuts. The same vtkKdTreeManager is used for
+// every execution so that, for data that moves little from one timestep to
+// the next, the cuts can be kept (see CutsReuseTolerance) and the data
+// distributed with them does not have to move.
 
 #ifndef __vtkBSPCutsGenerator_h
 #define __vtkBSPCutsGenerator_h
 
 #include "vtkDataObjectAlgorithm.h"
+class vtkKdTreeManager;
 class vtkPKdTree;
 
 class VTK_EXPORT vtkBSPCutsGenerator : public vtkDataObjectAlgorithm
@@ -34,6 +39,12 @@ public:
   vtkSetMacro(Enabled, bool);
   vtkGetMacro(Enabled, bool);
 
+  // Description:
+  // Passed to the vtkKdTreeManager. See
+  // vtkKdTreeManager::SetCutsReuseTolerance(). Default is 0.1.
+  vtkSetClampMacro(CutsReuseTolerance, double, 0.0, 1.0);
+  vtkGetMacro(CutsReuseTolerance, double);
+
   // This is only valid after Update().
   vtkGetObjectMacro(PKdTree, vtkPKdTree);
 
@@ -51,6 +62,8 @@ protected:
   void SetPKdTree(vtkPKdTree*);
   vtkPKdTree* PKdTree;
   bool Enabled;
+  double CutsReuseTolerance;
+  vtkKdTreeManager* KdTreeManager;
 private:
   vtkBSPCutsGenerator(const vtkBSPCutsGenerator&); // Not implemented
   void operator=(const vtkBSPCutsGenerator&); // Not implemented
@@ -17,6 +17,125 @@
 #include "vtkObjectFactory.h"
 #include "vtkFieldData.h"
 #include "vtkAbstractArray.h"
+#include "vtkDataArray.h"
+#include "vtkStringArray.h"
+#include "vtkVariant.h"
+
+#include <limits>
+#include <locale.h>
+#include <stdio.h>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+namespace
+{
+  // Returns whether an integral value is negative, without comparing unsigned
+  // values to 0.
+  template <class T, bool IsSigned>
+  struct vtkIsNegative
+    {
+    static bool Test(T) { return false; }
+    };
+  template <class T>
+  struct vtkIsNegative<T, true>
+    {
+    static bool Test(T value) { return value < static_cast<T>(0); }
+    };
+
+  // Appends the decimal representation of an integral value. char types end up
+  // here too, which writes them as integers rather than as characters.
+  template <class T>
+  inline void vtkAppendValue(vtkstd::string& buffer, T value, char)
+    {
+    char tmp[32];
+    char* end = tmp + sizeof(tmp);
+    char* cur = end;
+    bool negative =
+      vtkIsNegative<T, std::numeric_limits<T>::is_signed>::Test(value);
+    vtkTypeUInt64 magnitude = negative?
+      (0 - static_cast<vtkTypeUInt64>(value)) : static_cast<vtkTypeUInt64>(value);
+    do
+      {
+      *--cur = static_cast<char>('0' + (magnitude % 10));
+      magnitude /= 10;
+      }
+    while (magnitude != 0);
+    if (negative)
+      {
+      *--cur = '-';
+      }
+    buffer.append(cur, end - cur);
+    }
+
+  // Real values use the same format as the default ostream (6 significant
+  // digits) but printf honors LC_NUMERIC, so the locale's decimal point is
+  // replaced by '.'.
+  inline void vtkAppendValue(vtkstd::string& buffer, double value,
+    char decimalPoint)
+    {
+    char tmp[64];
+    int len = sprintf(tmp, "%g", value);
+    if (decimalPoint != '.')
+      {
+      for (int cc=0; cc < len; cc++)
+        {
+        if (tmp[cc] == decimalPoint)
+          {
+          tmp[cc] = '.';
+          }
+        }
+      }
+    buffer.append(tmp, len);
+    }
+
+  inline void vtkAppendValue(vtkstd::string& buffer, float value,
+    char decimalPoint)
+    {
+    vtkAppendValue(buffer, static_cast<double>(value), decimalPoint);
+    }
+
+  template <class T>
+  inline void vtkAppendValues(vtkstd::string& buffer, const T* values,
+    vtkIdType index, char decimalPoint)
+    {
+    vtkAppendValue(buffer, values[index], decimalPoint);
+    }
+
+  // An array to export along with its downcasts, resolved once per block
+  // rather than for every value.
+  struct vtkColumn
+    {
+    vtkAbstractArray* Array;
+    vtkDataArray* DataArray;
+    vtkStringArray* StringArray;
+    int NumberOfComponents;
+    };
+
+  void vtkAppendValue(vtkstd::string& buffer, const vtkColumn& column,
+    vtkIdType index, char decimalPoint)
+    {
+    if (column.DataArray)
+      {
+      switch (column.DataArray->GetDataType())
+        {
+        vtkTemplateMacro(
+          vtkAppendValues(buffer,
+            static_cast<VTK_TT*>(column.DataArray->GetVoidPointer(0)),
+            index, decimalPoint));
+      default:
+        buffer += column.Array->GetVariantValue(index).ToString();
+        }
+      }
+    else if (column.StringArray)
+      {
+      buffer += column.StringArray->GetValue(index);
+      }
+    else
+      {
+      buffer += column.Array->GetVariantValue(index).ToString();
+      }
+    }
+}
 
 vtkStandardNewMacro(vtkCSVExporter);
 //----------------------------------------------------------------------------
@@ -26,6 +145,7 @@ vtkCSVExporter::vtkCSVExporter()
   this->FileName=0;
   this->FieldDelimiter =0;
   this->SetFieldDelimiter(",");
+  this->WriteOnServer = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -95,36 +215,49 @@ void vtkCSVExporter::WriteData(vtkFieldData* data)
     }
   vtkIdType numTuples = data->GetNumberOfTuples();
   int numArrays = data->GetNumberOfArrays();
+
+  vtkstd::vector<vtkColumn> columns(numArrays);
+  for (int cc=0; cc < numArrays; cc++)
+    {
+    vtkColumn& column = columns[cc];
+    column.Array = data->GetAbstractArray(cc);
+    column.DataArray = vtkDataArray::SafeDownCast(column.Array);
+    column.StringArray = vtkStringArray::SafeDownCast(column.Array);
+    column.NumberOfComponents = column.Array->GetNumberOfComponents();
+    }
+
+  const char decimalPoint = localeconv()->decimal_point[0];
+  const char* delimiter = this->FieldDelimiter? this->FieldDelimiter : "";
+
+  // Rows are formatted into a reused buffer and handed to the stream in large
+  // chunks.
+  vtkstd::string buffer;
+  buffer.reserve(65536);
   for (vtkIdType tuple=0; tuple < numTuples; tuple++)
     {
     bool first = true;
     for (int cc=0; cc < numArrays; cc++)
       {
-      vtkAbstractArray* array = data->GetAbstractArray(cc);
-      int numComps = array->GetNumberOfComponents();
+      const vtkColumn& column = columns[cc];
+      int numComps = column.NumberOfComponents;
       for (int comp=0; comp < numComps; comp++)
         {
         if (!first)
           {
-          (*this->FileStream) << this->FieldDelimiter;
+          buffer += delimiter;
           }
-        vtkVariant value = array->GetVariantValue(tuple*numComps + comp);
-
-        // to avoid weird characters in the output, cast char /
-        // signed char / unsigned char variables to integers
-        value =   ( value.IsChar() ||
-                    value.IsSignedChar() ||
-                    value.IsUnsignedChar()
-                  )
-                ? vtkVariant( value.ToInt() )
-                : value;
-
-        (*this->FileStream) << value.ToString().c_str();
+        vtkAppendValue(buffer, column, tuple*numComps + comp, decimalPoint);
         first = false;
         }
       }
-    (*this->FileStream) << "\n";
+    buffer += "\n";
+    if (buffer.size() >= 65536)
+      {
+      this->FileStream->write(buffer.c_str(), buffer.size());
+      buffer.clear();
+      }
     }
+  this->FileStream->write(buffer.c_str(), buffer.size());
 }
 
 //----------------------------------------------------------------------------
@@ -145,6 +278,7 @@ void vtkCSVExporter::Close()
 void vtkCSVExporter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "WriteOnServer: " << this->WriteOnServer << endl;
 }
 
 
@@ -15,7 +15,10 @@
 // .NAME vtkCSVExporter - exporter used to save vtkFieldData as CSV.
 // .SECTION Description
 // This is used by vtkSMCSVExporterProxy to export the data shown in the
-// spreadsheet view as a CSV.
+// spreadsheet view as a CSV. The data is written one block at a time as it is
+// streamed by the view, so the full table never needs to fit in memory.
+// Numbers are formatted without going through ostream and always use '.' as
+// the decimal separator, whatever the current locale.
 
 #ifndef __vtkCSVExporter_h
 #define __vtkCSVExporter_h
@@ -40,6 +43,14 @@ public:
   vtkSetStringMacro(FieldDelimiter);
   vtkGetStringMacro(FieldDelimiter);
 
+  // Description:
+  // When set, and connected to a remote server, the file is written by the
+  // server's root process (FileName is then a path on the server) instead of
+  // streaming every block to the client. Off by default.
+  vtkSetMacro(WriteOnServer, int);
+  vtkGetMacro(WriteOnServer, int);
+  vtkBooleanMacro(WriteOnServer, int);
+
   bool Open();
   void WriteHeader(vtkFieldData*);
   void WriteData(vtkFieldData*);
@@ -52,6 +63,7 @@ protected:
 
   char* FileName;
   char* FieldDelimiter;
+  int WriteOnServer;
 
   ofstream *FileStream;
 private:
@@ -27,6 +27,7 @@
 #include "vtkRenderWindow.h"
 #include "vtkSmartPointer.h"
 #include "vtkTilesHelper.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkOpenGLRenderWindow.h"
 #include "vtkPixelBufferObject.h"
 #include "vtkTextureObject.h"
@@ -54,6 +55,34 @@ namespace
       IceTDrawCallbackHandle->Draw(IceTDrawCallbackState);
       }
     }
+
+  // Returns the fraction of the pixels of the image that are not background.
+  double ComputeActivePixelRatio(vtkUnsignedCharArray* rgba,
+    vtkFloatArray* depths)
+    {
+    vtkIdType numPixels = 0;
+    vtkIdType numActive = 0;
+    if (rgba && rgba->GetNumberOfTuples() > 0)
+      {
+      numPixels = rgba->GetNumberOfTuples();
+      const unsigned char* ptr = rgba->GetPointer(0);
+      for (vtkIdType cc=0; cc < numPixels; cc++)
+        {
+        numActive += (ptr[4*cc+3] > 0)? 1 : 0;
+        }
+      }
+    else if (depths->GetNumberOfTuples() > 0)
+      {
+      numPixels = depths->GetNumberOfTuples();
+      const float* ptr = depths->GetPointer(0);
+      for (vtkIdType cc=0; cc < numPixels; cc++)
+        {
+        numActive += (ptr[cc] < 1.0f)? 1 : 0;
+        }
+      }
+    return numPixels > 0?
+      static_cast<double>(numActive) / static_cast<double>(numPixels) : 0.0;
+    }
 };
 
 vtkStandardNewMacro(vtkIceTCompositePass);
@@ -83,6 +112,13 @@ vtkIceTCompositePass::vtkIceTCompositePass()
 
   this->UseOrderedCompositing = false;
   this->DepthOnly=false;
+
+  this->CompositeStrategy = AUTOMATIC;
+  this->UseFloatingPointColorForBlending = false;
+  this->LastCompositeTime = 0.0;
+  this->LastDrawTime = 0.0;
+  this->LastBytesSent = 0;
+  this->LastActivePixelRatio = 0.0;
   
   this->LastRenderedEyes[0] = new vtkSynchronizedRenderers::vtkRawImage();
   this->LastRenderedEyes[1] = new vtkSynchronizedRenderers::vtkRawImage();
@@ -183,7 +219,7 @@ void vtkIceTCompositePass::SetupContext(const vtkRenderState* render_state)
   this->UpdateTileInformation(render_state);
 
   // Set IceT compositing strategy.
-  icetStrategy(ICET_STRATEGY_REDUCE);
+  this->UpdateStrategy();
 
   bool use_ordered_compositing =
     (this->KdTree && this->UseOrderedCompositing && !this->DepthOnly &&
@@ -202,15 +238,19 @@ void vtkIceTCompositePass::SetupContext(const vtkRenderState* render_state)
     // ICET_DEPTH_BUFFER_BIT in  the input-buffer argument.
     if (use_ordered_compositing)
       {
-      icetSetColorFormat(ICET_IMAGE_COLOR_RGBA_UBYTE);
+      icetSetColorFormat(this->UseFloatingPointColorForBlending?
+        ICET_IMAGE_COLOR_RGBA_FLOAT : ICET_IMAGE_COLOR_RGBA_UBYTE);
       icetSetDepthFormat(ICET_IMAGE_DEPTH_NONE);
       icetCompositeMode(ICET_COMPOSITE_MODE_BLEND);
       }
     else
       {
+      // The depth is needed to composite but only the color of the
+      // composited image is read back, so IceT can drop the depth before
+      // collecting the final image.
       icetSetColorFormat(ICET_IMAGE_COLOR_RGBA_UBYTE);
       icetSetDepthFormat(ICET_IMAGE_DEPTH_FLOAT);
-      icetDisable(ICET_COMPOSITE_ONE_BUFFER);
+      icetEnable(ICET_COMPOSITE_ONE_BUFFER);
       icetCompositeMode(ICET_COMPOSITE_MODE_Z_BUFFER);
       }
     }
@@ -356,6 +396,57 @@ void vtkIceTCompositePass::SetupContext(const vtkRenderState* render_state)
   //icetEnable(ICET_CORRECT_COLORED_BACKGROUND);
 }
 
+//----------------------------------------------------------------------------
+void vtkIceTCompositePass::UpdateStrategy()
+{
+  int numProcs = this->IceTContext->GetController()->GetNumberOfProcesses();
+  bool tile_display_mode = (this->TileDimensions[0] > 1 ||
+    this->TileDimensions[1] > 1);
+
+  int strategy = this->CompositeStrategy;
+  if (strategy == AUTOMATIC)
+    {
+    if (numProcs <= 2)
+      {
+      strategy = TREE;
+      }
+    else if ((numProcs & (numProcs - 1)) == 0)
+      {
+      strategy = BINARY_SWAP;
+      }
+    else
+      {
+      strategy = RADIXK;
+      }
+    }
+
+  // With several tiles, the images are reduced to the tile processes first;
+  // the single image strategy is then used within each tile.
+  icetStrategy((tile_display_mode || strategy == REDUCE)?
+    ICET_STRATEGY_REDUCE : ICET_STRATEGY_SEQUENTIAL);
+  switch (strategy)
+    {
+  case TREE:
+    icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_TREE);
+    break;
+
+  case BINARY_SWAP:
+    icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_BSWAP);
+    break;
+
+  case RADIXK:
+#ifdef ICET_SINGLE_IMAGE_STRATEGY_RADIXK
+    icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_RADIXK);
+#else
+    icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
+#endif
+    break;
+
+  default:
+    icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkIceTCompositePass::CleanupContext(const vtkRenderState*)
 {
@@ -406,7 +497,9 @@ void vtkIceTCompositePass::Render(const vtkRenderState* render_state)
     {
     this->LastRenderedRGBAColors->MarkInValid();
     }
-  if (icetImageGetDepthFormat(renderedImage) != ICET_IMAGE_DEPTH_NONE)
+  // The composited depth is only used to push it back to the screen.
+  if (this->DepthOnly &&
+    icetImageGetDepthFormat(renderedImage) != ICET_IMAGE_DEPTH_NONE)
     {
     this->LastRenderedDepths->SetNumberOfComponents(1);
     this->LastRenderedDepths->SetNumberOfTuples(numPixels);
@@ -419,6 +512,20 @@ void vtkIceTCompositePass::Render(const vtkRenderState* render_state)
     this->LastRenderedDepths->SetNumberOfTuples(0);
     }
 
+  // Statistics.
+  IceTDouble time;
+  icetGetDoublev(ICET_COMPOSITE_TIME, &time);
+  this->LastCompositeTime = time;
+  icetGetDoublev(ICET_TOTAL_DRAW_TIME, &time);
+  this->LastDrawTime = time;
+  IceTInt bytes;
+  icetGetIntegerv(ICET_BYTES_SENT, &bytes);
+  this->LastBytesSent = bytes;
+  this->LastActivePixelRatio = ComputeActivePixelRatio(
+    this->LastRenderedRGBAColors->IsValid()?
+    this->LastRenderedRGBAColors->GetRawPtr() : NULL,
+    this->LastRenderedDepths);
+
   if(this->DepthOnly)
     {
     this->PushIceTDepthBufferToScreen(render_state);
@@ -894,6 +1001,14 @@ void vtkIceTCompositePass::PrintSelf(ostream& os, vtkIndent indent)
      << this->UseOrderedCompositing << endl;
   os << indent << "DepthOnly: " << this->DepthOnly << endl;
   os << indent << "FixBackground: " << this->FixBackground << endl;
+  os << indent << "CompositeStrategy: " << this->CompositeStrategy << endl;
+  os << indent << "UseFloatingPointColorForBlending: "
+     << this->UseFloatingPointColorForBlending << endl;
+  os << indent << "LastCompositeTime: " << this->LastCompositeTime << endl;
+  os << indent << "LastDrawTime: " << this->LastDrawTime << endl;
+  os << indent << "LastBytesSent: " << this->LastBytesSent << endl;
+  os << indent << "LastActivePixelRatio: "
+     << this->LastActivePixelRatio << endl;
   os << indent << "PhysicalViewport: "
      << this->PhysicalViewport[0] << ", " << this->PhysicalViewport[1]
      << this->PhysicalViewport[2] << ", " << this->PhysicalViewport[3] << endl;
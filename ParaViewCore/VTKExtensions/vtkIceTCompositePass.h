@@ -27,6 +27,12 @@
 // TileDimensions > [1, 1] and instead of rendering a composited image
 // on the root node, it will split the view among all tiles and generate
 // renderings on all processes.
+//
+// The compositing strategy can be chosen with SetCompositeStrategy(). By
+// default it is picked automatically every frame from the number of processes
+// and tiles. After each frame, the time spent compositing and the fraction of
+// the composited image covered by geometry are available, to help tune large
+// runs.
 
 #ifndef __vtkIceTCompositePass_h
 #define __vtkIceTCompositePass_h
@@ -142,6 +148,49 @@ public:
   vtkGetMacro(FixBackground,bool);
   vtkSetMacro(FixBackground,bool);
 
+  // Description:
+  // Strategy used to composite the images. With tile displays, images are
+  // always first reduced to the processes displaying the tiles and the
+  // strategy picks how each tile is composited. AUTOMATIC uses binary-swap
+  // when the number of processes is a power of 2, radix-k otherwise (or
+  // IceT's own choice when radix-k is not available) and tree for 2 processes
+  // or less.
+  // Initial value is AUTOMATIC.
+  enum CompositeStrategies
+    {
+    AUTOMATIC = 0,
+    REDUCE,
+    TREE,
+    RADIXK,
+    BINARY_SWAP
+    };
+  vtkSetClampMacro(CompositeStrategy, int, AUTOMATIC, BINARY_SWAP);
+  vtkGetMacro(CompositeStrategy, int);
+
+  // Description:
+  // When true, colors are composited as floats when blending translucent
+  // images (ordered compositing) to avoid the loss of precision of blending
+  // many 8 bit images. This doubles the amount of data exchanged so it should
+  // only be used when needed. Otherwise colors are always composited as 8 bit
+  // RGBA.
+  // Initial value is false.
+  vtkGetMacro(UseFloatingPointColorForBlending, bool);
+  vtkSetMacro(UseFloatingPointColorForBlending, bool);
+  vtkBooleanMacro(UseFloatingPointColorForBlending, bool);
+
+  // Description:
+  // Statistics of the last frame: time spent in IceT compositing, total time
+  // of the IceT frame (including rendering and reading back buffers) and the
+  // number of bytes this process sent, as reported by IceT.
+  vtkGetMacro(LastCompositeTime, double);
+  vtkGetMacro(LastDrawTime, double);
+  vtkGetMacro(LastBytesSent, int);
+
+  // Description:
+  // Fraction of the pixels of the last composited image on this process that
+  // are covered by geometry. 0 when the process has no image.
+  vtkGetMacro(LastActivePixelRatio, double);
+
 //BTX
   // Description:
   // Returns the last rendered tile from this process, if any.
@@ -186,6 +235,10 @@ protected:
   // Updates the IceT tile information during each render.
   void UpdateTileInformation(const vtkRenderState*);
 
+  // Description:
+  // Passes the compositing strategy to IceT.
+  void UpdateStrategy();
+
   vtkMultiProcessController *Controller;
   vtkPKdTree *KdTree;
   vtkRenderPass* RenderPass;
@@ -210,6 +263,13 @@ protected:
   vtkTextureObject *ZTexture;
   vtkShaderProgram2 *Program;
 
+  int CompositeStrategy;
+  bool UseFloatingPointColorForBlending;
+  double LastCompositeTime;
+  double LastDrawTime;
+  int LastBytesSent;
+  double LastActivePixelRatio;
+
   bool FixBackground;
   vtkTextureObject *BackgroundTexture;
   vtkTextureObject *IceTTexture;
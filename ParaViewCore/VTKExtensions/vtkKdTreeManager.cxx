@@ -15,11 +15,13 @@
 #include "vtkKdTreeManager.h"
 
 #include "vtkAlgorithm.h"
+#include "vtkBoundingBox.h"
 #include "vtkCellType.h"
 #include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkKdTreeGenerator.h"
+#include "vtkMath.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPKdTree.h"
@@ -32,6 +34,7 @@
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+#include <vtkstd/algorithm>
 #include <vtkstd/set>
 #include <vtkstd/vector>
 
@@ -55,6 +58,9 @@ vtkKdTreeManager::vtkKdTreeManager()
   this->NumberOfPieces = globalController?
     globalController->GetNumberOfProcesses() : 1;
   this->KdTreeInitialized = false;
+  this->CutsReuseTolerance = 0.0;
+  this->CutsReused = false;
+  this->CutsBoundsValid = false;
 
   vtkPKdTree* tree = vtkPKdTree::New();
   tree->SetController(globalController);
@@ -117,6 +123,7 @@ void vtkKdTreeManager::SetKdTree(vtkPKdTree* tree)
     {
     vtkSetObjectBodyMacro(KdTree, vtkPKdTree, tree);
     this->KdTreeInitialized = false;
+    this->CutsBoundsValid = false;
     }
 }
 
@@ -156,6 +163,35 @@ void vtkKdTreeManager::Update()
     return;
     }
 
+  // Keep the current cuts if the data did not move much.
+  vtkstd::vector<vtkAlgorithm*> producers;
+  for (iter = this->Producers->begin(); iter != this->Producers->end(); ++iter)
+    {
+    producers.push_back(iter->GetPointer());
+    }
+  double bounds[6];
+  bool can_reuse = !this->StructuredProducer && this->KdTreeInitialized &&
+    this->CutsReuseTolerance > 0 && this->CutsBoundsValid &&
+    producers == this->CutsProducers;
+  if (can_reuse)
+    {
+    this->ComputeGlobalBounds(outputs, bounds);
+    can_reuse = this->CanReuseCuts(this->CutsBounds, bounds);
+    }
+
+  this->CutsReused = can_reuse;
+  if (can_reuse)
+    {
+    // The KdTree only needs to know about the new datasets.
+    this->KdTree->RemoveAllDataSets();
+    for (dsIter = outputs.begin(); dsIter != outputs.end(); ++dsIter)
+      {
+      this->AddDataObjectToKdTree(*dsIter);
+      }
+    this->UpdateTime.Modified();
+    return;
+    }
+
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
     {
@@ -200,6 +236,100 @@ void vtkKdTreeManager::Update()
   this->KdTree->BuildLocator();
   //this->KdTree->PrintTree();
   this->UpdateTime.Modified();
+
+  // Remember what the cuts were built for.
+  this->CutsBoundsValid = false;
+  if (!this->StructuredProducer && this->CutsReuseTolerance > 0)
+    {
+    this->ComputeGlobalBounds(outputs, this->CutsBounds);
+    this->CutsBoundsValid = vtkMath::AreBoundsInitialized(this->CutsBounds);
+    this->CutsProducers = producers;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkKdTreeManager::ComputeGlobalBounds(
+  const vtkstd::vector<vtkDataObject*>& outputs, double bounds[6])
+{
+  // minimums and negated maximums, so that a single MIN reduction is needed.
+  double local[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+    VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+  vtkstd::vector<vtkDataObject*>::const_iterator iter;
+  for (iter = outputs.begin(); iter != outputs.end(); ++iter)
+    {
+    vtkBoundingBox bbox;
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(*iter);
+    if (cd)
+      {
+      vtkCompositeDataIterator* cdIter = cd->NewIterator();
+      for (cdIter->InitTraversal(); !cdIter->IsDoneWithTraversal();
+        cdIter->GoToNextItem())
+        {
+        vtkDataSet* ds = vtkDataSet::SafeDownCast(
+          cdIter->GetCurrentDataObject());
+        if (ds && ds->GetNumberOfCells() > 0)
+          {
+          bbox.AddBounds(ds->GetBounds());
+          }
+        }
+      cdIter->Delete();
+      }
+    else
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(*iter);
+      if (ds && ds->GetNumberOfCells() > 0)
+        {
+        bbox.AddBounds(ds->GetBounds());
+        }
+      }
+    if (bbox.IsValid())
+      {
+      for (int cc=0; cc < 3; cc++)
+        {
+        local[cc] = vtkstd::min(local[cc], bbox.GetMinPoint()[cc]);
+        local[cc+3] = vtkstd::min(local[cc+3], -bbox.GetMaxPoint()[cc]);
+        }
+      }
+    }
+
+  double global[6];
+  this->KdTree->GetController()->AllReduce(local, global, 6,
+    vtkCommunicator::MIN_OP);
+  if (global[0] > -global[3])
+    {
+    vtkMath::UninitializeBounds(bounds);
+    return;
+    }
+  for (int cc=0; cc < 3; cc++)
+    {
+    bounds[2*cc] = global[cc];
+    bounds[2*cc+1] = -global[cc+3];
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkKdTreeManager::CanReuseCuts(const double oldBounds[6],
+  const double bounds[6])
+{
+  if (!vtkMath::AreBoundsInitialized(const_cast<double*>(bounds)))
+    {
+    return false;
+    }
+  for (int cc=0; cc < 3; cc++)
+    {
+    // Cells outside of the bounds of the cuts could not be assigned a region.
+    if (bounds[2*cc] < oldBounds[2*cc] || bounds[2*cc+1] > oldBounds[2*cc+1])
+      {
+      return false;
+      }
+    double oldLength = oldBounds[2*cc+1] - oldBounds[2*cc];
+    double length = bounds[2*cc+1] - bounds[2*cc];
+    if (length < (1.0 - this->CutsReuseTolerance) * oldLength)
+      {
+      return false;
+      }
+    }
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -319,6 +449,8 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "CutsReuseTolerance: " << this->CutsReuseTolerance << endl;
+  os << indent << "CutsReused: " << this->CutsReused << endl;
 }
 
 
@@ -20,6 +20,7 @@
 #define __vtkKdTreeManager_h
 
 #include "vtkObject.h"
+#include <vtkstd/vector> // needed for vtkstd::vector.
 
 class vtkPKdTree;
 class vtkAlgorithm;
@@ -59,6 +60,22 @@ public:
   vtkSetMacro(NumberOfPieces, int);
   vtkGetMacro(NumberOfPieces, int);
 
+  // Description:
+  // When greater than 0, Update() keeps the current cuts instead of
+  // rebuilding the KdTree when the data changed but the producers did not,
+  // as long as the global bounds of the data are still inside the bounds the
+  // cuts were built for and did not shrink by more than this fraction along
+  // any axis. This avoids a parallel rebuild, and a redistribution of all the
+  // data, for every timestep of data that moves little. It is not used with
+  // a StructuredProducer. Default is 0 i.e. the KdTree is always rebuilt.
+  vtkSetClampMacro(CutsReuseTolerance, double, 0.0, 1.0);
+  vtkGetMacro(CutsReuseTolerance, double);
+
+  // Description:
+  // Returns true if the last Update() that had to do something kept the
+  // existing cuts.
+  vtkGetMacro(CutsReused, bool);
+
 //BTX
 protected:
   vtkKdTreeManager();
@@ -67,11 +84,28 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject *data);
   void AddDataSetToKdTree(vtkDataSet *data);
 
+  // Description:
+  // Computes the bounds of the given data objects over all processes.
+  void ComputeGlobalBounds(const vtkstd::vector<vtkDataObject*>& outputs,
+    double bounds[6]);
+
+  // Description:
+  // Returns true if cuts built for \c oldBounds can be used for data with
+  // the given bounds.
+  bool CanReuseCuts(const double oldBounds[6], const double bounds[6]);
+
   bool KdTreeInitialized;
   vtkAlgorithm* StructuredProducer;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
   vtkTimeStamp UpdateTime;
+  double CutsReuseTolerance;
+  bool CutsReused;
+
+  // Bounds and producers the current cuts were built for.
+  double CutsBounds[6];
+  bool CutsBoundsValid;
+  vtkstd::vector<vtkAlgorithm*> CutsProducers;
 private:
   vtkKdTreeManager(const vtkKdTreeManager&); // Not implemented
   void operator=(const vtkKdTreeManager&); // Not implemented
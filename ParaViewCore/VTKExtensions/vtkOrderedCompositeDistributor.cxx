@@ -31,6 +31,7 @@
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkDistributedDataFilter.h"
 #include "vtkGarbageCollector.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -40,6 +41,8 @@
 #include "vtkPolyData.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vtkstd/vector>
+
 //-----------------------------------------------------------------------------
 
 static void D3UpdateProgress(vtkObject *_D3, unsigned long,
@@ -83,6 +86,10 @@ vtkOrderedCompositeDistributor::vtkOrderedCompositeDistributor()
   this->LastInput = NULL;
   this->LastOutput = NULL;
   this->LastCuts = vtkBSPCuts::New();
+
+  this->LastNumberOfCellsSent = 0;
+  this->LastBytesSent = 0;
+  this->LastTotalBytesSent = 0;
 }
 
 vtkOrderedCompositeDistributor::~vtkOrderedCompositeDistributor()
@@ -110,6 +117,10 @@ void vtkOrderedCompositeDistributor::PrintSelf(ostream &os, vtkIndent indent)
     (this->OutputType? this->OutputType : "(none)") << endl;
   os << indent << "D3: " << this->D3 << endl;
   os << indent << "ToPolyData" << this->ToPolyData << endl;
+  os << indent << "LastNumberOfCellsSent: " << this->LastNumberOfCellsSent
+     << endl;
+  os << indent << "LastBytesSent: " << this->LastBytesSent << endl;
+  os << indent << "LastTotalBytesSent: " << this->LastTotalBytesSent << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -256,8 +267,99 @@ int vtkOrderedCompositeDistributor::RequestData(
     return 1;
     }
 
-  this->UpdateProgress(0.01);
+  // Find out how much data has to move. If nothing does, the data is already
+  // distributed according to the cuts and the all-to-all exchange is skipped.
+  // The output must also have the type of the input for that.
+  vtkIdType numCellsToSend = this->CountCellsToSend(input);
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType local[3], global[3];
+  local[0] = numCellsToSend;
+  local[1] = numCells > 0? static_cast<vtkIdType>(
+    input->GetActualMemorySize() * 1024.0 * numCellsToSend / numCells) : 0;
+  local[2] = output->IsA(input->GetClassName())? 0 : 1;
+  this->Controller->AllReduce(local, global, 3, vtkCommunicator::SUM_OP);
+
+  this->LastNumberOfCellsSent = local[0];
+  this->LastBytesSent = local[1];
+  this->LastTotalBytesSent = global[1];
+
+  if (global[0] == 0 && global[2] == 0)
+    {
+    output->ShallowCopy(input);
+    }
+  else
+    {
+    this->UpdateProgress(0.01);
+    if (!this->Redistribute(input, cuts, output))
+      {
+      return 0;
+      }
+    }
+
+  this->LastUpdate.Modified();
+  this->LastInput = input;
+  this->LastCuts->CreateCuts(cuts->GetKdNodeTree());
+
+  if (this->LastOutput && !this->LastOutput->IsA(output->GetClassName()))
+    {
+    this->LastOutput->Delete();
+    this->LastOutput = NULL;
+    }
+  if (!this->LastOutput)
+    {
+    this->LastOutput = output->NewInstance();
+    }
+  this->LastOutput->ShallowCopy(output);
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+
+vtkIdType vtkOrderedCompositeDistributor::CountCellsToSend(vtkDataSet *input)
+{
+  int myId = this->Controller->GetLocalProcessId();
+
+  // Classify the points first, they are shared by several cells.
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  vtkstd::vector<char> remote(numPoints, 0);
+  double pt[3];
+  for (vtkIdType cc=0; cc < numPoints; cc++)
+    {
+    input->GetPoint(cc, pt);
+    int region = this->PKdTree->GetRegionContainingPoint(pt[0], pt[1], pt[2]);
+    // Points outside of the regions are left to D3.
+    if (region < 0 || this->PKdTree->GetProcessAssignedToRegion(region) != myId)
+      {
+      remote[cc] = 1;
+      }
+    }
+
+  vtkIdType numCellsToSend = 0;
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdList* ptIds = vtkIdList::New();
+  for (vtkIdType cc=0; cc < numCells; cc++)
+    {
+    input->GetCellPoints(cc, ptIds);
+    for (vtkIdType kk=0; kk < ptIds->GetNumberOfIds(); kk++)
+      {
+      if (remote[ptIds->GetId(kk)])
+        {
+        numCellsToSend++;
+        break;
+        }
+      }
+    }
+  ptIds->Delete();
+  return numCellsToSend;
+}
+
+//-----------------------------------------------------------------------------
 
+int vtkOrderedCompositeDistributor::Redistribute(vtkDataSet *input,
+                                                 vtkBSPCuts *cuts,
+                                                 vtkDataSet *output)
+{
   if (this->D3 == NULL)
     {
     this->D3 = vtkDistributedDataFilter::New();
@@ -304,21 +406,5 @@ int vtkOrderedCompositeDistributor::RequestData(
                   << "type.");
     return 0;
     }
-
-  this->LastUpdate.Modified();
-  this->LastInput = input;
-  this->LastCuts->CreateCuts(cuts->GetKdNodeTree());
-
-  if (this->LastOutput && !this->LastOutput->IsA(output->GetClassName()))
-    {
-    this->LastOutput->Delete();
-    this->LastOutput = NULL;
-    }
-  if (!this->LastOutput)
-    {
-    this->LastOutput = output->NewInstance();
-    }
-  this->LastOutput->ShallowCopy(output);
-
   return 1;
 }
@@ -35,6 +35,13 @@
 // This class also has an optional pass through mode to make it easy to
 // turn ordered compositing on and off.
 //
+// Before redistributing, every process counts its cells that touch a region
+// assigned to another process. When no process has any, e.g. when the data
+// was already distributed with the same cuts upstream, the all-to-all exchange
+// is skipped altogether. The amount of data each process sent during the last
+// redistribution is reported by GetLastNumberOfCellsSent() and
+// GetLastBytesSent().
+//
 
 #ifndef __vtkOrderedCompositeDistributor_h
 #define __vtkOrderedCompositeDistributor_h
@@ -83,6 +90,14 @@ public:
   vtkGetObjectMacro(ToPolyData, vtkDataSetSurfaceFilter);
   virtual void SetToPolyData(vtkDataSetSurfaceFilter *);
 
+  // Description:
+  // Number of cells of this process, and an estimate of their size in bytes,
+  // that had to be sent to other processes the last time the data was
+  // redistributed. GetLastTotalBytesSent() is the sum over all the processes.
+  vtkGetMacro(LastNumberOfCellsSent, vtkIdType);
+  vtkGetMacro(LastBytesSent, vtkIdType);
+  vtkGetMacro(LastTotalBytesSent, vtkIdType);
+
 protected:
   vtkOrderedCompositeDistributor();
   ~vtkOrderedCompositeDistributor();
@@ -104,6 +119,15 @@ protected:
 
   virtual void ReportReferences(vtkGarbageCollector *collector);
 
+  // Description:
+  // Returns the number of cells of \c input with at least one point in a
+  // region assigned to another process by the PKdTree.
+  vtkIdType CountCellsToSend(vtkDataSet *input);
+
+  // Description:
+  // Redistributes \c input with D3 according to \c cuts into \c output.
+  int Redistribute(vtkDataSet *input, vtkBSPCuts *cuts, vtkDataSet *output);
+
   char *OutputType;
 
   vtkDataSet *LastInput;
@@ -111,6 +135,10 @@ protected:
   vtkBSPCuts *LastCuts;
   vtkTimeStamp LastUpdate;
 
+  vtkIdType LastNumberOfCellsSent;
+  vtkIdType LastBytesSent;
+  vtkIdType LastTotalBytesSent;
+
 private:
   vtkOrderedCompositeDistributor(const vtkOrderedCompositeDistributor &);  // Not implemented.
   void operator=(const vtkOrderedCompositeDistributor &);  // Not implemented.
@@ -33,6 +33,73 @@
 
 #include <vtkstd/string>
 
+class vtkParallelSerialWriter::vtkInternals
+{
+public:
+  // The partition of Controller in NumberOfGroups groups, kept from one write
+  // to the next since partitioning a controller is a collective operation.
+  vtkSmartPointer<vtkMultiProcessController> Controller;
+  vtkSmartPointer<vtkMultiProcessController> GroupController;
+  int NumberOfGroups;
+
+  vtkInternals() : NumberOfGroups(0) {}
+
+  vtkMultiProcessController* GetGroupController(
+    vtkMultiProcessController* controller, int numGroups, int group)
+    {
+    if (this->Controller != controller || this->NumberOfGroups != numGroups)
+      {
+      int rank = controller->GetLocalProcessId();
+      this->GroupController.TakeReference(
+        controller->PartitionController(group, rank));
+      this->Controller = controller;
+      this->NumberOfGroups = numGroups;
+      }
+    return this->GroupController;
+    }
+};
+
+namespace
+{
+  // Returns the name of the file to write for filename. The aggregator group
+  // and time index are added when non-negative.
+  vtkstd::string vtkGetPieceFileName(const char* filename, int group,
+    int timeIndex)
+    {
+    if (group < 0 && timeIndex < 0)
+      {
+      return filename;
+      }
+    vtkstd::string path = vtksys::SystemTools::GetFilenamePath(filename);
+    vtkstd::string fnamenoext =
+      vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
+    vtkstd::string ext = vtksys::SystemTools::GetFilenameLastExtension(filename);
+    vtksys_ios::ostringstream fname;
+    if (!path.empty())
+      {
+      fname << path << "/";
+      }
+    fname << fnamenoext;
+    if (group >= 0)
+      {
+      fname << "_" << group;
+      }
+    if (timeIndex >= 0)
+      {
+      fname << "." << timeIndex;
+      }
+    fname << ext;
+    return fname.str();
+    }
+
+  // Processes are assigned to aggregator groups in contiguous blocks.
+  inline int vtkGetGroup(int rank, int numProcs, int numGroups)
+    {
+    return static_cast<int>(
+      (static_cast<vtkTypeInt64>(rank) * numGroups) / numProcs);
+    }
+}
+
 vtkStandardNewMacro(vtkParallelSerialWriter);
 vtkCxxSetObjectMacro(vtkParallelSerialWriter, Writer, vtkAlgorithm);
 vtkCxxSetObjectMacro(vtkParallelSerialWriter, PreGatherHelper, vtkAlgorithm);
@@ -58,6 +125,9 @@ vtkParallelSerialWriter::vtkParallelSerialWriter()
   this->NumberOfTimeSteps = 0;
   this->CurrentTimeIndex = 0;
 
+  this->NumberOfIORanks = 0;
+  this->Internals = new vtkInternals();
+
   this->Interpreter = 0;
   this->SetInterpreter(vtkClientServerInterpreterInitializer::GetInterpreter());
 }
@@ -71,6 +141,7 @@ vtkParallelSerialWriter::~vtkParallelSerialWriter()
   this->SetPreGatherHelper(0);
   this->SetPostGatherHelper(0);
   this->SetInterpreter(0);
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -225,9 +296,24 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
 {
   vtkMultiProcessController* controller =
     vtkMultiProcessController::GetGlobalController();
+
+  // When subfiling, the reduction only happens within the group of processes
+  // that share an aggregator.
+  int numProcs = controller->GetNumberOfProcesses();
+  int numGroups = 0;
+  int group = -1;
+  vtkSmartPointer<vtkMultiProcessController> groupController = controller;
+  if (this->NumberOfIORanks > 0 && numProcs > 1)
+    {
+    numGroups = this->NumberOfIORanks < numProcs?
+      this->NumberOfIORanks : numProcs;
+    group = vtkGetGroup(controller->GetLocalProcessId(), numProcs, numGroups);
+    groupController =
+      this->Internals->GetGroupController(controller, numGroups, group);
+    }
   
   vtkSmartPointer<vtkReductionFilter> md = vtkSmartPointer<vtkReductionFilter>::New();
-  md->SetController(controller);
+  md->SetController(groupController);
   md->SetPreGatherHelper(this->PreGatherHelper);
   md->SetPostGatherHelper(this->PostGatherHelper);
   if (input)
@@ -247,7 +333,7 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
     this->GhostLevel);
   md->Update();
 
-  if (controller->GetLocalProcessId() == 0)
+  if (groupController->GetLocalProcessId() == 0)
     {
     vtkDataObject* output = md->GetOutputDataObject(0);
     if (vtkDataSet::SafeDownCast(output) == 0 || 
@@ -257,23 +343,10 @@ void vtkParallelSerialWriter::WriteAFile(const char* filename, vtkDataObject* in
       outputCopy.TakeReference(output->NewInstance());
       outputCopy->ShallowCopy(output);
 
-      vtksys_ios::ostringstream fname;
-      if (this->WriteAllTimeSteps)
-        {
-        vtkstd::string path = 
-          vtksys::SystemTools::GetFilenamePath(filename);
-        vtkstd::string fnamenoext =
-          vtksys::SystemTools::GetFilenameWithoutLastExtension(filename);
-        vtkstd::string ext =
-          vtksys::SystemTools::GetFilenameLastExtension(filename);
-        fname << path << "/" << fnamenoext << "." << this->CurrentTimeIndex << ext;
-        }
-      else
-        {
-        fname << filename;
-        }
+      vtkstd::string fname = vtkGetPieceFileName(filename, group,
+        this->WriteAllTimeSteps? this->CurrentTimeIndex : -1);
       this->Writer->SetInputConnection(outputCopy->GetProducerPort());
-      this->SetWriterFileName(fname.str().c_str());
+      this->SetWriterFileName(fname.c_str());
       this->WriteInternal();
       this->Writer->SetInputConnection(0);
       }
@@ -329,4 +402,5 @@ void vtkParallelSerialWriter::SetWriterFileName(const char* fname)
 void vtkParallelSerialWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfIORanks: " << this->NumberOfIORanks << endl;
 }
@@ -20,6 +20,12 @@
 // and PostGatherHelper.
 // This also makes it possible to write time-series for temporal datasets using
 // simple non-time-aware writers.
+//
+// When NumberOfIORanks is set, the data is not gathered to the 1st node.
+// Instead, the processes are split into that many contiguous groups. Each
+// group gathers to its first process, which writes its own piece file. This
+// bounds the memory needed on any single node and lets the write bandwidth
+// scale with the number of groups.
 
 #ifndef __vtkParallelSerialWriter_h
 #define __vtkParallelSerialWriter_h
@@ -27,6 +33,7 @@
 #include "vtkDataObjectAlgorithm.h"
 
 class vtkClientServerInterpreter;
+class vtkMultiProcessController;
 
 class VTK_EXPORT vtkParallelSerialWriter : public vtkDataObjectAlgorithm
 {
@@ -96,6 +103,15 @@ public:
   vtkSetMacro(WriteAllTimeSteps, int);
   vtkBooleanMacro(WriteAllTimeSteps, int);
 
+  // Description:
+  // Number of aggregator processes used to write the data. When 0 (default),
+  // or when running on a single process, all data is gathered to the 1st node
+  // and written to FileName. Otherwise each aggregator writes a piece file
+  // named after FileName with a "_<group>" suffix. No meta file ties the
+  // pieces together: the wrapped serial formats have none.
+  vtkSetClampMacro(NumberOfIORanks, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfIORanks, int);
+
 //BTX
   // Description:
   // Get/Set the interpreter to use to call methods on the writer.
@@ -139,6 +155,11 @@ private:
   int NumberOfTimeSteps;
   int CurrentTimeIndex;
 
+  int NumberOfIORanks;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+
   // The name of the output file.
   char* FileName;
 
@@ -40,6 +40,18 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+
+#include <string.h>
+#include <vtkstd/list>
+#include <vtkstd/vector>
+
+// Determine if we can use the MPI controller for asynchronous communication.
+#ifdef VTK_USE_MPI
+#define VTK_REDIST_USE_MPI_ASYNCHRONOUS
+#include "vtkMPIController.h"
+#include "vtkMPICommunicator.h"
+#endif
 
 vtkStandardNewMacro(vtkRedistributePolyData);
 
@@ -52,12 +64,207 @@ vtkCxxSetObjectMacro(vtkRedistributePolyData, Controller,
 typedef struct {vtkTimerLog* timer; float time;} _TimerInfo;
 _TimerInfo timerInfo8;
 
+//*****************************************************************
+// Helpers for the non-blocking exchange. All the data sent to a process is
+// packed in one buffer:
+//   - the cell arrays (verts, lines, polys, strips) with point ids
+//     renumbered from 0,
+//   - each cell data array, for all the cells in the order of the types,
+//   - the point coordinates as floats,
+//   - each point data array.
+// The receiver knows the sizes of all these from the exchange of the cell
+// sizes (SendCellSizes()) so the buffers are allocated only once, before
+// anything is received.
+#ifdef VTK_REDIST_USE_MPI_ASYNCHRONOUS
+
+// Returns the number of bytes of one tuple of all the arrays.
+static vtkIdType vtkRedistributePolyDataTupleSize(vtkDataSetAttributes* attr)
+{
+  vtkIdType size = 0;
+  for (int i=0; i<attr->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* array = attr->GetArray(i);
+    size += array->GetNumberOfComponents() * array->GetDataTypeSize();
+    }
+  return size;
+}
+
+// Cells and points to send to one process.
+struct vtkRedistributePolyDataSendJob
+{
+  vtkPolyData* Input;
+  vtkCellArray* CellArrays[NUM_CELL_TYPES];
+  vtkIdType StartCell[NUM_CELL_TYPES];
+  vtkIdType StopCell[NUM_CELL_TYPES];
+  vtkIdType** SendCellList;
+  vtkIdType NumberOfPoints;
+  vtkIdType* CellArraySize;
+  int SendTo;
+  vtkSmartPointer<vtkCharArray> Buffer;
+};
+
+// Returns the id of the id-th cell of the given type to send.
+static inline vtkIdType vtkRedistributePolyDataCellId(
+  const vtkRedistributePolyDataSendJob& job, int type, vtkIdType id)
+{
+  return job.SendCellList? job.SendCellList[type][id] :
+    job.StartCell[type] + id;
+}
+
+// Packs the buffer of a job. Only reads the input so that several jobs can be
+// packed concurrently (the cell arrays are obtained beforehand since
+// vtkPolyData may create them on demand).
+static void vtkRedistributePolyDataPack(vtkRedistributePolyDataSendJob& job)
+{
+  vtkPolyData* input = job.Input;
+  vtkCellArray** cellArrays = job.CellArrays;
+
+  vtkIdType numCells[NUM_CELL_TYPES];
+  vtkIdType typeOffset[NUM_CELL_TYPES];
+  vtkIdType offset = 0;
+  int type;
+  for (type=0; type<NUM_CELL_TYPES; type++)
+    {
+    numCells[type] = job.StopCell[type] - job.StartCell[type] + 1;
+    typeOffset[type] = offset;
+    offset += cellArrays[type]? cellArrays[type]->GetNumberOfCells() : 0;
+    }
+
+  char* ptr = job.Buffer->GetPointer(0);
+
+  // ... cells, with renumbered point ids ...
+  vtkIdType numPointsMax = input->GetNumberOfPoints();
+  vtkstd::vector<vtkIdType> usedIds(numPointsMax, -1);
+  vtkstd::vector<vtkIdType> fromPtIds;
+  fromPtIds.reserve(job.NumberOfPoints);
+  for (type=0; type<NUM_CELL_TYPES; type++)
+    {
+    if (!cellArrays[type] || job.CellArraySize[type] == 0)
+      {
+      continue;
+      }
+    vtkIdType* outPtr = reinterpret_cast<vtkIdType*>(ptr);
+    vtkIdType* inPtr = cellArrays[type]->GetPointer();
+    vtkIdType prevCellId = 0;
+    for (vtkIdType id=0; id < numCells[type]; id++)
+      {
+      vtkIdType cellId = vtkRedistributePolyDataCellId(job, type, id);
+      for (; prevCellId < cellId; prevCellId++)
+        {
+        inPtr += *inPtr + 1;
+        }
+      prevCellId = cellId + 1;
+
+      vtkIdType npts = *inPtr++;
+      *outPtr++ = npts;
+      for (vtkIdType i=0; i < npts; i++)
+        {
+        vtkIdType pointId = *inPtr++;
+        if (usedIds[pointId] == -1)
+          {
+          usedIds[pointId] = static_cast<vtkIdType>(fromPtIds.size());
+          fromPtIds.push_back(pointId);
+          }
+        *outPtr++ = usedIds[pointId];
+        }
+      }
+    ptr += job.CellArraySize[type] * sizeof(vtkIdType);
+    }
+
+  // ... cell data ...
+  vtkCellData* cellData = input->GetCellData();
+  for (int i=0; i<cellData->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* array = cellData->GetArray(i);
+    int tupleSize = array->GetNumberOfComponents() * array->GetDataTypeSize();
+    const char* data = static_cast<const char*>(array->GetVoidPointer(0));
+    for (type=0; type<NUM_CELL_TYPES; type++)
+      {
+      for (vtkIdType id=0; id < numCells[type]; id++)
+        {
+        vtkIdType cellId = typeOffset[type] +
+          vtkRedistributePolyDataCellId(job, type, id);
+        memcpy(ptr, data + cellId * tupleSize, tupleSize);
+        ptr += tupleSize;
+        }
+      }
+    }
+
+  // ... points ...
+  vtkIdType numPoints = static_cast<vtkIdType>(fromPtIds.size());
+  vtkDataArray* points = input->GetPoints()->GetData();
+  float* outPoints = reinterpret_cast<float*>(ptr);
+  switch (points->GetDataType())
+    {
+    vtkTemplateMacro(
+      const VTK_TT* inPoints = static_cast<VTK_TT*>(points->GetVoidPointer(0));
+      for (vtkIdType i=0; i<numPoints; i++)
+        {
+        for (int j=0; j<3; j++)
+          {
+          outPoints[3*i+j] = static_cast<float>(inPoints[3*fromPtIds[i]+j]);
+          }
+        });
+    }
+  ptr += 3 * numPoints * sizeof(float);
+
+  // ... point data ...
+  vtkPointData* pointData = input->GetPointData();
+  for (int i=0; i<pointData->GetNumberOfArrays(); i++)
+    {
+    vtkDataArray* array = pointData->GetArray(i);
+    int tupleSize = array->GetNumberOfComponents() * array->GetDataTypeSize();
+    const char* data = static_cast<const char*>(array->GetVoidPointer(0));
+    for (vtkIdType id=0; id < numPoints; id++)
+      {
+      memcpy(ptr, data + fromPtIds[id] * tupleSize, tupleSize);
+      ptr += tupleSize;
+      }
+    }
+}
+
+// Buffer being received from one process of the schedule.
+struct vtkRedistributePolyDataReceive
+{
+  vtkMPICommunicator::Request Request;
+  vtkSmartPointer<vtkCharArray> Buffer;
+  int Index;
+};
+
+struct vtkRedistributePolyDataPackBatch
+{
+  vtkstd::vector<vtkRedistributePolyDataSendJob>* Jobs;
+};
+
+static VTK_THREAD_RETURN_TYPE vtkRedistributePolyDataPackThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkRedistributePolyDataPackBatch* batch =
+    static_cast<vtkRedistributePolyDataPackBatch*>(info->UserData);
+
+  // Destinations are handed out round-robin.
+  size_t numJobs = batch->Jobs->size();
+  for (size_t cc = info->ThreadID; cc < numJobs; cc += info->NumberOfThreads)
+    {
+    vtkRedistributePolyDataPack((*batch->Jobs)[cc]);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+#endif //VTK_REDIST_USE_MPI_ASYNCHRONOUS
+
 vtkRedistributePolyData::vtkRedistributePolyData()
 {
   this->Controller = NULL;
   this->SetController( vtkMultiProcessController::GetGlobalController() );
 
   this->ColorProc = 0;
+
+  this->UseNonBlockingExchange = 1;
+  this->NumberOfThreads = 0;
+  this->InputImbalance = 1.0;
+  this->OutputImbalance = 1.0;
+  this->ExchangeTime = 0.0;
 }
 
 vtkRedistributePolyData::~vtkRedistributePolyData()
@@ -102,6 +309,7 @@ void vtkRedistributePolyData::Execute()
     }
   myId = this->Controller->GetLocalProcessId();
 
+  this->InputImbalance = this->ComputeImbalance(input->GetNumberOfCells());
 
   // ... make schedule of how many and where to ship polys ...
 
@@ -465,6 +673,20 @@ void vtkRedistributePolyData::Execute()
   int scntr=0;
   int receiving;
 
+  vtkSmartPointer<vtkTimerLog> exchangeTimer =
+    vtkSmartPointer<vtkTimerLog>::New();
+  exchangeTimer->StartTimer();
+  if (this->UseNonBlockingExchange && !this->ColorProc &&
+      this->ExchangeCellsNonBlocking(input, output, &localSched,
+                                     origNumCells, inputNumCells,
+                                     totalNumCellsToSend, numPointsSend,
+                                     cellArraySize, numPointsRec,
+                                     cellptCntr, numPointsOnProc,
+                                     numCellPtsOnProc))
+    {
+    finished = 1;
+    }
+
   while (!finished && (cntRec>0 || cntSend>0))
     {
     if (rcntr<cntRec)
@@ -557,10 +779,14 @@ void vtkRedistributePolyData::Execute()
     
     if (scntr>=cntSend && rcntr>=cntRec) { finished = 1;}
     }
+  exchangeTimer->StopTimer();
+  this->ExchangeTime = exchangeTimer->GetElapsedTime();
 
   input->Delete();
   input = NULL;
 
+  this->OutputImbalance = this->ComputeImbalance(output->GetNumberOfCells());
+
 //eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee
 #if VTK_REDIST_DO_TIMING
   timerInfo8.Timer->StopTimer();
@@ -589,6 +815,293 @@ void vtkRedistributePolyData::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "ColorProc :" << this->ColorProc  << "\n";
+  os << indent << "UseNonBlockingExchange :" 
+     << this->UseNonBlockingExchange << "\n";
+  os << indent << "NumberOfThreads :" << this->NumberOfThreads << "\n";
+  os << indent << "InputImbalance :" << this->InputImbalance << "\n";
+  os << indent << "OutputImbalance :" << this->OutputImbalance << "\n";
+  os << indent << "ExchangeTime :" << this->ExchangeTime << "\n";
+}
+
+//*****************************************************************
+double vtkRedistributePolyData::ComputeImbalance(vtkIdType numCells)
+{
+  vtkIdType maxCells = 0;
+  vtkIdType sumCells = 0;
+  this->Controller->AllReduce(&numCells, &maxCells, 1,
+                              vtkCommunicator::MAX_OP);
+  this->Controller->AllReduce(&numCells, &sumCells, 1,
+                              vtkCommunicator::SUM_OP);
+  if (sumCells == 0)
+    {
+    return 1.0;
+    }
+  double average = static_cast<double>(sumCells) / 
+    this->Controller->GetNumberOfProcesses();
+  return maxCells / average;
+}
+
+//*****************************************************************
+bool vtkRedistributePolyData::ExchangeCellsNonBlocking
+(vtkPolyData* input, vtkPolyData* output, vtkCommSched* sched,
+ vtkIdType* origNumCells, vtkIdType* inputNumCells,
+ vtkIdType* totalNumCellsToSend, vtkIdType* numPointsSend,
+ vtkIdType** cellArraySize, vtkIdType* numPointsRec,
+ vtkIdType** cellptCntr, vtkIdType numPointsOnProc,
+ vtkIdType* numCellPtsOnProc)
+//*****************************************************************
+{
+#ifdef VTK_REDIST_USE_MPI_ASYNCHRONOUS
+  vtkMPIController* controller = 
+    vtkMPIController::SafeDownCast(this->Controller);
+  if (!controller)
+    {
+    return false;
+    }
+
+  int type, i;
+  int cntSend = sched->SendCount;
+  int cntRec = sched->ReceiveCount;
+
+  // ... post all the receives first, the buffers can be sized from what
+  //   SendCellSizes() sent us ...
+  vtkCellData* outputCellData = output->GetCellData();
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkIdType cellTupleSize = vtkRedistributePolyDataTupleSize(outputCellData);
+  vtkIdType pointTupleSize = 
+    vtkRedistributePolyDataTupleSize(outputPointData);
+
+  vtkstd::list<vtkRedistributePolyDataReceive> receives;
+  for (i=0; i<cntRec; i++)
+    {
+    vtkIdType size = 3 * numPointsRec[i] * sizeof(float) + 
+      numPointsRec[i] * pointTupleSize;
+    for (type=0; type<NUM_CELL_TYPES; type++)
+      {
+      size += cellptCntr[i][type] * sizeof(vtkIdType) + 
+        sched->ReceiveNumber[type][i] * cellTupleSize;
+      }
+    vtkRedistributePolyDataReceive request;
+    request.Index = i;
+    request.Buffer = vtkSmartPointer<vtkCharArray>::New();
+    request.Buffer->SetNumberOfValues(size > 0? size : 1);
+    // This static cast will cause big problems if we ever have a buffer
+    // larger than 2 GB.
+    controller->NoBlockReceive(request.Buffer->GetPointer(0),
+                               static_cast<int>(
+                                 request.Buffer->GetNumberOfTuples()),
+                               sched->ReceiveFrom[i], BUFFER_TAG,
+                               request.Request);
+    receives.push_back(request);
+    }
+
+  // ... pack the buffers to send, concurrently ...
+  vtkIdType inputCellTupleSize = 
+    vtkRedistributePolyDataTupleSize(input->GetCellData());
+  vtkIdType inputPointTupleSize = 
+    vtkRedistributePolyDataTupleSize(input->GetPointData());
+  vtkIdType prevStopCellSend[NUM_CELL_TYPES];
+  for (type=0; type<NUM_CELL_TYPES; type++)
+    {
+    prevStopCellSend[type] = origNumCells[type] - 1;
+    if (totalNumCellsToSend[type]+origNumCells[type] > inputNumCells[type])
+      {
+      prevStopCellSend[type] = inputNumCells[type] - 
+        totalNumCellsToSend[type] -1;
+      }
+    }
+
+  vtkstd::vector<vtkRedistributePolyDataSendJob> jobs(cntSend);
+  for (i=0; i<cntSend; i++)
+    {
+    vtkRedistributePolyDataSendJob& job = jobs[i];
+    job.Input = input;
+    job.CellArrays[0] = input->GetVerts();
+    job.CellArrays[1] = input->GetLines();
+    job.CellArrays[2] = input->GetPolys();
+    job.CellArrays[3] = input->GetStrips();
+    job.SendCellList = sched->SendCellList? sched->SendCellList[i] : NULL;
+    job.NumberOfPoints = numPointsSend[i];
+    job.CellArraySize = cellArraySize[i];
+    job.SendTo = sched->SendTo[i];
+
+    vtkIdType size = 3 * job.NumberOfPoints * sizeof(float) + 
+      job.NumberOfPoints * inputPointTupleSize;
+    for (type=0; type<NUM_CELL_TYPES; type++)
+      {
+      if (job.SendCellList)
+        {
+        job.StartCell[type] = 0;
+        job.StopCell[type] = sched->SendNumber[type][i]-1;
+        }
+      else
+        {
+        job.StartCell[type] = prevStopCellSend[type]+1;
+        job.StopCell[type] = job.StartCell[type] + 
+          sched->SendNumber[type][i]-1;
+        prevStopCellSend[type] = job.StopCell[type];
+        }
+      size += job.CellArraySize[type] * sizeof(vtkIdType) + 
+        sched->SendNumber[type][i] * inputCellTupleSize;
+      }
+    job.Buffer = vtkSmartPointer<vtkCharArray>::New();
+    job.Buffer->SetNumberOfValues(size > 0? size : 1);
+    }
+
+  int numThreads = this->NumberOfThreads > 0? this->NumberOfThreads :
+    vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numThreads > cntSend)
+    {
+    numThreads = cntSend;
+    }
+  if (numThreads <= 1)
+    {
+    for (i=0; i<cntSend; i++)
+      {
+      vtkRedistributePolyDataPack(jobs[i]);
+      }
+    }
+  else
+    {
+    vtkRedistributePolyDataPackBatch batch;
+    batch.Jobs = &jobs;
+
+    vtkMultiThreader* threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkRedistributePolyDataPackThread, &batch);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+
+  vtkstd::vector<vtkMPICommunicator::Request> sends(cntSend);
+  for (i=0; i<cntSend; i++)
+    {
+    controller->NoBlockSend(jobs[i].Buffer->GetPointer(0),
+                            static_cast<int>(
+                              jobs[i].Buffer->GetNumberOfTuples()),
+                            jobs[i].SendTo, BUFFER_TAG, sends[i]);
+    }
+
+  // ... unpack the buffers as they arrive. Where the data from each process
+  //   goes in the output only depends on the sizes, as in ReceiveCells() ...
+  vtkCellArray* outputCellArrays[NUM_CELL_TYPES];
+  outputCellArrays[0] = output->GetVerts();
+  outputCellArrays[1] = output->GetLines();
+  outputCellArrays[2] = output->GetPolys();
+  outputCellArrays[3] = output->GetStrips();
+
+  vtkIdType outTypeOffset[NUM_CELL_TYPES];
+  vtkIdType offset = 0;
+  for (type=0; type<NUM_CELL_TYPES; type++)
+    {
+    outTypeOffset[type] = offset;
+    offset += outputCellArrays[type]? 
+      outputCellArrays[type]->GetNumberOfCells() : 0;
+    }
+
+  vtkstd::vector<vtkIdType> firstPoint(cntRec);
+  vtkstd::vector<vtkIdType> firstCellPt(cntRec*NUM_CELL_TYPES);
+  vtkstd::vector<vtkIdType> firstCell(cntRec*NUM_CELL_TYPES);
+  vtkIdType prevNumPoints = numPointsOnProc;
+  for (i=0; i<cntRec; i++)
+    {
+    firstPoint[i] = prevNumPoints;
+    prevNumPoints += numPointsRec[i];
+    }
+  for (type=0; type<NUM_CELL_TYPES; type++)
+    {
+    vtkIdType prevCellPt = numCellPtsOnProc[type];
+    vtkIdType prevCell = origNumCells[type];
+    for (i=0; i<cntRec; i++)
+      {
+      firstCellPt[i*NUM_CELL_TYPES+type] = prevCellPt;
+      firstCell[i*NUM_CELL_TYPES+type] = prevCell;
+      prevCellPt += cellptCntr[i][type];
+      prevCell += sched->ReceiveNumber[type][i];
+      }
+    }
+
+  float* outputPoints = vtkFloatArray::SafeDownCast(
+    output->GetPoints()->GetData())->GetPointer(0);
+  while (!receives.empty())
+    {
+    vtkstd::list<vtkRedistributePolyDataReceive>::iterator iter = receives.begin();
+    while (!iter->Request.Test())
+      {
+      if (++iter == receives.end())
+        {
+        iter = receives.begin();
+        }
+      }
+    i = iter->Index;
+    const char* ptr = iter->Buffer->GetPointer(0);
+
+    for (type=0; type<NUM_CELL_TYPES; type++)
+      {
+      vtkIdType numIds = cellptCntr[i][type];
+      if (!outputCellArrays[type] || numIds == 0)
+        {
+        continue;
+        }
+      vtkIdType* outPtr = outputCellArrays[type]->GetPointer() + 
+        firstCellPt[i*NUM_CELL_TYPES+type];
+      memcpy(outPtr, ptr, numIds * sizeof(vtkIdType));
+      ptr += numIds * sizeof(vtkIdType);
+      for (vtkIdType cellId=0; cellId < sched->ReceiveNumber[type][i]; 
+           cellId++)
+        {
+        vtkIdType npts = *outPtr++;
+        for (vtkIdType k=0; k < npts; k++)
+          {
+          *outPtr++ += firstPoint[i];
+          }
+        }
+      }
+
+    for (int a=0; a<outputCellData->GetNumberOfArrays(); a++)
+      {
+      vtkDataArray* array = outputCellData->GetArray(a);
+      int tupleSize = array->GetNumberOfComponents()*array->GetDataTypeSize();
+      char* data = static_cast<char*>(array->GetVoidPointer(0));
+      for (type=0; type<NUM_CELL_TYPES; type++)
+        {
+        vtkIdType numBytes = sched->ReceiveNumber[type][i] * tupleSize;
+        memcpy(data + (outTypeOffset[type] + 
+                       firstCell[i*NUM_CELL_TYPES+type]) * tupleSize,
+               ptr, numBytes);
+        ptr += numBytes;
+        }
+      }
+
+    memcpy(outputPoints + 3*firstPoint[i], ptr, 
+           3 * numPointsRec[i] * sizeof(float));
+    ptr += 3 * numPointsRec[i] * sizeof(float);
+
+    for (int a=0; a<outputPointData->GetNumberOfArrays(); a++)
+      {
+      vtkDataArray* array = outputPointData->GetArray(a);
+      int tupleSize = array->GetNumberOfComponents()*array->GetDataTypeSize();
+      char* data = static_cast<char*>(array->GetVoidPointer(0));
+      memcpy(data + firstPoint[i] * tupleSize, ptr, 
+             numPointsRec[i] * tupleSize);
+      ptr += numPointsRec[i] * tupleSize;
+      }
+
+    receives.erase(iter);
+    }
+
+  for (i=0; i<cntSend; i++)
+    {
+    sends[i].Wait();
+    }
+  return true;
+#else
+  (void)input; (void)output; (void)sched; (void)origNumCells;
+  (void)inputNumCells; (void)totalNumCellsToSend; (void)numPointsSend;
+  (void)cellArraySize; (void)numPointsRec; (void)cellptCntr;
+  (void)numPointsOnProc; (void)numCellPtsOnProc;
+  return false;
+#endif
 }
 
 
@@ -19,6 +19,13 @@
 
 // .NAME vtkRedistributePolyData - redistribute poly cells from other processes
 //                        (special version to color according to processor)
+// .SECTION Description
+// Subclasses decide which cells go where (MakeSchedule()). When running with
+// MPI, all the cells, points and attributes going to one process are packed
+// in a single buffer (buffers for different processes are packed
+// concurrently) and exchanged with non-blocking communication, see
+// UseNonBlockingExchange. The load imbalance of the input and of the output
+// is measured on every execution.
 
 #ifndef __vtkRedistributePolyData_h
 #define __vtkRedistributePolyData_h
@@ -56,6 +63,34 @@ public:
   virtual int  GetPassThrough() { return 0; };
   vtkBooleanMacro(PassThrough, int);
 
+  // Description:
+  // When on (the default) and the controller is a vtkMPIController, the data
+  // sent to each process is packed into one buffer, using up to
+  // NumberOfThreads threads, and all the buffers are exchanged at once with
+  // non-blocking communication. Otherwise, or when ColorProc is set, each
+  // array is sent separately with blocking communication.
+  vtkSetMacro(UseNonBlockingExchange, int);
+  vtkGetMacro(UseNonBlockingExchange, int);
+  vtkBooleanMacro(UseNonBlockingExchange, int);
+
+  // Description:
+  // Maximum number of threads used to pack the buffers. 0 means as many as
+  // vtkMultiThreader allows. Default is 0.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Load imbalance of the last execution, before and after redistribution:
+  // the largest number of cells on a process divided by the average number
+  // of cells per process. 1 means perfectly balanced.
+  vtkGetMacro(InputImbalance, double);
+  vtkGetMacro(OutputImbalance, double);
+
+  // Description:
+  // Time, in seconds, this process spent exchanging cells during the last
+  // execution.
+  vtkGetMacro(ExchangeTime, double);
+
 protected:
   vtkRedistributePolyData();
   ~vtkRedistributePolyData();
@@ -78,7 +113,8 @@ protected:
     CELL_CNT_TAG       = 150,
     CELL_TAG           = 160,
     POINTS_SIZE_TAG    = 170,
-    POINTS_TAG         = 180
+    POINTS_TAG         = 180,
+    BUFFER_TAG         = 190
   };
 
   class VTK_EXPORT vtkCommSched
@@ -157,6 +193,27 @@ protected:
   void ReceiveArrays (vtkDataArray*, vtkIdType, int, 
                       vtkIdType*, int); 
 
+  // Description:
+  // Exchanges the cells with all the processes of the schedule at once,
+  // using non-blocking communication. Does the same as the SendCells() and
+  // ReceiveCells() calls of Execute(). Returns false if that is not possible
+  // with the current controller.
+  bool ExchangeCellsNonBlocking(vtkPolyData* input, vtkPolyData* output,
+                                vtkCommSched* sched,
+                                vtkIdType* origNumCells,
+                                vtkIdType* inputNumCells,
+                                vtkIdType* totalNumCellsToSend,
+                                vtkIdType* numPointsSend,
+                                vtkIdType** cellArraySize,
+                                vtkIdType* numPointsRec,
+                                vtkIdType** cellptCntr,
+                                vtkIdType numPointsOnProc,
+                                vtkIdType* numCellPtsOnProc);
+
+  // Description:
+  // Returns the largest number of cells on a process divided by the average.
+  double ComputeImbalance(vtkIdType numCells);
+
   void Execute();
 
   // Do this as a proprocessing step.
@@ -169,6 +226,12 @@ protected:
 
   int ColorProc; // Set to 1 to color data according to processor
 
+  int UseNonBlockingExchange;
+  int NumberOfThreads;
+  double InputImbalance;
+  double OutputImbalance;
+  double ExchangeTime;
+
 private:
   vtkRedistributePolyData(const vtkRedistributePolyData&); // Not implemented
   void operator=(const vtkRedistributePolyData&); // Not implemented
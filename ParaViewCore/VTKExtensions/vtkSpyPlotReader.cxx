@@ -92,6 +92,7 @@ vtkSpyPlotReader::vtkSpyPlotReader()
   this->TimeStepRange[0] = 0;
   this->TimeStepRange[1] = 0;
   this->DownConvertVolumeFraction = 1;
+  this->NumberOfDecodeThreads = 1;
   this->MergeXYZComponents = 1;
 
   // this has all of the processes.
@@ -1423,6 +1424,25 @@ void vtkSpyPlotReader::SetDownConvertVolumeFraction(int vf)
   this->Modified();
 }
 
+//-----------------------------------------------------------------------------
+void vtkSpyPlotReader::SetNumberOfDecodeThreads(int num)
+{
+  num = (num < 1)? 1 : num;
+  if ( num == this->NumberOfDecodeThreads )
+    {
+    return;
+    }
+  vtkSpyPlotReaderMap::MapOfStringToSPCTH::iterator mapIt;
+  for ( mapIt = this->Map->Files.begin();
+        mapIt != this->Map->Files.end();
+        ++ mapIt )
+    {
+    this->Map->GetReader(mapIt, this)->SetNumberOfDecodeThreads(num);
+    }
+  this->NumberOfDecodeThreads = num;
+  this->Modified();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSpyPlotReader::SetMergeXYZComponents(int merge)
 {
@@ -1489,6 +1509,8 @@ void vtkSpyPlotReader::PrintSelf(ostream& os, vtkIndent indent)
     os << "false"<<endl;
     }
   
+  os << "NumberOfDecodeThreads: " << this->NumberOfDecodeThreads << endl;
+
   os << "DownConvertVolumeFraction: ";
   if(this->DownConvertVolumeFraction)
     {
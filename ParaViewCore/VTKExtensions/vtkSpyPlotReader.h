@@ -135,6 +135,13 @@ public:
   vtkGetMacro(DownConvertVolumeFraction,int);
   vtkBooleanMacro(DownConvertVolumeFraction,int);
 
+  // Description:
+  // Number of threads each file reader uses to decode the run-length encoded
+  // cell fields. The vtkMultiThreader global maximum still applies.
+  // 1 by default.
+  void SetNumberOfDecodeThreads(int num);
+  vtkGetMacro(NumberOfDecodeThreads,int);
+
   // Description:
   // If true, the reader will merge scalar arrays named, for example, "X velocity"
   // "Y velocity" and "Z velocity" into a vector array named "velocity" with
@@ -351,6 +358,7 @@ protected:
   int GenerateTracerArray; // user flag
 
   int DownConvertVolumeFraction;
+  int NumberOfDecodeThreads;
   
   bool TimeRequestedFromPipeline;
 
@@ -34,6 +34,7 @@ vtkSpyPlotReaderMap::GetReader(MapOfStringToSPCTH::iterator& it,
     it->second = vtkSpyPlotUniReader::New();
     it->second->SetCellArraySelection(parent->GetCellDataArraySelection());
     it->second->SetFileName(it->first.c_str());
+    it->second->SetNumberOfDecodeThreads(parent->GetNumberOfDecodeThreads());
     //cout << parent->GetController()->GetLocalProcessId() 
     // << "Create reader: " << it->second << endl;
     }
@@ -8,6 +8,9 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkByteSwap.h"
+#include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+#include <vtkstd/algorithm>
 #include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 //=============================================================================
@@ -77,6 +80,7 @@ vtkSpyPlotUniReader::vtkSpyPlotUniReader()
   this->DataTypeChanged = 0;
   this->GeomTimeStep = -1; // Indicate that geometry will have to be loaded
   this->NeedToCheck = 1; // Indicates non-geometric data needs to be checked
+  this->NumberOfDecodeThreads = 1;
   if ( !this->HaveInformation ) { vtkDebugMacro( << __LINE__ << " " << this << " Read: " << this->HaveInformation ); }
 }
 
@@ -591,6 +595,114 @@ int vtkSpyPlotUniReader::ReadInformation()
 }
 
 
+//-----------------------------------------------------------------------------
+// One compressed z-plane of a cell field waiting to be decoded. Exactly one of
+// the output pointers is set.
+struct vtkSpyPlotUniReaderDecodeJob
+{
+  size_t Offset;
+  int NumberOfBytes;
+  float* FloatOut;
+  unsigned char* UnsignedCharOut;
+  int PlaneSize;
+};
+
+struct vtkSpyPlotUniReaderDecodeBatch
+{
+  vtkSpyPlotUniReader* Self;
+  const unsigned char* Buffer;
+  const vtkstd::vector<vtkSpyPlotUniReaderDecodeJob>* Jobs;
+  vtkstd::vector<int> Status;
+};
+
+template<class t>
+int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
+                                           const unsigned char* in, 
+                                           int inSize, t* out, 
+                                           int outSize, t scale=1);
+
+//-----------------------------------------------------------------------------
+static int vtkSpyPlotUniReaderDecodeJobRun(vtkSpyPlotUniReader* self,
+  const unsigned char* buffer, const vtkSpyPlotUniReaderDecodeJob& job)
+{
+  if ( job.FloatOut )
+    {
+    return ::vtkSpyPlotUniReaderRunLengthDataDecode(self, buffer + job.Offset,
+      job.NumberOfBytes, job.FloatOut, job.PlaneSize);
+    }
+  return ::vtkSpyPlotUniReaderRunLengthDataDecode(self, buffer + job.Offset,
+    job.NumberOfBytes, job.UnsignedCharOut, job.PlaneSize,
+    static_cast<unsigned char>(255));
+}
+
+//-----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkSpyPlotUniReaderDecodeThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkSpyPlotUniReaderDecodeBatch* batch =
+    static_cast<vtkSpyPlotUniReaderDecodeBatch*>(info->UserData);
+
+  // Planes are handed out round-robin; they are all roughly the same size.
+  size_t numJobs = batch->Jobs->size();
+  for (size_t cc = info->ThreadID; cc < numJobs; cc += info->NumberOfThreads)
+    {
+    if ( !::vtkSpyPlotUniReaderDecodeJobRun(batch->Self, batch->Buffer,
+                                            (*batch->Jobs)[cc]) )
+      {
+      batch->Status[info->ThreadID] = 0;
+      break;
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+// Decodes all the planes read for one field, using up to numThreads threads
+// (the vtkMultiThreader global maximum still applies).
+static int vtkSpyPlotUniReaderDecodeJobs(vtkSpyPlotUniReader* self,
+  int numThreads, const vtkstd::vector<vtkSpyPlotUniReaderDecodeJob>& jobs,
+  const vtkstd::vector<unsigned char>& buffer)
+{
+  if ( jobs.empty() )
+    {
+    return 1;
+    }
+  const unsigned char* data = buffer.empty()? 0 : &buffer[0];
+
+  if ( numThreads > static_cast<int>(jobs.size()) )
+    {
+    numThreads = static_cast<int>(jobs.size());
+    }
+  if ( numThreads <= 1 )
+    {
+    vtkstd::vector<vtkSpyPlotUniReaderDecodeJob>::const_iterator it;
+    for ( it = jobs.begin(); it != jobs.end(); ++ it )
+      {
+      if ( !::vtkSpyPlotUniReaderDecodeJobRun(self, data, *it) )
+        {
+        return 0;
+        }
+      }
+    return 1;
+    }
+
+  vtkSpyPlotUniReaderDecodeBatch batch;
+  batch.Self = self;
+  batch.Buffer = data;
+  batch.Jobs = &jobs;
+  batch.Status.resize(numThreads, 1);
+
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkSpyPlotUniReaderDecodeThread, &batch);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  return vtkstd::find(batch.Status.begin(), batch.Status.end(), 0) ==
+    batch.Status.end()? 1 : 0;
+}
+
 //-----------------------------------------------------------------------------
 int vtkSpyPlotUniReader::MakeCurrent()
 {
@@ -795,6 +907,15 @@ int vtkSpyPlotUniReader::MakeCurrent()
     int numBytes;
     int block;
     int actualBlockId = 0;
+    // With a single thread each plane is decoded as soon as it is read, so
+    // that only one compressed plane is held in memory.
+    bool decodeInline = this->NumberOfDecodeThreads <= 1;
+    vtkstd::vector<vtkSpyPlotUniReaderDecodeJob> jobs;
+    arrayBuffer.clear();
+    // The arrays read are only handed to the variable once all of them
+    // decoded successfully.
+    vtkstd::vector<vtkSmartPointer<vtkDataArray> > newArrays;
+    vtkstd::vector<int> newArrayIds;
     for ( block = 0; block < dp->NumberOfBlocks; ++ block )
       {
       vtkSpyPlotBlock* bk = this->Blocks+block;
@@ -835,51 +956,74 @@ int vtkSpyPlotUniReader::MakeCurrent()
             vtkErrorMacro( "Problem reading the number of bytes" );
             return 0;
             }
-          if ( static_cast<int>(arrayBuffer.size()) < numBytes )
+          if ( !dataArray )
             {
-            arrayBuffer.resize(numBytes);
+            // Nothing to decode, simply skip over the plane.
+            spis.Seek(numBytes, true);
+            continue;
             }
-          if ( !spis.ReadString(&*arrayBuffer.begin(), numBytes) )
+          // Reading has to be sequential. When several threads are used,
+          // decoding is deferred until all the planes of this field are in
+          // memory so that the planes can be decoded concurrently.
+          vtkSpyPlotUniReaderDecodeJob job;
+          job.Offset = decodeInline? 0 : arrayBuffer.size();
+          job.NumberOfBytes = numBytes;
+          job.FloatOut = floatArray? floatArray->GetPointer(zax * planeSize) : 0;
+          job.UnsignedCharOut = unsignedCharArray?
+            unsignedCharArray->GetPointer(zax * planeSize) : 0;
+          job.PlaneSize = planeSize;
+          if ( job.Offset + numBytes > arrayBuffer.size() )
+            {
+            arrayBuffer.resize(job.Offset + numBytes);
+            }
+          if ( numBytes > 0 &&
+               !spis.ReadString(&arrayBuffer[job.Offset], numBytes) )
             {
             vtkErrorMacro( "Problem reading the bytes" );
             return 0;
             }
-          if ( floatArray )
+          if ( !decodeInline )
             {
-            float* ptr = floatArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), 
-                                            numBytes, ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding float data array" );
-              return 0;
-              }
+            jobs.push_back(job);
             }
-          if ( unsignedCharArray )
+          else if ( !::vtkSpyPlotUniReaderDecodeJobRun(this,
+                      arrayBuffer.empty()? 0 : &arrayBuffer[0], job) )
             {
-            unsigned char* ptr = unsignedCharArray->GetPointer(zax * planeSize);
-            if ( !this->RunLengthDataDecode(&*arrayBuffer.begin(), numBytes,
-                                            ptr, planeSize) )
-              {
-              vtkErrorMacro( "Problem RLD decoding unsigned char data array" );
-              return 0;
-              }
+            vtkErrorMacro( "Problem RLD decoding data array: " << var->Name );
+            return 0;
             }
           }
         if ( dataArray )
           {
-          var->DataBlocks[actualBlockId] = dataArray;
-          var->GhostCellsFixed[actualBlockId] = 0;
-          vtkDebugMacro( " " << dataArray << " initialized: " 
-                         << dataArray->GetName() );
+          newArrays.push_back(dataArray);
+          newArrayIds.push_back(actualBlockId);
+          dataArray->Delete();
           actualBlockId++;
           }
         }
       }
+
+    if ( !::vtkSpyPlotUniReaderDecodeJobs(this, this->NumberOfDecodeThreads,
+                                          jobs, arrayBuffer) )
+      {
+      vtkErrorMacro( "Problem RLD decoding data array: " << var->Name );
+      return 0;
+      }
+    for ( size_t cc = 0; cc < newArrays.size(); ++ cc )
+      {
+      vtkDataArray* dataArray = newArrays[cc];
+      dataArray->Register(0);
+      var->DataBlocks[newArrayIds[cc]] = dataArray;
+      var->GhostCellsFixed[newArrayIds[cc]] = 0;
+      vtkDebugMacro( " " << dataArray << " initialized: " 
+                     << dataArray->GetName() );
+      }
     }
   this->DataTypeChanged = 0;
   return 1;
 }
 
+
 #if 0
 //-----------------------------------------------------------------------------
 void vtkSpyPlotUniReader::PrintMemoryUsage()
@@ -1078,67 +1222,75 @@ void vtkSpyPlotUniReader::PrintInformation()
    to provide allocated space for *data which will be
    n bytes long. */
 
+//-----------------------------------------------------------------------------
+// Copies a literal (non repeated) run of big-endian floats to the output.
+template<class t>
+inline void vtkSpyPlotUniReaderCopyLiteralRun(const unsigned char* in,
+                                              int count, t* out, t scale)
+{
+  for (int k = 0; k < count; ++k, in += 4)
+    {
+    float val;
+    memcpy(&val, in, sizeof(float));
+    vtkByteSwap::SwapBE(&val);
+    out[k] = static_cast<t>(val*scale);
+    }
+}
+
+// Float output needs no conversion: copy the whole run at once and swap it
+// in place.
+inline void vtkSpyPlotUniReaderCopyLiteralRun(const unsigned char* in,
+                                              int count, float* out, float)
+{
+  memcpy(out, in, count*sizeof(float));
+  vtkByteSwap::SwapBERange(out, count);
+}
 
 //-----------------------------------------------------------------------------
 template<class t>
 int vtkSpyPlotUniReaderRunLengthDataDecode(vtkSpyPlotUniReader* self, 
                                            const unsigned char* in, 
                                            int inSize, t* out, 
-                                           int outSize, t scale=1)
+                                           int outSize, t scale)
 {
   int outIndex = 0, inIndex = 0;
 
-  const unsigned char* ptmp = in;
-
   /* Run-length decode */
   while ((outIndex<outSize) && (inIndex<inSize))
     {
     // Okay get the run length
-    unsigned char runLength = *ptmp;
-    ptmp ++;
+    int runLength = in[inIndex];
+    int count = (runLength < 128)? runLength : runLength - 128;
+    int runBytes = (runLength < 128)? 5 : 4*count + 1;
+    if ( inIndex + runBytes > inSize )
+      {
+      vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                              << "Truncated input run at byte " << inIndex);
+      return 0;
+      }
+    if ( outIndex + count > outSize )
+      {
+      vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
+                              << "Too much data generated. Excpected: " 
+                              << outSize );
+      return 0;
+      }
     if (runLength < 128)
       {
+      // A repeated value: convert it once and fill the whole run.
       float val;
-      memcpy(&val, ptmp, sizeof(float));
+      memcpy(&val, in + inIndex + 1, sizeof(float));
       vtkByteSwap::SwapBE(&val);
-      ptmp += 4;
-      // Now populate the out data
-      int k;
-      for (k=0; k<runLength; ++k)
-        {
-        if ( outIndex >= outSize )
-          {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
-          return 0;
-          }
-        out[outIndex] = static_cast<t>(val*scale);
-        outIndex++;
-        }
-      inIndex += 5;
+      vtkstd::fill(out + outIndex, out + outIndex + count,
+                   static_cast<t>(val*scale));
       }
     else  // runLength >= 128
       {
-      int k;
-      for (k=0; k<runLength-128; ++k)
-        {
-        if ( outIndex >= outSize )
-          {
-          vtkErrorWithObjectMacro(self, "Problem doing RLD decode. "
-                                  << "Too much data generated. Excpected: " 
-                                  << outSize );
-          return 0;
-          }
-        float val;
-        memcpy(&val, ptmp, sizeof(float));
-        vtkByteSwap::SwapBE(&val);
-        out[outIndex]=static_cast<t>(val*scale);
-        outIndex++;
-        ptmp += 4;
-        }
-      inIndex += 4*(runLength-128)+1;
+      ::vtkSpyPlotUniReaderCopyLiteralRun(in + inIndex + 1, count,
+                                          out + outIndex, scale);
       }
+    outIndex += count;
+    inIndex += runBytes;
     } // while
 
   return 1;
@@ -1665,6 +1817,8 @@ void vtkSpyPlotUniReader::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "DataTypeChanged: " << this->DataTypeChanged << endl;
   os << indent << "NumberOfCellFields: " << this->NumberOfCellFields << endl;
   os << indent << "NeedToCheck: " << this->NeedToCheck << endl;
+  os << indent << "NumberOfDecodeThreads: " << this->NumberOfDecodeThreads
+     << endl;
 }
 
 
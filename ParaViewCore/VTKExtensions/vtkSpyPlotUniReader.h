@@ -160,6 +160,15 @@ public:
   vtkSetMacro(DataTypeChanged, int);
   void SetDownConvertVolumeFraction(int vf);
 
+  // Description:
+  // Number of threads used to run-length decode the cell fields read by
+  // MakeCurrent(). The file is still read sequentially; the planes of each
+  // field are then decoded concurrently. This is bounded by
+  // vtkMultiThreader's global maximum number of threads. Default is 1, in
+  // which case each plane is decoded as soon as it is read.
+  vtkSetClampMacro(NumberOfDecodeThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfDecodeThreads, int);
+
 protected:
   vtkSpyPlotUniReader();
   ~vtkSpyPlotUniReader();
@@ -230,6 +239,7 @@ private:
 
   int DataTypeChanged;
   int DownConvertVolumeFraction;
+  int NumberOfDecodeThreads;
 
   int NumberOfCellFields;
   
@@ -65,6 +65,15 @@ public:
     return false;
     }
 
+  // Description:
+  // Returns an estimate of the memory used by this element, in bytes. It is
+  // used by vtkUndoStack to enforce its MaximumMemorySize. Subclasses
+  // keeping significant data should override it.
+  virtual unsigned long GetMemorySize()
+    {
+    return sizeof(*this);
+    }
+
   // Set the working context if run inside a UndoSet context, so object
   // that are cross referenced can leave long enought to be associated
   // to another object. Otherwise the undo of a Delete will create the object
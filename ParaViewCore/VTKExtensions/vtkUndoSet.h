@@ -75,6 +75,11 @@ public:
   // Get number of elements in the set.
   int GetNumberOfElements();
 
+  // Description:
+  // Returns an estimate of the memory used by the elements of this set, in
+  // bytes (see vtkUndoElement::GetMemorySize()).
+  unsigned long GetMemorySize();
+
 protected:
   vtkUndoSet();
   ~vtkUndoSet();
@@ -27,6 +27,7 @@ vtkUndoStack::vtkUndoStack()
   this->InUndo = false;
   this->InRedo = false;
   this->StackDepth = 10;
+  this->MaximumMemorySize = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -55,9 +56,26 @@ void vtkUndoStack::Push(const char* label, vtkUndoSet* changeSet)
     }
   this->Internal->UndoStack.push_back(
     vtkUndoStackInternal::Element(label, changeSet));
+
+  if (this->MaximumMemorySize > 0)
+    {
+    unsigned long size = this->Internal->GetMemorySize();
+    while (size > this->MaximumMemorySize*1024 &&
+      this->Internal->UndoStack.size() > 1)
+      {
+      size -= this->Internal->UndoStack.front().MemorySize;
+      this->Internal->UndoStack.erase(this->Internal->UndoStack.begin());
+      }
+    }
   this->Modified();
 }
 
+//-----------------------------------------------------------------------------
+unsigned long vtkUndoStack::GetMemorySize()
+{
+  return (this->Internal->GetMemorySize() + 1023) / 1024;
+}
+
 //-----------------------------------------------------------------------------
 unsigned int vtkUndoStack::GetNumberOfUndoSets()
 {
@@ -183,4 +201,5 @@ void vtkUndoStack::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "InUndo: " << this->InUndo << endl;
   os << indent << "InRedo: " << this->InRedo << endl;
   os << indent << "StackDepth: " << this->StackDepth << endl;
+  os << indent << "MaximumMemorySize: " << this->MaximumMemorySize << endl;
 }
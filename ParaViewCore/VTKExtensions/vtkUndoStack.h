@@ -146,12 +146,26 @@ public:
   // Default is 10.
   vtkSetClampMacro(StackDepth, int, 1, 100);
   vtkGetMacro(StackDepth, int);
+
+  // Description:
+  // Get/Set the memory budget of the stack, in kibibytes. When the sets on
+  // the stack use more memory than this (see vtkUndoSet::GetMemorySize()),
+  // the oldest sets are removed, the most recent one being always kept.
+  // 0 means no limit. Default is 0.
+  vtkSetMacro(MaximumMemorySize, unsigned long);
+  vtkGetMacro(MaximumMemorySize, unsigned long);
+
+  // Description:
+  // Returns an estimate of the memory currently used by the undo and redo
+  // sets, in kibibytes.
+  unsigned long GetMemorySize();
 protected:
   vtkUndoStack();
   ~vtkUndoStack();
 
   vtkUndoStackInternal* Internal;
   int StackDepth;
+  unsigned long MaximumMemorySize;
 
 private:
   vtkUndoStack(const vtkUndoStack&); // Not implemented.
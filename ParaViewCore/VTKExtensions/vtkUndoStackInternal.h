@@ -25,6 +25,7 @@ public:
     {
     vtkstd::string Label;
     vtkSmartPointer<vtkUndoSet> UndoSet;
+    unsigned long MemorySize;
     Element(const char* label, vtkUndoSet* set)
       {
       this->Label = label;
@@ -33,11 +34,28 @@ public:
         {
         this->UndoSet->AddElement(set->GetElement(i));
         }
+      this->MemorySize = this->UndoSet->GetMemorySize();
       }
     };
   typedef vtkstd::vector<Element> VectorOfElements;
   VectorOfElements UndoStack;
   VectorOfElements RedoStack;
+
+  // Returns the memory used by the sets of both stacks.
+  unsigned long GetMemorySize()
+    {
+    unsigned long size = 0;
+    VectorOfElements::iterator iter;
+    for (iter = this->UndoStack.begin(); iter != this->UndoStack.end(); ++iter)
+      {
+      size += iter->MemorySize;
+      }
+    for (iter = this->RedoStack.begin(); iter != this->RedoStack.end(); ++iter)
+      {
+      size += iter->MemorySize;
+      }
+    return size;
+    }
 };
 //****************************************************************************
 
@@ -16,6 +16,7 @@
 
 #include "vtkCallbackCommand.h"
 #include "vtkCharArray.h"
+#include "vtkDataArraySelection.h"
 #include "vtkDataSet.h"
 #include "vtkFieldData.h"
 #include "vtkInstantiator.h"
@@ -34,6 +35,86 @@
 
 vtkStandardNewMacro(vtkXMLCollectionReader);
 
+namespace
+{
+  // Directory of the collection file, used to resolve relative paths.
+  vtkstd::string vtkXMLCollectionReaderGetFilePath(const char* fileName)
+    {
+    vtkstd::string filePath = fileName;
+    vtkstd::string::size_type pos = filePath.find_last_of("/\\");
+    if(pos != filePath.npos)
+      {
+      return filePath.substr(0, pos);
+      }
+    return vtkstd::string();
+    }
+
+  // Add the arrays listed in "from" that "names" does not have yet.
+  void vtkXMLCollectionReaderCollectNames(vtkDataArraySelection* from,
+                                          vtkstd::vector<vtkstd::string>& names)
+    {
+    for(int i=0; i < from->GetNumberOfArrays(); ++i)
+      {
+      vtkstd::string name = from->GetArrayName(i);
+      if(vtkstd::find(names.begin(), names.end(), name) == names.end())
+        {
+        names.push_back(name);
+        }
+      }
+    }
+
+  // Make "sel" list exactly "names", keeping the settings of arrays it
+  // already had.  Nothing is touched when the list did not change so
+  // that the reader is not modified needlessly.
+  void vtkXMLCollectionReaderSetNames(vtkDataArraySelection* sel,
+                                      const vtkstd::vector<vtkstd::string>& names)
+    {
+    bool same = sel->GetNumberOfArrays() == static_cast<int>(names.size());
+    for(size_t i=0; same && i < names.size(); ++i)
+      {
+      same = names[i] == sel->GetArrayName(static_cast<int>(i));
+      }
+    if(same)
+      {
+      return;
+      }
+    vtkstd::vector<const char*> cnames(names.size());
+    for(size_t i=0; i < names.size(); ++i)
+      {
+      cnames[i] = names[i].c_str();
+      }
+    sel->SetArrays(cnames.empty()? 0 : &cnames[0],
+                   static_cast<int>(cnames.size()));
+    }
+
+  // Copy the enabled state of the arrays known to "from" onto "to".
+  // Arrays "from" does not know about keep their setting.
+  void vtkXMLCollectionReaderPushSelection(vtkDataArraySelection* from,
+                                           vtkDataArraySelection* to)
+    {
+    for(int i=0; i < to->GetNumberOfArrays(); ++i)
+      {
+      const char* name = to->GetArrayName(i);
+      if(!from->ArrayExists(name))
+        {
+        continue;
+        }
+      int enabled = from->ArrayIsEnabled(name);
+      if(enabled != to->ArrayIsEnabled(name))
+        {
+        if(enabled)
+          {
+          to->EnableArray(name);
+          }
+        else
+          {
+          to->DisableArray(name);
+          }
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 
 struct vtkXMLCollectionReaderEntry
@@ -56,15 +137,35 @@ typedef vtkstd::vector<vtkstd::vector<vtkXMLCollectionReaderString> >
         vtkXMLCollectionReaderAttributeValueSets;
 typedef vtkstd::map<vtkXMLCollectionReaderString, vtkXMLCollectionReaderString>
         vtkXMLCollectionReaderRestrictions;
+
+// An internal reader kept alive across updates together with the
+// number of the read pass that last used it.
+struct vtkXMLCollectionReaderCacheEntry
+{
+  vtkSmartPointer<vtkXMLReader> Reader;
+  int Pass;
+};
+typedef vtkstd::map<vtkstd::string, vtkXMLCollectionReaderCacheEntry>
+        vtkXMLCollectionReaderCache;
+
 class vtkXMLCollectionReaderInternals
 {
 public:
+  vtkXMLCollectionReaderInternals(): Pass(0) {}
+
   vtkstd::vector<vtkXMLDataElement*> DataSets;
   vtkstd::vector<vtkXMLDataElement*> RestrictedDataSets;
   vtkXMLCollectionReaderAttributeNames AttributeNames;
   vtkXMLCollectionReaderAttributeValueSets AttributeValueSets;
   vtkXMLCollectionReaderRestrictions Restrictions;
   vtkstd::vector< vtkSmartPointer<vtkXMLReader> > Readers;
+
+  // Internal readers by file name.  A reader that has already parsed the
+  // header of its file is reused as long as it was used by the current
+  // or the previous read pass; older ones are dropped.
+  vtkXMLCollectionReaderCache ReaderCache;
+  int Pass;
+
   static const vtkXMLCollectionReaderEntry ReaderList[];
 };
 
@@ -81,7 +182,8 @@ vtkXMLCollectionReader::vtkXMLCollectionReader()
 
   this->InternalForceMultiBlock = false;
   this->ForceOutputTypeToMultiBlock = 0;
-  
+  this->DistributeFiles = 0;
+
   this->CurrentOutput = -1;
 }
 
@@ -96,6 +198,9 @@ vtkXMLCollectionReader::~vtkXMLCollectionReader()
 void vtkXMLCollectionReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ForceOutputTypeToMultiBlock: "
+     << this->ForceOutputTypeToMultiBlock << "\n";
+  os << indent << "DistributeFiles: " << this->DistributeFiles << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -295,45 +400,17 @@ vtkDataObject* vtkXMLCollectionReader::SetupOutput(const char* filePath,
       }
     }
 
-  // If a reader was found, allocate an instance of it for this output.
-  if(rname)
-    {
-    if(!(this->Internal->Readers[index].GetPointer() &&
-         strcmp(this->Internal->Readers[index]->GetClassName(), rname) == 0))
-      {
-      // Use the instantiator to create the reader.
-      vtkObject* o = vtkInstantiator::CreateInstance(rname);
-      vtkXMLReader* reader = vtkXMLReader::SafeDownCast(o);
-      this->Internal->Readers[index] = reader;
-      if(reader)
-        {
-        reader->Delete();
-        }
-      else
-        {
-        // The class was not registered with the instantiator.
-        vtkErrorMacro("Error creating \"" << rname
-                      << "\" using vtkInstantiator.");
-        if(o)
-          {
-          o->Delete();
-          }
-        }
-      }
-    }
-  else
-    {
-    this->Internal->Readers[index] = 0;
-    }
+  // If a reader was found, get an instance of it for this output.
+  this->Internal->Readers[index] =
+    rname? this->GetCachedReader(fileName.c_str(), rname) : 0;
 
   // If we have a reader for this output, connect its output to our
   // output by sharing the data with a ShallowCopy.
   if(this->Internal->Readers[index].GetPointer())
     {
-    // Assign the file name to the internal reader.
-    this->Internal->Readers[index]->SetFileName(fileName.c_str());
-
-    // Update the information on the internal reader's output.
+    // Update the information on the internal reader's output.  This is
+    // a no-op when the reader came from the cache with its header
+    // already parsed.
     this->Internal->Readers[index]->UpdateInformation();
 
     // Allocate an instance of the same output type for our output.
@@ -345,6 +422,71 @@ vtkDataObject* vtkXMLCollectionReader::SetupOutput(const char* filePath,
   return 0;
 }
 
+//----------------------------------------------------------------------------
+vtkXMLReader* vtkXMLCollectionReader::GetCachedReader(const char* fileName,
+                                                      const char* className)
+{
+  vtkXMLCollectionReaderCache::iterator i =
+    this->Internal->ReaderCache.find(fileName);
+  if(i != this->Internal->ReaderCache.end() &&
+     strcmp(i->second.Reader->GetClassName(), className) == 0)
+    {
+    i->second.Pass = this->Internal->Pass;
+    return i->second.Reader.GetPointer();
+    }
+
+  // Use the instantiator to create the reader.
+  vtkObject* o = vtkInstantiator::CreateInstance(className);
+  vtkXMLReader* reader = vtkXMLReader::SafeDownCast(o);
+  if(!reader)
+    {
+    // The class was not registered with the instantiator.
+    vtkErrorMacro("Error creating \"" << className
+                  << "\" using vtkInstantiator.");
+    if(o)
+      {
+      o->Delete();
+      }
+    return 0;
+    }
+  reader->SetFileName(fileName);
+
+  vtkXMLCollectionReaderCacheEntry& entry =
+    this->Internal->ReaderCache[fileName];
+  entry.Reader = reader;
+  entry.Pass = this->Internal->Pass;
+  reader->Delete();
+  return reader;
+}
+
+//----------------------------------------------------------------------------
+void vtkXMLCollectionReader::UpdateArraySelections()
+{
+  vtkstd::vector<vtkstd::string> pointNames;
+  vtkstd::vector<vtkstd::string> cellNames;
+  bool haveReader = false;
+  vtkstd::vector< vtkSmartPointer<vtkXMLReader> >::iterator r;
+  for(r = this->Internal->Readers.begin();
+      r != this->Internal->Readers.end(); ++r)
+    {
+    if(r->GetPointer())
+      {
+      haveReader = true;
+      vtkXMLCollectionReaderCollectNames(
+        (*r)->GetPointDataArraySelection(), pointNames);
+      vtkXMLCollectionReaderCollectNames(
+        (*r)->GetCellDataArraySelection(), cellNames);
+      }
+    }
+  // Keep the current lists when no internal reader could tell us
+  // anything, e.g. because none of the files could be opened.
+  if(haveReader)
+    {
+    vtkXMLCollectionReaderSetNames(this->PointDataArraySelection, pointNames);
+    vtkXMLCollectionReaderSetNames(this->CellDataArraySelection, cellNames);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkXMLCollectionReader::BuildRestrictedDataSets()
 {
@@ -392,20 +534,12 @@ int vtkXMLCollectionReader::RequestDataObject(
 
   // Find the path to this file in case the internal files are
   // specified as relative paths.
-  vtkstd::string filePath = this->FileName;
-  vtkstd::string::size_type pos = filePath.find_last_of("/\\");
-  if(pos != filePath.npos)
-    {
-    filePath = filePath.substr(0, pos);
-    }
-  else
-    {
-    filePath = "";
-    }
+  vtkstd::string filePath =
+    vtkXMLCollectionReaderGetFilePath(this->FileName);
 
-  // Create the readers for each data set to be read.
+  // Readers are only set up for the data sets that are actually read.
   int n = static_cast<int>(this->Internal->RestrictedDataSets.size());
-  this->Internal->Readers.resize(n);
+  this->Internal->Readers.assign(n, 0);
 
   if (n == 1 && !this->ForceOutputTypeToMultiBlock)
     {
@@ -452,7 +586,20 @@ int vtkXMLCollectionReader::RequestInformation(
     {
     info->Set(
       vtkStreamingDemandDrivenPipeline::MAXIMUM_NUMBER_OF_PIECES(), -1);
+
+    // The array lists are taken from the header of the first data set
+    // only; every other file stays closed until it is read.
+    if (nBlocks > 0 && !this->Internal->Readers[0].GetPointer())
+      {
+      vtkDataObject* first = this->SetupOutput(
+        vtkXMLCollectionReaderGetFilePath(this->FileName).c_str(), 0);
+      if (first)
+        {
+        first->Delete();
+        }
+      }
     }
+  this->UpdateArraySelections();
   this->Superclass::RequestInformation(request, inputVector, outputVector);
 
   return 1;
@@ -475,9 +622,10 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
 {
   this->BuildRestrictedDataSets();
 
-  // Create the readers for each data set to be read.
+  // Readers are only set up for the data sets that are actually read.
   int n = static_cast<int>(this->Internal->RestrictedDataSets.size());
-  this->Internal->Readers.resize(n);
+  this->Internal->Readers.assign(n, 0);
+  ++this->Internal->Pass;
 
   vtkInformation* outInfo = this->GetCurrentOutputInformation();
   int updatePiece = outInfo->Get(
@@ -489,17 +637,9 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
 
   // Find the path to this file in case the internal files are
   // specified as relative paths.
-  vtkstd::string filePath = this->FileName;
-  vtkstd::string::size_type pos = filePath.find_last_of("/\\");
-  if(pos != filePath.npos)
-    {
-    filePath = filePath.substr(0, pos);
-    }
-  else
-    {
-    filePath = "";
-    }
-  
+  vtkstd::string filePath =
+    vtkXMLCollectionReaderGetFilePath(this->FileName);
+
   if (!this->InternalForceMultiBlock)
     {
     vtkSmartPointer<vtkDataObject> actualOutput; 
@@ -525,6 +665,15 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
     unsigned int nBlocks = static_cast<unsigned int>(
       this->Internal->Readers.size());
     output->SetNumberOfBlocks(nBlocks);
+
+    // With enough data sets to go around, give each piece a contiguous
+    // range of whole files instead of a slice of every file.  Whole files
+    // have no neighbors to take ghost levels from, so pieces keep reading
+    // a slice of every file when ghost levels are requested.
+    bool distribute = this->DistributeFiles && updateNumPieces > 1 &&
+      updateGhostLevels == 0 &&
+      nBlocks >= static_cast<unsigned int>(updateNumPieces);
+
     for(unsigned int i=0; i < nBlocks; ++i)
       {
       vtkMultiBlockDataSet* block = vtkMultiBlockDataSet::SafeDownCast(
@@ -535,19 +684,65 @@ void vtkXMLCollectionReader::ReadXMLDataImpl()
         output->SetBlock(i, block);
         block->Delete();
         }
+      block->SetNumberOfBlocks(updateNumPieces);
+
+      int piece = updatePiece;
+      int numPieces = updateNumPieces;
+      int ghostLevels = updateGhostLevels;
+      if (distribute)
+        {
+        int owner = static_cast<int>(
+          (static_cast<vtkTypeInt64>(i) * updateNumPieces) / nBlocks);
+        if (owner != updatePiece)
+          {
+          block->SetBlock(updatePiece, 0);
+          continue;
+          }
+        piece = 0;
+        numPieces = 1;
+        ghostLevels = 0;
+        }
 
       this->CurrentOutput = i;
       vtkDataObject* actualOutput = this->SetupOutput(filePath.c_str(), i);
-      this->ReadAFile(i, 
-                      updatePiece,
-                      updateNumPieces,
-                      updateGhostLevels,
-                      actualOutput);
-      block->SetNumberOfBlocks(updateNumPieces);
+      if (actualOutput)
+        {
+        this->ReadAFile(i,
+                        piece,
+                        numPieces,
+                        ghostLevels,
+                        actualOutput);
+        }
       block->SetBlock(updatePiece, actualOutput);
-      actualOutput->Delete();
+      if (actualOutput)
+        {
+        actualOutput->Delete();
+        }
       }
     }
+
+  // Drop the readers of files that were not used by this pass or the
+  // previous one.  Readers kept from the previous pass only keep their
+  // parsed header; their data is released.
+  vtkXMLCollectionReaderCache::iterator c =
+    this->Internal->ReaderCache.begin();
+  while (c != this->Internal->ReaderCache.end())
+    {
+    if (c->second.Pass < this->Internal->Pass - 1)
+      {
+      this->Internal->ReaderCache.erase(c++);
+      continue;
+      }
+    if (c->second.Pass != this->Internal->Pass)
+      {
+      vtkDataObject* data = c->second.Reader->GetOutputDataObject(0);
+      if (data)
+        {
+        data->ReleaseData();
+        }
+      }
+    ++c;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -565,6 +760,12 @@ void vtkXMLCollectionReader::ReadAFile(int index,
     r->AddObserver(vtkCommand::ProgressEvent, 
                    this->InternalProgressObserver);
 
+    // Only read the arrays that are enabled on this reader.
+    vtkXMLCollectionReaderPushSelection(this->PointDataArraySelection,
+                                        r->GetPointDataArraySelection());
+    vtkXMLCollectionReaderPushSelection(this->CellDataArraySelection,
+                                        r->GetCellDataArraySelection());
+
     // Give the update request from this output to its internal
     // reader.
     vtkStreamingDemandDrivenPipeline::SafeDownCast(
@@ -22,6 +22,12 @@
 // the file matching the restrictions will be read.  Each matching
 // data set becomes an output of this reader in the order in which
 // they appear in the file.
+//
+// When DistributeFiles is on, the output is a multi-block and there are
+// at least as many data sets as pieces requested, each data set is read
+// whole by exactly one piece; other pieces never open it.
+// Point and cell array selections made on this reader are passed on
+// to the internal readers so that disabled arrays are not read.
 
 #ifndef __vtkXMLCollectionReader_h
 #define __vtkXMLCollectionReader_h
@@ -102,6 +108,17 @@ public:
   vtkGetMacro(ForceOutputTypeToMultiBlock, int);
   vtkBooleanMacro(ForceOutputTypeToMultiBlock, int);
 
+  // Description:
+  // When DistributeFiles is on and the output is a multi-block, the
+  // data sets are assigned to pieces in contiguous ranges and each one
+  // is read whole by its owner.  Pieces that do not own a data set leave
+  // its block empty without opening the file.  When off (the default),
+  // when ghost levels are requested or when there are fewer data sets
+  // than pieces, every piece reads its share of every data set.
+  vtkSetMacro(DistributeFiles, int);
+  vtkGetMacro(DistributeFiles, int);
+  vtkBooleanMacro(DistributeFiles, int);
+
 protected:
   vtkXMLCollectionReader();
   ~vtkXMLCollectionReader();  
@@ -110,6 +127,7 @@ protected:
 
   bool InternalForceMultiBlock;
   int ForceOutputTypeToMultiBlock;
+  int DistributeFiles;
 
   // Get the name of the data set being read.
   virtual const char* GetDataSetName();
@@ -119,6 +137,14 @@ protected:
 
   vtkDataObject* SetupOutput(const char* filePath, int index);
 
+  // Return the internal reader for the given file, reusing the one that
+  // already parsed its header if there is one.
+  vtkXMLReader* GetCachedReader(const char* fileName, const char* className);
+
+  // Fill the point and cell array selections of this reader from the
+  // internal readers that have been set up.
+  void UpdateArraySelections();
+
   virtual int RequestDataObject(vtkInformation* request, 
                                 vtkInformationVector** inputVector, 
                                 vtkInformationVector* outputVector);
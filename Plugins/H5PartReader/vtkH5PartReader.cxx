@@ -43,6 +43,8 @@
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkDataArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
 //
 #include "vtkCharArray.h"
 #include "vtkUnsignedCharArray.h"
@@ -74,6 +76,7 @@
 #include "vtkSmartPointer.h"
 
 #ifdef VTK_USE_MPI
+#include "vtkCommunicator.h"
 #include "vtkMultiProcessController.h"
 vtkCxxSetObjectMacro(vtkH5PartReader, Controller, vtkMultiProcessController);
 #endif
@@ -109,34 +112,41 @@ static hid_t H5PartGetNativeDatasetType(H5PartFile *f, const char *name)
 }
 
 //----------------------------------------------------------------------------
-static hid_t H5PartGetDiskShape(H5PartFile *f, hid_t dataset)
+// The particles of the current step read by this piece: a strided
+// hyperslab, or once a bounding box has been applied, the list of
+// indices of the particles inside it.
+struct vtkH5PartReaderSelection
+{
+  hsize_t Start;
+  hsize_t Stride;
+  hsize_t Count;
+  bool    UseElements;
+  vtkstd::vector<hsize_t> Elements;
+  //
+  hsize_t GetNumberOfParticles() const
+    {
+    return this->UseElements ? this->Elements.size() : this->Count;
+    }
+};
+
+//----------------------------------------------------------------------------
+static hid_t H5PartSelectParticles(hid_t dataset, const vtkH5PartReaderSelection &sel)
 {
   hid_t space = H5Dget_space(dataset);
-  if (H5PartHasView(f))
+  herr_t r;
+  if (sel.UseElements)
     {
-    int r;
-    hsize_t stride, count;
-    hsize_t range[2];
-    /* so, is this selection inclusive or exclusive? */
-    range[0]=f->viewstart;
-    range[1]=f->viewend;
-    count = range[1]-range[0]; /* to be inclusive */
-    stride=1;
-    /* now we select a subset */
-    if (f->diskshape>0)
-      {
-      r=H5Sselect_hyperslab(f->diskshape,H5S_SELECT_SET,
-        range/* only using first element */,
-        &stride,&count,NULL);
-      }
-    /* now we select a subset */
-    r=H5Sselect_hyperslab(space,H5S_SELECT_SET,
-      range,&stride,&count,NULL);
-    if (r<0)
-      {
-      fprintf(stderr,"Abort: Selection Failed!\n");
-      return space;
-      }
+    r = H5Sselect_elements(space, H5S_SELECT_SET,
+      sel.Elements.size(), &sel.Elements[0]);
+    }
+  else
+    {
+    r = H5Sselect_hyperslab(space, H5S_SELECT_SET,
+      &sel.Start, &sel.Stride, &sel.Count, NULL);
+    }
+  if (r<0)
+    {
+    fprintf(stderr,"Abort: Selection Failed!\n");
     }
   return space;
 }
@@ -163,6 +173,15 @@ vtkH5PartReader::vtkH5PartReader()
   this->UpdateNumPieces          = 0;
   this->TimeOutOfRange           = 0;
   this->MaskOutOfTimeRangeOutput = 0;
+  this->Stride                   = 1;
+  this->UseROI                   = 0;
+  this->ROIBounds[0]             = 0.0;
+  this->ROIBounds[1]             = 1.0;
+  this->ROIBounds[2]             = 0.0;
+  this->ROIBounds[3]             = 1.0;
+  this->ROIBounds[4]             = 0.0;
+  this->ROIBounds[5]             = 1.0;
+  this->StatisticsOnly           = 0;
   this->PointDataArraySelection  = vtkDataArraySelection::New();
   this->SetXarray("Coords_0");
   this->SetYarray("Coords_1");
@@ -461,31 +480,109 @@ int GetVTKDataType(int datatype)
 }
 
 //----------------------------------------------------------------------------
-//A Convenience Macro which does what we want for any dataset type
-#define H5PartReadDataArray(null, T2)  \
-  dataarray->SetNumberOfComponents(Nc); \
-  dataarray->SetNumberOfTuples(Nt);                           \
-  dataarray->SetName(rootname.c_str());                       \
-  herr_t r;                                                   \
-  hsize_t     count1_mem[] = { Nt*Nc };                       \
-  hsize_t     count2_mem[] = { Nt };                          \
-  hsize_t     offset_mem[] = { 0 };                           \
-  hsize_t     stride_mem[] = { Nc };                          \
-  for (c=0; c<Nc; c++) {                                      \
-    const char *name = arraylist[c].c_str();                  \
-    hid_t dataset   = H5Dopen(H5FileId->timegroup,name);      \
-    hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);   \
-    hid_t memspace = H5Screate_simple(1, count1_mem, NULL);   \
-    offset_mem[0] = c;                                        \
-    r = H5Sselect_hyperslab(                                  \
-      memspace, H5S_SELECT_SET,                               \
-      offset_mem, stride_mem, count2_mem, NULL);              \
-      H5Dread(dataset, null##T2, memspace,                    \
-      diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));  \
-    if (memspace!=H5S_ALL) H5Sclose(memspace);                \
-    if (diskshape!=H5S_ALL) H5Sclose(diskshape);              \
-    H5Dclose(dataset);                                        \
-  }
+// Read the components listed in arraylist for the selected particles
+// into a single (interleaved) array. Returns NULL for unsupported types.
+static vtkDataArray *H5PartReadArray(H5PartFile *H5FileId,
+  const vtkstd::vector<vtkstd::string> &arraylist, const char *rootname,
+  const vtkH5PartReaderSelection &sel)
+{
+  // use the type of the first array for all if it is a vector field
+  hid_t datatype = H5PartGetNativeDatasetType(H5FileId, arraylist[0].c_str());
+  int vtk_datatype = GetVTKDataType(datatype);
+  if (vtk_datatype == VTK_VOID)
+    {
+    H5Tclose(datatype);
+    return NULL;
+    }
+  int Nc = static_cast<int>(arraylist.size());
+  hsize_t Nt = sel.GetNumberOfParticles();
+  vtkDataArray *dataarray = vtkDataArray::CreateDataArray(vtk_datatype);
+  dataarray->SetNumberOfComponents(Nc);
+  dataarray->SetNumberOfTuples(static_cast<vtkIdType>(Nt));
+  dataarray->SetName(rootname);
+  if (Nt==0)
+    {
+    H5Tclose(datatype);
+    return dataarray;
+    }
+
+  // now read the data components.
+  hsize_t count1_mem[] = { Nt*Nc };
+  hsize_t count2_mem[] = { Nt };
+  hsize_t offset_mem[] = { 0 };
+  hsize_t stride_mem[] = { Nc };
+  for (int c=0; c<Nc; c++)
+    {
+    const char *name = arraylist[c].c_str();
+    hid_t dataset   = H5Dopen(H5FileId->timegroup,name);
+    hid_t diskshape = H5PartSelectParticles(dataset, sel);
+    hid_t memspace = H5Screate_simple(1, count1_mem, NULL);
+    hid_t component_datatype = H5PartGetNativeDatasetType(H5FileId, name);
+    offset_mem[0] = c;
+    H5Sselect_hyperslab(
+      memspace, H5S_SELECT_SET,
+      offset_mem, stride_mem, count2_mem, NULL);
+    if (H5Tequal(component_datatype, datatype))
+      {
+      H5Dread(dataset, datatype, memspace,
+        diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));
+      }
+    else
+      {
+      // read data into a temporary array of the right type and then copy it
+      // over to the "dataarray".
+      vtkDataArray* temparray =
+        vtkDataArray::CreateDataArray(GetVTKDataType(component_datatype));
+      temparray->SetNumberOfComponents(Nc);
+      temparray->SetNumberOfTuples(static_cast<vtkIdType>(Nt));
+      H5Dread(dataset, component_datatype, memspace,
+        diskshape, H5P_DEFAULT, temparray->GetVoidPointer(0));
+      dataarray->CopyComponent(c, temparray, c);
+      temparray->Delete();
+      }
+    H5Tclose(component_datatype);
+    H5Sclose(memspace);
+    H5Sclose(diskshape);
+    H5Dclose(dataset);
+    }
+  H5Tclose(datatype);
+  return dataarray;
+}
+
+//----------------------------------------------------------------------------
+// Compact the coordinates of the selected particles to those inside
+// bounds and switch the selection to the list of their indices.
+template <class T>
+void H5PartClipToBounds(T *xyz, vtkH5PartReaderSelection &sel, const double bounds[6])
+{
+  hsize_t n = sel.Count;
+  hsize_t kept = 0;
+  sel.Elements.clear();
+  for (hsize_t i=0; i<n; ++i)
+    {
+    const T *p = xyz + 3*i;
+    if (p[0]>=bounds[0] && p[0]<=bounds[1] &&
+        p[1]>=bounds[2] && p[1]<=bounds[3] &&
+        p[2]>=bounds[4] && p[2]<=bounds[5])
+      {
+      if (kept!=i)
+        {
+        T *q = xyz + 3*kept;
+        q[0] = p[0];
+        q[1] = p[1];
+        q[2] = p[2];
+        }
+      sel.Elements.push_back(sel.Start + i*sel.Stride);
+      ++kept;
+      }
+    }
+  // everything is inside, the hyperslab is cheaper than a point list
+  sel.UseElements = (kept!=n);
+  if (!sel.UseElements)
+    {
+    sel.Elements.clear();
+    }
+}
 
 //----------------------------------------------------------------------------
 /*
@@ -581,11 +678,15 @@ int vtkH5PartReader::RequestData(
     this->UpdatePiece = this->Controller->GetLocalProcessId();
     this->UpdateNumPieces = this->Controller->GetNumberOfProcesses();
   }
+#else
+  this->UpdatePiece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  this->UpdateNumPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
 #endif
-  //
-  // Parallel read currently not implemented, just read on process zero and
-  // exit quick on the others. @TODO : Add in Slab selection code
-  if (this->UpdatePiece>0) return 1;
+  if (this->UpdateNumPieces<1)
+    {
+    this->UpdatePiece = 0;
+    this->UpdateNumPieces = 1;
+    }
   //
   typedef vtkstd::map< vtkstd::string, vtkstd::vector<vtkstd::string> > FieldMap;
   FieldMap scalarFields;
@@ -718,100 +819,71 @@ int vtkH5PartReader::RequestData(
   // Set the TimeStep on the H5 file
   H5PartSetStep(this->H5FileId, this->ActualTimeStep);
   // Get the number of points for this step
-  vtkIdType Nt = H5PartGetNumParticles(this->H5FileId);
+  hsize_t Np = static_cast<hsize_t>(H5PartGetNumParticles(this->H5FileId));
+
+  // Each piece reads a contiguous share of the (strided) particles
+  vtkH5PartReaderSelection selection;
+  hsize_t Ns = (Np + this->Stride - 1)/this->Stride;
+  hsize_t first = (Ns*this->UpdatePiece)/this->UpdateNumPieces;
+  hsize_t last  = (Ns*(this->UpdatePiece+1))/this->UpdateNumPieces;
+  selection.Start       = first*this->Stride;
+  selection.Stride      = this->Stride;
+  selection.Count       = last-first;
+  selection.UseElements = false;
+
+  if (this->StatisticsOnly)
+    {
+    return this->ReadStatistics(output, selection);
+    }
+
+  // Read the coordinates first, the bounding box restricts which
+  // particles are read for all the other arrays
+  FieldMap::iterator coordentry = scalarFields.find("Coords");
+  vtkstd::string coordname = this->NameOfVectorComponent(coordentry->second[0].c_str());
+  vtkSmartPointer<vtkDataArray> coords;
+  coords.TakeReference(H5PartReadArray(this->H5FileId, coordentry->second,
+    coordname.c_str(), selection));
+  scalarFields.erase(coordentry);
+  if (!coords)
+    {
+    vtkErrorMacro("An unexpected data type was encountered");
+    return 0;
+    }
+  if (this->UseROI && coords->GetNumberOfTuples()>0)
+    {
+    switch (coords->GetDataType())
+      {
+      vtkTemplateMacro(
+        H5PartClipToBounds(static_cast<VTK_TT*>(coords->GetVoidPointer(0)),
+          selection, this->ROIBounds));
+      }
+    if (selection.UseElements)
+      {
+      coords->SetNumberOfTuples(static_cast<vtkIdType>(selection.Elements.size()));
+      coords->Squeeze();
+      }
+    }
+  vtkIdType Nt = coords->GetNumberOfTuples();
 
   // Setup arrays for reading data
   vtkSmartPointer<vtkPoints>    points = vtkSmartPointer<vtkPoints>::New();
-  vtkSmartPointer<vtkDataArray> coords = NULL;
   for (FieldMap::iterator it=scalarFields.begin(); it!=scalarFields.end(); it++)
     {
-    // use the type of the first array for all if it is a vector field
     vtkstd::vector<vtkstd::string> &arraylist = (*it).second;
-    const char *array_name = arraylist[0].c_str();
-    vtkstd::string rootname = this->NameOfVectorComponent(array_name);
-    int Nc = static_cast<int>(arraylist.size());
+    vtkstd::string rootname = this->NameOfVectorComponent(arraylist[0].c_str());
     //
-    vtkSmartPointer<vtkDataArray> dataarray = NULL;
-    hid_t datatype = H5PartGetNativeDatasetType(H5FileId,array_name);
-    int vtk_datatype = GetVTKDataType(datatype);
-
-    if (vtk_datatype != VTK_VOID)
-      {
-      dataarray.TakeReference(vtkDataArray::CreateDataArray(vtk_datatype));
-      dataarray->SetNumberOfComponents(Nc);
-      dataarray->SetNumberOfTuples(Nt);
-      dataarray->SetName(rootname.c_str());
-
-      // now read the data components.
-      herr_t r;
-      hsize_t count1_mem[] = { Nt*Nc };
-      hsize_t count2_mem[] = { Nt };
-      hsize_t offset_mem[] = { 0 };
-      hsize_t stride_mem[] = { Nc };
-      for (int c=0; c<Nc; c++)
-        {
-        const char *name = arraylist[c].c_str();
-        hid_t dataset   = H5Dopen(H5FileId->timegroup,name);
-        hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);
-        hid_t memspace = H5Screate_simple(1, count1_mem, NULL);
-        hid_t component_datatype = H5PartGetNativeDatasetType(H5FileId, name);
-        offset_mem[0] = c;
-        r = H5Sselect_hyperslab(
-          memspace, H5S_SELECT_SET,
-          offset_mem, stride_mem, count2_mem, NULL);
-        if (component_datatype == datatype)
-          {
-          H5Dread(dataset, datatype, memspace,
-            diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));
-          }
-        else
-          {
-          // read data into a temporary array of the right type and then copy it
-          // over to the "dataarray".
-          // This can be optimized to create a single component array. But I
-          // don't understand the stride/offset stuff too well to fix that.
-          vtkDataArray* temparray =
-            vtkDataArray::CreateDataArray(GetVTKDataType(component_datatype));
-          temparray->SetNumberOfComponents(Nc);
-          temparray->SetNumberOfTuples(Nt);
-          r = H5Sselect_hyperslab(
-            memspace, H5S_SELECT_SET,
-            offset_mem, stride_mem, count2_mem, NULL);
-          H5Dread(dataset, component_datatype, memspace,
-            diskshape, H5P_DEFAULT, temparray->GetVoidPointer(0));
-          dataarray->CopyComponent(c, temparray, c);
-          temparray->Delete();
-          }
-        if (memspace!=H5S_ALL)
-          {
-          H5Sclose(memspace);
-          }
-        if (diskshape!=H5S_ALL)
-          {
-          H5Sclose(diskshape);
-          }
-        H5Dclose(dataset);
-        }
-      }
-    else
+    vtkSmartPointer<vtkDataArray> dataarray;
+    dataarray.TakeReference(H5PartReadArray(this->H5FileId, arraylist,
+      rootname.c_str(), selection));
+    if (!dataarray)
       {
-      H5Tclose(datatype);
       vtkErrorMacro("An unexpected data type was encountered");
       return 0;
       }
-    H5Tclose(datatype);
-    //
-    if (dataarray)
+    output->GetPointData()->AddArray(dataarray);
+    if (!output->GetPointData()->GetScalars())
       {
-      if ((*it).first=="Coords") coords = dataarray;
-      else
-        {
-        output->GetPointData()->AddArray(dataarray);
-        if (!output->GetPointData()->GetScalars())
-          {
-          output->GetPointData()->SetActiveScalars(dataarray->GetName());
-          }
-        }
+      output->GetPointData()->SetActiveScalars(dataarray->GetName());
       }
     }
 
@@ -832,6 +904,108 @@ int vtkH5PartReader::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkH5PartReader::ReadStatistics(vtkPolyData *output,
+  const vtkH5PartReaderSelection &sel)
+{
+  // The coordinates are deliberately left out, they are what this mode
+  // avoids reading
+  vtkstd::vector<vtkstd::string> names;
+  int N = this->PointDataArraySelection->GetNumberOfArrays();
+  for (int i=0; i<N; i++)
+    {
+    const char *name = this->PointDataArraySelection->GetArrayName(i);
+    if (!this->PointDataArraySelection->ArrayIsEnabled(name) ||
+        !vtksys::SystemTools::Strucmp(name,this->Xarray) ||
+        !vtksys::SystemTools::Strucmp(name,this->Yarray) ||
+        !vtksys::SystemTools::Strucmp(name,this->Zarray))
+      {
+      continue;
+      }
+    names.push_back(name);
+    }
+  //
+  int Na = static_cast<int>(names.size());
+  vtkstd::vector<double> ranges(2*Na);
+  for (int a=0; a<Na; a++)
+    {
+    ranges[2*a]   = VTK_DOUBLE_MAX;
+    ranges[2*a+1] = -VTK_DOUBLE_MAX;
+    }
+  // Read in bounded chunks, converting to double as we go
+  const hsize_t chunk = 1<<20;
+  vtkstd::vector<double> buffer(static_cast<size_t>(vtkstd::min(chunk, sel.Count)));
+  for (int a=0; a<Na && sel.Count>0; a++)
+    {
+    hid_t dataset = H5Dopen(this->H5FileId->timegroup, names[a].c_str());
+    if (dataset<0)
+      {
+      continue;
+      }
+    hid_t space = H5Dget_space(dataset);
+    for (hsize_t done=0; done<sel.Count; )
+      {
+      hsize_t n = vtkstd::min(chunk, sel.Count-done);
+      hsize_t start = sel.Start + done*sel.Stride;
+      H5Sselect_hyperslab(space, H5S_SELECT_SET, &start, &sel.Stride, &n, NULL);
+      hid_t memspace = H5Screate_simple(1, &n, NULL);
+      H5Dread(dataset, H5T_NATIVE_DOUBLE, memspace, space, H5P_DEFAULT, &buffer[0]);
+      H5Sclose(memspace);
+      for (hsize_t j=0; j<n; ++j)
+        {
+        ranges[2*a]   = vtkstd::min(ranges[2*a], buffer[j]);
+        ranges[2*a+1] = vtkstd::max(ranges[2*a+1], buffer[j]);
+        }
+      done += n;
+      }
+    H5Sclose(space);
+    H5Dclose(dataset);
+    }
+
+  vtkIdType count = static_cast<vtkIdType>(sel.Count);
+#ifdef VTK_USE_MPI
+  if (this->Controller && this->UpdateNumPieces>1)
+    {
+    vtkstd::vector<double> mins(Na+1), maxs(Na+1), gmins(Na+1), gmaxs(Na+1);
+    for (int a=0; a<Na; a++)
+      {
+      mins[a] = ranges[2*a];
+      maxs[a] = ranges[2*a+1];
+      }
+    vtkIdType total = 0;
+    this->Controller->Reduce(&count, &total, 1, vtkCommunicator::SUM_OP, 0);
+    if (Na>0)
+      {
+      this->Controller->Reduce(&mins[0], &gmins[0], Na, vtkCommunicator::MIN_OP, 0);
+      this->Controller->Reduce(&maxs[0], &gmaxs[0], Na, vtkCommunicator::MAX_OP, 0);
+      }
+    for (int a=0; a<Na; a++)
+      {
+      ranges[2*a]   = gmins[a];
+      ranges[2*a+1] = gmaxs[a];
+      }
+    count = total;
+    }
+#endif
+  if (this->UpdatePiece!=0)
+    {
+    return 1;
+    }
+  //
+  vtkSmartPointer<vtkIdTypeArray> numParticles = vtkSmartPointer<vtkIdTypeArray>::New();
+  numParticles->SetName("NumberOfParticles");
+  numParticles->InsertNextValue(count);
+  output->GetFieldData()->AddArray(numParticles);
+  for (int a=0; a<Na; a++)
+    {
+    vtkSmartPointer<vtkDoubleArray> range = vtkSmartPointer<vtkDoubleArray>::New();
+    range->SetName((names[a] + "_Range").c_str());
+    range->SetNumberOfComponents(2);
+    range->InsertNextTuple(&ranges[2*a]);
+    output->GetFieldData()->AddArray(range);
+    }
+  return 1;
+}
 //----------------------------------------------------------------------------
 int vtkH5PartReader::GetCoordinateArrayStatus(const char* name)
 {
@@ -910,4 +1084,12 @@ void vtkH5PartReader::PrintSelf(ostream& os, vtkIndent indent)
     (this->FileName ? this->FileName : "(none)") << "\n";
 
   os << indent << "NumberOfSteps: " <<  this->NumberOfTimeSteps << "\n";
+
+  os << indent << "Stride: " << this->Stride << "\n";
+  os << indent << "UseROI: " << this->UseROI << "\n";
+  os << indent << "ROIBounds: " << this->ROIBounds[0] << " "
+     << this->ROIBounds[1] << " " << this->ROIBounds[2] << " "
+     << this->ROIBounds[3] << " " << this->ROIBounds[4] << " "
+     << this->ROIBounds[5] << "\n";
+  os << indent << "StatisticsOnly: " << this->StatisticsOnly << "\n";
 }
@@ -53,6 +53,9 @@ class vtkDataArraySelection;
 class vtkMultiProcessController;
 
 struct H5PartFile;
+//BTX
+struct vtkH5PartReaderSelection;
+//ETX
 
 class vtkH5PartReader : public vtkPolyDataAlgorithm
 {
@@ -121,6 +124,35 @@ public:
   vtkGetMacro(MaskOutOfTimeRangeOutput, int);
   vtkBooleanMacro(MaskOutOfTimeRangeOutput, int);
 
+  // Description:
+  // Read only every Stride'th particle (default 1, all particles).
+  // The stride is applied on the file with an HDF5 hyperslab so the
+  // skipped particles are never read.
+  vtkSetClampMacro(Stride, int, 1, VTK_INT_MAX);
+  vtkGetMacro(Stride, int);
+
+  // Description:
+  // When UseROI is set, only the particles whose coordinates lie inside
+  // ROIBounds (xmin, xmax, ymin, ymax, zmin, zmax) are kept. The
+  // coordinates are read first and the other arrays are then read with
+  // an HDF5 point selection of the particles inside the box.
+  vtkSetMacro(UseROI, int);
+  vtkGetMacro(UseROI, int);
+  vtkBooleanMacro(UseROI, int);
+  vtkSetVector6Macro(ROIBounds, double);
+  vtkGetVector6Macro(ROIBounds, double);
+
+  // Description:
+  // When StatisticsOnly is set, no points are produced. Instead the
+  // field data of the output holds the number of particles that would
+  // be read ("NumberOfParticles") and the range of each enabled array
+  // other than the coordinate arrays ("<name>_Range"). The ranges are
+  // computed over the strided particles; ROI is not applied since it
+  // needs the coordinates. In parallel the result is on process 0.
+  vtkSetMacro(StatisticsOnly, int);
+  vtkGetMacro(StatisticsOnly, int);
+  vtkBooleanMacro(StatisticsOnly, int);
+
   bool HasStep(int Step);
 
   // Description:
@@ -175,6 +207,9 @@ protected:
   int   RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   int   OpenFile();
   void  CloseFile();
+//BTX
+  int   ReadStatistics(vtkPolyData *output, const vtkH5PartReaderSelection &sel);
+//ETX
 //  void  CopyIntoCoords(int offset, vtkDataArray *source, vtkDataArray *dest);
   // returns 0 if no, returns 1,2,3,45 etc for the first, second...
   // example : if CombineVectorComponents is true, then 
@@ -202,6 +237,10 @@ protected:
   int           UpdateNumPieces;
   int           MaskOutOfTimeRangeOutput;
   int           TimeOutOfRange;
+  int           Stride;
+  int           UseROI;
+  double        ROIBounds[6];
+  int           StatisticsOnly;
   //
   char         *Xarray;
   char         *Yarray;
@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDepthSortPainter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tests the order of the cells sorted by vtkDepthSortPainter: exact with the
+// radix sort, exact again with the insertion sort of a nearly sorted order,
+// sorted into depth slabs with SORT_APPROXIMATE, and computed again when the
+// depth sort mode changes.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkDepthSortPainter.h"
+#include "vtkDepthSortPolyData.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+
+#include <vtkstd/vector>
+
+// Gives access to PrepareForRendering() without a render window.
+class vtkTestDepthSortPainter : public vtkDepthSortPainter
+{
+public:
+  static vtkTestDepthSortPainter* New();
+  vtkTypeMacro(vtkTestDepthSortPainter, vtkDepthSortPainter);
+
+  void Prepare(vtkRenderer* renderer, vtkActor* actor)
+    {
+    this->PrepareForRendering(renderer, actor);
+    }
+};
+vtkStandardNewMacro(vtkTestDepthSortPainter);
+
+//----------------------------------------------------------------------------
+// Checks that the vertices of the output are a permutation of the input ones
+// going from back to front, a vertex being allowed to be at most tolerance
+// farther than the previous one.
+static int CheckOrder(vtkTestDepthSortPainter* painter, vtkRenderer* renderer,
+  double tolerance)
+{
+  vtkPolyData* input = vtkPolyData::SafeDownCast(painter->GetInput());
+  vtkPolyData* output = vtkPolyData::SafeDownCast(painter->GetOutput());
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (!output || output->GetNumberOfCells() != numCells)
+    {
+    cerr << "ERROR: wrong number of cells in the output" << endl;
+    return 1;
+    }
+
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double origin[3], direction[3];
+  camera->GetPosition(origin);
+  camera->GetFocalPoint(direction);
+  for (int i = 0; i < 3; i++)
+    {
+    direction[i] -= origin[i];
+    }
+  vtkMath::Normalize(direction);
+
+  vtkstd::vector<bool> seen(numCells, false);
+  vtkIdType* cell = output->GetVerts()->GetPointer();
+  double previous = VTK_DOUBLE_MAX;
+  for (vtkIdType i = 0; i < numCells; i++, cell += 2)
+    {
+    if (cell[0] != 1 || cell[1] < 0 || cell[1] >= numCells || seen[cell[1]])
+      {
+      cerr << "ERROR: the output cells are not a permutation of the input ones"
+        << endl;
+      return 1;
+      }
+    seen[cell[1]] = true;
+    double x[3];
+    output->GetPoint(cell[1], x);
+    double depth = (x[0] - origin[0]) * direction[0] +
+      (x[1] - origin[1]) * direction[1] + (x[2] - origin[2]) * direction[2];
+    if (depth > previous + tolerance)
+      {
+      cerr << "ERROR: cells not sorted from back to front" << endl;
+      return 1;
+      }
+    previous = depth;
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+// One vertex per point, randomly placed in a unit cube. Enough cells for the
+// radix sort to use several threads.
+static vtkPolyData* CreateVertices(vtkIdType numPoints)
+{
+  vtkMath::RandomSeed(4321);
+  vtkPoints* points = vtkPoints::New();
+  points->SetNumberOfPoints(numPoints);
+  vtkCellArray* verts = vtkCellArray::New();
+  for (vtkIdType i = 0; i < numPoints; i++)
+    {
+    points->SetPoint(i, vtkMath::Random(), vtkMath::Random(),
+      vtkMath::Random());
+    verts->InsertNextCell(1, &i);
+    }
+  vtkPolyData* polyData = vtkPolyData::New();
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  points->Delete();
+  verts->Delete();
+  return polyData;
+}
+
+//----------------------------------------------------------------------------
+static int TestSortOrder(vtkRenderer* renderer, vtkActor* actor)
+{
+  vtkPolyData* input = CreateVertices(70000);
+  vtkTestDepthSortPainter* painter = vtkTestDepthSortPainter::New();
+  painter->SetInput(input);
+  painter->SetNumberOfThreads(4);
+  input->Delete();
+
+  // The depths span sqrt(3) at most, quantized on 32 bits.
+  double epsilon = 1e-9;
+  int result = 0;
+  renderer->GetActiveCamera()->SetPosition(2.0, 3.0, 5.0);
+  renderer->GetActiveCamera()->SetFocalPoint(0.5, 0.5, 0.5);
+  painter->Prepare(renderer, actor);
+  if (CheckOrder(painter, renderer, epsilon))
+    {
+    cerr << "with the radix sort" << endl;
+    result = 1;
+    }
+
+  // A small rotation: the previous order is nearly sorted.
+  renderer->GetActiveCamera()->Azimuth(0.05);
+  painter->Prepare(renderer, actor);
+  if (CheckOrder(painter, renderer, epsilon))
+    {
+    cerr << "with the insertion sort" << endl;
+    result = 1;
+    }
+
+  // Only sorted into 4096 slabs, then refined by an exact sort.
+  renderer->GetActiveCamera()->Azimuth(30.0);
+  painter->SetSortQuality(vtkDepthSortPainter::SORT_APPROXIMATE);
+  painter->Prepare(renderer, actor);
+  if (CheckOrder(painter, renderer, sqrt(3.0) / 4096.0 + epsilon))
+    {
+    cerr << "with the approximate sort" << endl;
+    result = 1;
+    }
+  painter->SetSortQuality(vtkDepthSortPainter::SORT_EXACT);
+  painter->Prepare(renderer, actor);
+  if (CheckOrder(painter, renderer, epsilon))
+    {
+    cerr << "when refining the approximate sort" << endl;
+    result = 1;
+    }
+  painter->Delete();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+// Two triangles, the first one nearest by the center of its bounds and
+// farthest by its first point.
+static int TestDepthSortMode(vtkRenderer* renderer, vtkActor* actor)
+{
+  double coords[6][3] = {
+    { 0.0, 0.0, 0.0 }, { 1.0, 0.0, 5.0 }, { 0.0, 1.0, 5.0 },
+    { 0.0, 0.0, 1.0 }, { 1.0, 0.0, 1.0 }, { 0.0, 1.0, 1.0 } };
+  vtkPoints* points = vtkPoints::New();
+  vtkCellArray* polys = vtkCellArray::New();
+  for (vtkIdType i = 0; i < 6; i++)
+    {
+    points->InsertNextPoint(coords[i]);
+    }
+  vtkIdType triangles[2][3] = { { 0, 1, 2 }, { 3, 4, 5 } };
+  polys->InsertNextCell(3, triangles[0]);
+  polys->InsertNextCell(3, triangles[1]);
+  vtkPolyData* input = vtkPolyData::New();
+  input->SetPoints(points);
+  input->SetPolys(polys);
+  points->Delete();
+  polys->Delete();
+
+  vtkTestDepthSortPainter* painter = vtkTestDepthSortPainter::New();
+  painter->SetInput(input);
+  input->Delete();
+  renderer->GetActiveCamera()->SetPosition(0.0, 0.0, 10.0);
+  renderer->GetActiveCamera()->SetFocalPoint(0.0, 0.0, 0.0);
+
+  // Back to front along -Z: by first point the first triangle comes first,
+  // by center it comes last.
+  int result = 0;
+  painter->GetDepthSortPolyData()->SetDepthSortModeToFirstPoint();
+  painter->Prepare(renderer, actor);
+  vtkPolyData* output = vtkPolyData::SafeDownCast(painter->GetOutput());
+  if (output->GetPolys()->GetPointer()[1] != 0)
+    {
+    cerr << "ERROR: wrong order with the first point depth" << endl;
+    result = 1;
+    }
+  painter->GetDepthSortPolyData()->SetDepthSortModeToBoundsCenter();
+  painter->Prepare(renderer, actor);
+  output = vtkPolyData::SafeDownCast(painter->GetOutput());
+  if (output->GetPolys()->GetPointer()[1] != 3)
+    {
+    cerr << "ERROR: order not computed again for the new depth sort mode"
+      << endl;
+    result = 1;
+    }
+  painter->Delete();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int main(int, char*[])
+{
+  // No render window: the sort only needs the camera of the renderer and a
+  // translucent actor.
+  vtkRenderer* renderer = vtkRenderer::New();
+  vtkActor* actor = vtkActor::New();
+  actor->GetProperty()->SetOpacity(0.5);
+
+  int result = TestSortOrder(renderer, actor);
+  result |= TestDepthSortMode(renderer, actor);
+
+  actor->Delete();
+  renderer->Delete();
+  return result;
+}
@@ -48,10 +48,16 @@
 #include "vtkProperty.h"
 #include "vtkDepthSortPolyData.h"
 #include "vtkScalarsToColors.h"
+#include "vtkActor.h"
+#include "vtkMultiThreader.h"
+#include "vtkRenderWindow.h"
+#include "vtkSmartPointer.h"
 
 #include <vtkstd/vector>
+#include <vtkstd/map>
 #include <vtkstd/algorithm>
 #include <functional>
+#include <string.h>
 
 #include <cmath>
 #include "vtkImageData.h"
@@ -60,6 +66,254 @@
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 
+//-----------------------------------------------------------------------------
+// One pass of the radix sort, on the digit (Keys >> Shift) & Mask. The keys
+// are split into NumberOfChunks contiguous chunks; the buckets of every chunk
+// are counted first, then, once Offsets holds where each chunk writes each
+// bucket, every chunk scatters its keys. Chunks are independent so both steps
+// are done in parallel, and the pass is stable.
+struct vtkDepthSortPainterRadixPass
+{
+  const vtkTypeUInt32* Keys;
+  const vtkIdType* Ids;
+  vtkTypeUInt32* OutKeys;
+  vtkIdType* OutIds;
+  vtkIdType Size;
+  int Shift;
+  vtkTypeUInt32 Mask;
+  int NumberOfBuckets;
+  int NumberOfChunks;
+  bool Scatter;
+  vtkstd::vector<vtkIdType> Offsets;
+};
+
+//-----------------------------------------------------------------------------
+static void vtkDepthSortPainterRadixChunk(vtkDepthSortPainterRadixPass* pass,
+  int chunk)
+{
+  vtkIdType begin = pass->Size * chunk / pass->NumberOfChunks;
+  vtkIdType end = pass->Size * (chunk + 1) / pass->NumberOfChunks;
+  vtkIdType* offsets = &pass->Offsets[chunk * pass->NumberOfBuckets];
+  const vtkTypeUInt32* keys = pass->Keys;
+  if (!pass->Scatter)
+    {
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      offsets[(keys[i] >> pass->Shift) & pass->Mask]++;
+      }
+    return;
+    }
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    vtkIdType dest = offsets[(keys[i] >> pass->Shift) & pass->Mask]++;
+    pass->OutKeys[dest] = keys[i];
+    pass->OutIds[dest] = pass->Ids[i];
+    }
+}
+
+//-----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkDepthSortPainterRadixThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDepthSortPainterRadixPass* pass =
+    static_cast<vtkDepthSortPainterRadixPass*>(info->UserData);
+
+  // Chunks are handed out round-robin.
+  for (int chunk = info->ThreadID; chunk < pass->NumberOfChunks;
+    chunk += info->NumberOfThreads)
+    {
+    vtkDepthSortPainterRadixChunk(pass, chunk);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//-----------------------------------------------------------------------------
+// Sorts keys (and ids along) in increasing order of their bits from firstBit
+// to 31, bitsPerPass bits at a time. With firstBit = 0 the sort is exact;
+// with firstBit = 20 and bitsPerPass = 12 it only sorts the keys into 4096
+// buckets in a single pass.
+static void vtkDepthSortPainterRadixSort(vtkstd::vector<vtkTypeUInt32>& keys,
+  vtkstd::vector<vtkIdType>& ids, int firstBit, int bitsPerPass,
+  int numThreads)
+{
+  vtkIdType size = static_cast<vtkIdType>(keys.size());
+  if (size < 2)
+    {
+    return;
+    }
+  vtkstd::vector<vtkTypeUInt32> tmpKeys(size);
+  vtkstd::vector<vtkIdType> tmpIds(size);
+
+  vtkDepthSortPainterRadixPass pass;
+  pass.Size = size;
+  pass.NumberOfBuckets = 1 << bitsPerPass;
+  pass.Mask = static_cast<vtkTypeUInt32>(pass.NumberOfBuckets - 1);
+  pass.NumberOfChunks = numThreads > 1? numThreads : 1;
+
+  vtkMultiThreader* threader = NULL;
+  if (pass.NumberOfChunks > 1)
+    {
+    threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(pass.NumberOfChunks);
+    threader->SetSingleMethod(vtkDepthSortPainterRadixThread, &pass);
+    }
+
+  for (int shift = firstBit; shift < 32; shift += bitsPerPass)
+    {
+    pass.Keys = &keys[0];
+    pass.Ids = &ids[0];
+    pass.OutKeys = &tmpKeys[0];
+    pass.OutIds = &tmpIds[0];
+    pass.Shift = shift;
+
+    pass.Offsets.assign(pass.NumberOfChunks * pass.NumberOfBuckets, 0);
+    pass.Scatter = false;
+    if (threader)
+      {
+      threader->SingleMethodExecute();
+      }
+    else
+      {
+      vtkDepthSortPainterRadixChunk(&pass, 0);
+      }
+
+    // Turn the counts into offsets, bucket by bucket then chunk by chunk.
+    // A digit shared by all the keys needs no scattering.
+    vtkIdType running = 0;
+    bool trivial = false;
+    for (int b = 0; b < pass.NumberOfBuckets && !trivial; b++)
+      {
+      vtkIdType bucketStart = running;
+      for (int c = 0; c < pass.NumberOfChunks; c++)
+        {
+        vtkIdType& offset = pass.Offsets[c * pass.NumberOfBuckets + b];
+        vtkIdType count = offset;
+        offset = running;
+        running += count;
+        }
+      trivial = (running - bucketStart == size);
+      }
+    if (trivial)
+      {
+      continue;
+      }
+
+    pass.Scatter = true;
+    if (threader)
+      {
+      threader->SingleMethodExecute();
+      }
+    else
+      {
+      vtkDepthSortPainterRadixChunk(&pass, 0);
+      }
+    keys.swap(tmpKeys);
+    ids.swap(tmpIds);
+    }
+
+  if (threader)
+    {
+    threader->Delete();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Insertion sort of keys that are expected to be almost sorted already (the
+// order of the previous sort). Gives up, leaving a valid permutation, once
+// more than maxMoves keys have been moved.
+static bool vtkDepthSortPainterInsertionSort(vtkTypeUInt32* keys,
+  vtkIdType* ids, vtkIdType size, vtkIdType maxMoves)
+{
+  vtkIdType moves = 0;
+  for (vtkIdType i = 1; i < size; i++)
+    {
+    vtkTypeUInt32 key = keys[i];
+    if (keys[i - 1] <= key)
+      {
+      continue;
+      }
+    vtkIdType id = ids[i];
+    vtkIdType j = i;
+    while (j > 0 && keys[j - 1] > key)
+      {
+      keys[j] = keys[j - 1];
+      ids[j] = ids[j - 1];
+      j--;
+      if (++moves > maxMoves)
+        {
+        keys[j] = key;
+        ids[j] = id;
+        return false;
+        }
+      }
+    keys[j] = key;
+    ids[j] = id;
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// The last sort of one polydata.
+struct vtkDepthSortPainterBlock
+{
+  vtkWeakPointer<vtkPolyData> Input;
+  unsigned long InputMTime;
+  // Location of each cell in the connectivity of its cell array.
+  vtkstd::vector<vtkIdType> Offsets;
+  // Cell ids, back to front.
+  vtkstd::vector<vtkIdType> Order;
+  double Direction[3];
+  // The vtkDepthSortPolyData depth sort mode the order was computed with.
+  int DepthSortMode;
+  bool Approximate;
+  vtkSmartPointer<vtkPolyData> Output;
+
+  vtkDepthSortPainterBlock()
+    {
+    this->InputMTime = 0;
+    this->Direction[0] = this->Direction[1] = this->Direction[2] = 0.0;
+    this->DepthSortMode = -1;
+    this->Approximate = false;
+    }
+};
+
+//-----------------------------------------------------------------------------
+class vtkDepthSortPainter::vtkInternals
+{
+public:
+  vtkstd::map<vtkPolyData*, vtkDepthSortPainterBlock> Blocks;
+
+  // Whether the current render is to be sorted approximately, and whether the
+  // last sort was.
+  bool Approximate;
+  bool LastSortApproximate;
+
+  vtkInternals()
+    {
+    this->Approximate = false;
+    this->LastSortApproximate = false;
+    }
+
+  // Forget the blocks that do not exist anymore.
+  void PruneBlocks()
+    {
+    vtkstd::map<vtkPolyData*, vtkDepthSortPainterBlock>::iterator iter =
+      this->Blocks.begin();
+    while (iter != this->Blocks.end())
+      {
+      if (iter->second.Input.GetPointer() == NULL)
+        {
+        this->Blocks.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    }
+};
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDepthSortPainter)
 //-----------------------------------------------------------------------------
@@ -75,17 +329,27 @@ vtkDepthSortPainter::vtkDepthSortPainter()
   this->CachedIsColorSemiTranslucent = 1;
   this->DepthSortPolyData = vtkDepthSortPolyData::New();
   this->OutputData = NULL;
+  this->SortQuality = SORT_APPROXIMATE_WHEN_INTERACTING;
+  this->ViewAngleTolerance = 0.0;
+  this->NumberOfThreads = 0;
+  this->Internals = new vtkInternals();
 }
 //-----------------------------------------------------------------------------
 vtkDepthSortPainter::~vtkDepthSortPainter()
 {
   this->SetDepthSortPolyData(NULL);
   this->SetOutputData(NULL);
+  delete this->Internals;
+  this->Internals = NULL;
 }
 //-----------------------------------------------------------------------------
 void vtkDepthSortPainter::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DepthSortEnableMode: " << this->DepthSortEnableMode << endl;
+  os << indent << "SortQuality: " << this->SortQuality << endl;
+  os << indent << "ViewAngleTolerance: " << this->ViewAngleTolerance << endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -100,9 +364,17 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
     this->DepthSortPolyData->SetDirectionToBackToFront();
     }
 
-  // check if we need to update
+  // interactive renders are the ones asking for more than 1 frame per second
+  vtkRenderWindow* renWin = renderer->GetRenderWindow();
+  bool interacting = renWin && renWin->GetDesiredUpdateRate() > 1.0;
+  this->Internals->Approximate = (this->SortQuality == SORT_APPROXIMATE ||
+    (this->SortQuality == SORT_APPROXIMATE_WHEN_INTERACTING && interacting));
+
+  // check if we need to update. An approximate sort is refined for a still
+  // render even if nothing changed.
   if (this->GetMTime() < this->SortTime && this->DepthSortPolyData->GetMTime()
-      < this->SortTime && this->GetInput()->GetMTime() < this->SortTime)
+      < this->SortTime && this->GetInput()->GetMTime() < this->SortTime &&
+      (this->Internals->Approximate || !this->Internals->LastSortApproximate))
     {
     return;
     }
@@ -120,6 +392,7 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
 
   if (this->DepthSortPolyData != NULL && this->NeedSorting(renderer, actor))
     {
+    this->Internals->PruneBlocks();
     if (input->IsA("vtkCompositeDataSet"))
       {
       vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
@@ -145,15 +418,26 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
       this->Sort(vtkDataSet::SafeDownCast(this->OutputData),
           vtkDataSet::SafeDownCast(input), renderer, actor);
       }
+    this->Internals->LastSortApproximate = this->Internals->Approximate;
     this->SortTime.Modified();
     }
 }
 
+//-----------------------------------------------------------------------------
 void vtkDepthSortPainter::Sort(vtkDataSet* output,
     vtkDataSet* input,
-    vtkRenderer* vtkNotUsed(renderer),
-    vtkActor* vtkNotUsed(actor))
+    vtkRenderer* renderer,
+    vtkActor* actor)
 {
+  vtkPolyData* pdInput = vtkPolyData::SafeDownCast(input);
+  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
+  if (pdInput && pdOutput && renderer->GetActiveCamera() &&
+    !this->DepthSortPolyData->GetSortScalars())
+    {
+    this->SortPolyData(pdOutput, pdInput, renderer, actor);
+    return;
+    }
+
   this->DepthSortPolyData->SetInput(input);
 
   this->DepthSortPolyData->Update();
@@ -163,6 +447,232 @@ void vtkDepthSortPainter::Sort(vtkDataSet* output,
   output->ShallowCopy(polyData);
 }
 
+//-----------------------------------------------------------------------------
+void vtkDepthSortPainter::SortPolyData(vtkPolyData* output,
+  vtkPolyData* input, vtkRenderer* renderer, vtkActor* actor)
+{
+  vtkDepthSortPainterBlock& block = this->Internals->Blocks[input];
+  vtkIdType numCells = input->GetNumberOfCells();
+  bool approximate = this->Internals->Approximate;
+
+  // The view direction, in the coordinates of the actor, like
+  // vtkDepthSortPolyData does.
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double origin[4] = { 0.0, 0.0, 0.0, 1.0 };
+  double focalPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+  camera->GetPosition(origin);
+  camera->GetFocalPoint(focalPoint);
+  if (actor)
+    {
+    vtkMatrix4x4* matrix = vtkMatrix4x4::New();
+    matrix->DeepCopy(actor->GetMatrix());
+    matrix->Invert();
+    matrix->MultiplyPoint(origin, origin);
+    matrix->MultiplyPoint(focalPoint, focalPoint);
+    matrix->Delete();
+    for (int i = 0; i < 3; i++)
+      {
+      origin[i] /= origin[3];
+      focalPoint[i] /= focalPoint[3];
+      }
+    }
+  double direction[3];
+  for (int i = 0; i < 3; i++)
+    {
+    direction[i] = focalPoint[i] - origin[i];
+    }
+  vtkMath::Normalize(direction);
+
+  bool sameInput = (block.Input.GetPointer() == input &&
+    block.InputMTime == input->GetMTime() &&
+    static_cast<vtkIdType>(block.Order.size()) == numCells);
+
+  // The depth of a cell along the view direction only depends on that
+  // direction (and on how the depth of a cell is defined), so the order is
+  // kept as long as it is close enough.
+  int depthSortMode = this->DepthSortPolyData->GetDepthSortMode();
+  if (sameInput && block.Output && block.DepthSortMode == depthSortMode &&
+    (approximate || !block.Approximate))
+    {
+    double cosTolerance =
+      cos(vtkMath::RadiansFromDegrees(this->ViewAngleTolerance));
+    if (vtkMath::Dot(direction, block.Direction) >= cosTolerance - 1e-12)
+      {
+      output->ShallowCopy(block.Output);
+      return;
+      }
+    }
+
+  vtkCellArray* cellArrays[4] = { input->GetVerts(), input->GetLines(),
+    input->GetPolys(), input->GetStrips() };
+  vtkIdType typeEnd[4];
+  for (int t = 0; t < 4; t++)
+    {
+    typeEnd[t] = (t > 0? typeEnd[t - 1] : 0) +
+      cellArrays[t]->GetNumberOfCells();
+    }
+
+  // Depth of each cell, from its first point or from the center of its
+  // bounds (the parametric center is approximated by the latter).
+  bool firstPoint = (depthSortMode == VTK_SORT_FIRST_POINT);
+  vtkPoints* points = input->GetPoints();
+  vtkstd::vector<double> depths(numCells);
+  double minDepth = VTK_DOUBLE_MAX;
+  double maxDepth = -VTK_DOUBLE_MAX;
+  if (!sameInput)
+    {
+    block.Offsets.resize(numCells);
+    }
+  vtkIdType cellId = 0;
+  for (int t = 0; t < 4; t++)
+    {
+    vtkIdType* connectivity = cellArrays[t]->GetPointer();
+    vtkIdType offset = 0;
+    for (; cellId < typeEnd[t]; cellId++)
+      {
+      if (!sameInput)
+        {
+        block.Offsets[cellId] = offset;
+        }
+      vtkIdType* cell = connectivity + block.Offsets[cellId];
+      vtkIdType npts = cell[0];
+      offset = block.Offsets[cellId] + npts + 1;
+
+      double center[3] = { 0.0, 0.0, 0.0 };
+      if (npts > 0 && (firstPoint || npts == 1))
+        {
+        points->GetPoint(cell[1], center);
+        }
+      else if (npts > 0)
+        {
+        double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+          VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+        for (vtkIdType i = 1; i <= npts; i++)
+          {
+          double x[3];
+          points->GetPoint(cell[i], x);
+          for (int j = 0; j < 3; j++)
+            {
+            bounds[2 * j] = x[j] < bounds[2 * j]? x[j] : bounds[2 * j];
+            bounds[2 * j + 1] = x[j] > bounds[2 * j + 1]?
+              x[j] : bounds[2 * j + 1];
+            }
+          }
+        for (int j = 0; j < 3; j++)
+          {
+          center[j] = (bounds[2 * j] + bounds[2 * j + 1]) / 2.0;
+          }
+        }
+      double depth = (center[0] - origin[0]) * direction[0] +
+        (center[1] - origin[1]) * direction[1] +
+        (center[2] - origin[2]) * direction[2];
+      depths[cellId] = depth;
+      minDepth = depth < minDepth? depth : minDepth;
+      maxDepth = depth > maxDepth? depth : maxDepth;
+      }
+    }
+
+  // 32 bit keys, increasing from back to front, in the previous order when
+  // there is one.
+  vtkstd::vector<vtkIdType> order(numCells);
+  bool nearlySorted = sameInput;
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    order[i] = nearlySorted? block.Order[i] : i;
+    }
+  double scale = maxDepth > minDepth?
+    4294967295.0 / (maxDepth - minDepth) : 0.0;
+  vtkstd::vector<vtkTypeUInt32> keys(numCells);
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    keys[i] = static_cast<vtkTypeUInt32>(
+      (maxDepth - depths[order[i]]) * scale);
+    }
+  depths.clear();
+
+  int numThreads = 1;
+  if (numCells >= 65536)
+    {
+    numThreads = this->NumberOfThreads > 0? this->NumberOfThreads :
+      vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (approximate)
+    {
+    vtkDepthSortPainterRadixSort(keys, order, 20, 12, numThreads);
+    }
+  else if (!nearlySorted || !vtkDepthSortPainterInsertionSort(
+      numCells > 0? &keys[0] : NULL, numCells > 0? &order[0] : NULL,
+      numCells, numCells))
+    {
+    vtkDepthSortPainterRadixSort(keys, order, 0, 8, numThreads);
+    }
+  keys.clear();
+
+  // Rebuild the cell arrays in that order. The cells stay grouped by type,
+  // as they are rendered type by type anyway.
+  vtkSmartPointer<vtkPolyData> sorted = vtkSmartPointer<vtkPolyData>::New();
+  sorted->ShallowCopy(input);
+  vtkIdType* cursors[4];
+  vtkIdType cellMapEnd[4];
+  for (int t = 0; t < 4; t++)
+    {
+    vtkIdType count = cellArrays[t]->GetNumberOfCells();
+    cellMapEnd[t] = typeEnd[t] - count;
+    cursors[t] = NULL;
+    if (count == 0)
+      {
+      continue;
+      }
+    vtkCellArray* cells = vtkCellArray::New();
+    cursors[t] = cells->WritePointer(count,
+      cellArrays[t]->GetNumberOfConnectivityEntries());
+    switch (t)
+      {
+      case 0: sorted->SetVerts(cells); break;
+      case 1: sorted->SetLines(cells); break;
+      case 2: sorted->SetPolys(cells); break;
+      default: sorted->SetStrips(cells); break;
+      }
+    cells->Delete();
+    }
+  vtkstd::vector<vtkIdType> cellMap(numCells);
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    vtkIdType id = order[i];
+    int t = 0;
+    while (id >= typeEnd[t])
+      {
+      t++;
+      }
+    vtkIdType* cell = cellArrays[t]->GetPointer() + block.Offsets[id];
+    memcpy(cursors[t], cell, (cell[0] + 1) * sizeof(vtkIdType));
+    cursors[t] += cell[0] + 1;
+    cellMap[cellMapEnd[t]++] = id;
+    }
+
+  vtkCellData* inCD = input->GetCellData();
+  if (inCD->GetNumberOfArrays() > 0)
+    {
+    vtkCellData* outCD = sorted->GetCellData();
+    outCD->CopyAllocate(inCD, numCells);
+    for (vtkIdType i = 0; i < numCells; i++)
+      {
+      outCD->CopyData(inCD, cellMap[i], i);
+      }
+    }
+
+  block.Input = input;
+  block.InputMTime = input->GetMTime();
+  block.Order.swap(order);
+  block.Direction[0] = direction[0];
+  block.Direction[1] = direction[1];
+  block.Direction[2] = direction[2];
+  block.DepthSortMode = depthSortMode;
+  block.Approximate = approximate;
+  block.Output = sorted;
+  output->ShallowCopy(sorted);
+}
+
 int vtkDepthSortPainter::NeedSorting(vtkRenderer* renderer, vtkActor* actor)
 {
   if (!actor || !renderer)
@@ -32,6 +32,19 @@
 // painter does nothing.
 // This painter is useful with the point sprite painter
 // to sort points when depth peeling is disabled.
+//
+// Polygonal data is sorted by the painter itself rather than by the
+// vtkDepthSortPolyData filter (only its DepthSortMode is used), which
+// allows:
+// - to keep the order of the cells when the view direction changed by less
+//   than ViewAngleTolerance. Cells are sorted along the view direction so
+//   panning or zooming never require a new sort.
+// - to start from the previous order when sorting again, which is cheap when
+//   the view direction changed a little,
+// - to sort the cells with a radix sort on 32 bit depth keys, using several
+//   threads,
+// - to sort the cells only roughly, in depth slabs, during interaction
+//   (see SortQuality).
 
 #ifndef __vtkDepthSortPainter_h
 #define __vtkDepthSortPainter_h
@@ -48,6 +61,7 @@ class vtkPoints;
 class vtkDataObject;
 class vtkTexture;
 class vtkDepthSortPolyData;
+class vtkPolyData;
 class vtkUnsignedCharArray;
 
 class VTK_EXPORT vtkDepthSortPainter : public vtkPainter
@@ -77,6 +91,37 @@ public:
   void  SetDepthSortEnableModeToIfNoDepthPeeling(){this->SetDepthSortEnableMode(ENABLE_SORT_IF_NO_DEPTH_PEELING);}
   void  DepthSortEnableModeToNever(){this->SetDepthSortEnableMode(ENABLE_SORT_NEVER);}
 
+  //BTX
+  // Description:
+  // Quality of the sort of polygonal data.
+  // 0 : SORT_EXACT sorts the cells by depth.
+  // 1 : SORT_APPROXIMATE only sorts the cells into 4096 depth slabs, which is
+  //     done in a single pass. The order within a slab is arbitrary.
+  // 2 : SORT_APPROXIMATE_WHEN_INTERACTING uses SORT_APPROXIMATE for
+  //     interactive renders (i.e. when the DesiredUpdateRate of the render
+  //     window is above 1 frame per second) and SORT_EXACT otherwise.
+  enum { SORT_EXACT=0, SORT_APPROXIMATE=1, SORT_APPROXIMATE_WHEN_INTERACTING=2 };
+  //ETX
+
+  // Description:
+  // Quality of the sort of polygonal data. Default is
+  // SORT_APPROXIMATE_WHEN_INTERACTING.
+  vtkSetClampMacro(SortQuality, int, 0, 2);
+  vtkGetMacro(SortQuality, int);
+
+  // Description:
+  // The order of the cells is kept as long as the view direction is within
+  // this angle, in degrees, of the one they were sorted for. Default is 0
+  // i.e. the cells are sorted again whenever the view direction changes.
+  vtkSetClampMacro(ViewAngleTolerance, double, 0.0, 90.0);
+  vtkGetMacro(ViewAngleTolerance, double);
+
+  // Description:
+  // Maximum number of threads used to sort. 0 means as many as
+  // vtkMultiThreader allows. Default is 0.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
   // Description:
   // Get the output data object from this painter.
   // If Enabled, the output, the points will be ordered by
@@ -109,6 +154,12 @@ protected:
   // do the sorting for a given dataset
   virtual void Sort(vtkDataSet* output, vtkDataSet* input, vtkRenderer* renderer, vtkActor* actor);
 
+  // Description:
+  // Sorts polygonal data for the given actor and renderer, reusing the
+  // previous order of that input when possible.
+  virtual void SortPolyData(vtkPolyData* output, vtkPolyData* input,
+    vtkRenderer* renderer, vtkActor* actor);
+
   // Description:
   // Called just before RenderInternal(). We sort the points here if the
   // renderer's camera has been modified.
@@ -140,6 +191,9 @@ protected:
   vtkTimeStamp          CachedIsColorSemiTranslucentTime;
   int                   CachedIsColorSemiTranslucent;
   vtkDepthSortPolyData* DepthSortPolyData;
+  int                   SortQuality;
+  double                ViewAngleTolerance;
+  int                   NumberOfThreads;
 
   //BTX
   vtkWeakPointer<vtkDataObject> PrevInput;
@@ -150,6 +204,11 @@ protected:
 private:
   vtkDepthSortPainter(const vtkDepthSortPainter &);  // Not implemented.
   void operator=(const vtkDepthSortPainter &);  // Not implemented.
+
+  //BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
 };
 
 #endif //__vtkDepthSortPainter_h
@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // ParaView Server Manager includes
 #include <vtkSMProxy.h>
+#include <vtkSMSession.h>
 
 // ParaView includes
 #include "pqApplicationCore.h"
@@ -492,6 +493,21 @@ void pqObjectInspectorWidget::accept()
 
   QSet<pqProxy*> proxies_to_show;
 
+  // Batch the property pushes of all the panels accepted below, per server.
+  QSet<vtkSMSession*> sessions;
+  foreach(pqObjectPanel* panel, this->PanelStore)
+    {
+    sessions.insert(panel->referenceProxy()->getServer()->session());
+    }
+  if (this->CurrentPanel)
+    {
+    sessions.insert(this->CurrentPanel->referenceProxy()->getServer()->session());
+    }
+  foreach (vtkSMSession* session, sessions)
+    {
+    session->BeginTransaction();
+    }
+
   // accept all panels that are dirty.
   foreach(pqObjectPanel* panel, this->PanelStore)
     {
@@ -518,6 +534,11 @@ void pqObjectInspectorWidget::accept()
     this->CurrentPanel->accept();
     }
 
+  foreach (vtkSMSession* session, sessions)
+    {
+    session->CommitTransaction();
+    }
+
   foreach (pqProxy* proxy_to_show, proxies_to_show)
     {
     pqPipelineSource* source = qobject_cast<pqPipelineSource*>(proxy_to_show);
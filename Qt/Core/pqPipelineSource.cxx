@@ -42,6 +42,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "vtkPVDataInformation.h"
 #include "vtkPVXMLElement.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMProperty.h"
 #include "vtkSMPropertyHelper.h"
 #include "vtkSMPropertyIterator.h"
 #include "vtkSMPropertyLink.h"
@@ -379,10 +380,12 @@ void pqPipelineSource::setDefaultPropertyValues()
   foreach(vtkSMProxy* dproxy, this->Internal->ProxyListDomainProxies)
     {
     vtkSMPropertyIterator* diter = dproxy->NewPropertyIterator();
+    vtkSMProperty::BeginDomainUpdates();
     for (diter->Begin(); !diter->IsAtEnd(); diter->Next())
       {
       diter->GetProperty()->UpdateDependentDomains();
       }
+    vtkSMProperty::EndDomainUpdates();
     for (diter->Begin(); !diter->IsAtEnd(); diter->Next())
       {
       diter->GetProperty()->ResetToDefault();
@@ -1583,10 +1583,22 @@ class ProxyManager(object):
         return getattr(self.SMProxyManager, name)
 
     def LoadState(self, filename, loader = None):
-        self.SMProxyManager.LoadXMLState(filename, loader)
+        """Loads a state file. Files with the .pvsb extension are read as
+        binary state files, others as XML."""
+        if _isBinaryStateFile(filename):
+            if not self.SMProxyManager.LoadBinaryState(filename):
+                raise RuntimeError, "Failed to load state from %s" % filename
+        else:
+            self.SMProxyManager.LoadXMLState(filename, loader)
 
     def SaveState(self, filename):
-        self.SMProxyManager.SaveXMLState(filename)
+        """Saves a state file. Files with the .pvsb extension are written as
+        binary state files, others as XML."""
+        if _isBinaryStateFile(filename):
+            if not self.SMProxyManager.SaveBinaryState(filename):
+                raise RuntimeError, "Failed to save state to %s" % filename
+        else:
+            self.SMProxyManager.SaveXMLState(filename)
 
 class PropertyIterator(object):
     """Wrapper for a vtkSMPropertyIterator class to satisfy
@@ -1768,6 +1780,35 @@ class Connection(object):
            connection"""
         return self.Session.GetServerInformation().GetNumberOfProcesses()
 
+    def GetTrafficStatistics(self):
+        """Returns a dictionary with, for each type of message sent to the
+        server(s), a dictionary giving the number of messages, the bytes sent
+        and received, the number of round trips and the total time spent
+        waiting for their replies (in seconds). Returns an empty dictionary
+        for a built-in connection."""
+        stats = {}
+        if not self.IsRemote():
+            return stats
+        types = { 1 : "Push", 2 : "ExecuteStream", 3 : "Pull",
+                  4 : "GatherInformation", 5 : "DeleteSI", 6 : "LastResult",
+                  7 : "PushBatch", 8 : "PullAsync",
+                  9 : "GatherInformationAsync" }
+        for type, name in types.items():
+            if self.Session.GetNumberOfMessages(type) == 0:
+                continue
+            stats[name] = {
+              "Messages" : self.Session.GetNumberOfMessages(type),
+              "BytesSent" : self.Session.GetNumberOfBytesSent(type),
+              "BytesReceived" : self.Session.GetNumberOfBytesReceived(type),
+              "RoundTrips" : self.Session.GetNumberOfRoundTrips(type),
+              "RoundTripTime" : self.Session.GetRoundTripTime(type) }
+        return stats
+
+    def ResetTrafficStatistics(self):
+        """Resets the counters reported by GetTrafficStatistics()."""
+        if self.IsRemote():
+            self.Session.ResetCounters()
+
 
 def SaveState(filename):
     """Given a state filename, saves the state of objects registered
@@ -1775,15 +1816,24 @@ def SaveState(filename):
     pm = ProxyManager()
     pm.SaveState(filename)
 
-def LoadState(filename, connection=None):
+def LoadState(filename, connection=None, deferCreation=False):
     """Given a state filename and an optional connection, loads the server
-    manager state."""
+    manager state. When deferCreation is True, the proxies of an XML state
+    are only created on the server when first used (see
+    vtkSMStateLoader::DeferProxyCreation), so that pipelines that are never
+    shown or updated are never instantiated. The proxies of a binary state
+    (.pvsb) are always created on first use."""
     if not connection:
         connection = ActiveConnection
     if not connection:
         raise RuntimeError, "Cannot load state without a connection"
     pm = ProxyManager()
-    pm.LoadState(filename, None)
+    loader = None
+    if deferCreation:
+        loader = vtkSMStateLoader()
+        loader.SetSession(connection.Session)
+        loader.SetDeferProxyCreation(1)
+    pm.LoadState(filename, loader)
     views = GetRenderViews()
     for view in views:
         # Make sure that the client window size matches the
@@ -1793,6 +1843,43 @@ def LoadState(filename, connection=None):
             view.GetRenderWindow().SetSize(view.ViewSize[0], \
                                            view.ViewSize[1])
 
+def ConvertState(infilename, outfilename, connection=None):
+    """Converts a state file between the XML (.pvsm) and the binary (.pvsb)
+    formats. The state is loaded in the given (or active) connection and only
+    the proxies loaded from the input, and the proxies they refer to, are
+    saved again. The proxies registered before the conversion are left
+    untouched and the loaded ones are unregistered afterwards. Links and
+    global property managers are not kept in converted state files."""
+    pm = ProxyManager()
+    def _registrations():
+        result = []
+        iter = vtkSMProxyIterator()
+        iter.Begin()
+        while not iter.IsAtEnd():
+            result.append((iter.GetGroup(), iter.GetKey(), iter.GetProxy()))
+            iter.Next()
+        return result
+    def _loaded(existing):
+        return [reg for reg in _registrations() if reg not in existing]
+    existing = _registrations()
+    try:
+        LoadState(infilename, connection)
+        proxies = vtk.vtkCollection()
+        for group, name, aProxy in _loaded(existing):
+            proxies.AddItem(aProxy)
+        if _isBinaryStateFile(outfilename):
+            if not pm.SMProxyManager.SaveBinaryState(outfilename, proxies):
+                raise RuntimeError, "Failed to save state to %s" % outfilename
+        else:
+            pm.SMProxyManager.SaveXMLState(outfilename, proxies)
+    finally:
+        for group, name, aProxy in _loaded(existing):
+            pm.UnRegisterProxy(group, name, aProxy)
+
+def _isBinaryStateFile(filename):
+    import os.path
+    return os.path.splitext(filename)[1].lower() == ".pvsb"
+
 def InitFromGUI():
     """
     Method used to initialize the Python Shell from the ParaView GUI.